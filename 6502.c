@@ -30,10 +30,6 @@
 
 void dbg_printf( char *fmt, ... );
 
-#if defined(DEBUG_CPU_TRACE) && DEBUG_CPU_TRACE > 0
-void mon_traceinst(struct m6502 *cpu);
-#endif
-
 // These are the default read/write routines.
 // You need to overwrite these with your own ones if you want
 // the CPU to do anything other than constantly execute brk
@@ -54,24 +50,277 @@ static unsigned char nullread( struct m6502 *cpu, unsigned short addr )
 */
 void m6502_init( struct m6502 *cpu, void *userdata, SDL_bool nukebreakpoints )
 {
-  int i;
   cpu->rastercycles = 0;
   cpu->icycles = 0;
   cpu->cycles = 0;
   cpu->write = nullwrite;
   cpu->read  = nullread;
+  cpu->clock = NULL;
+  cpu->fetchpages = NULL;
+  cpu->writepages = NULL;
+  cpu->fastread = NULL;
+  cpu->fastwrite = NULL;
+  cpu->hook = NULL;
+  cpu->hookmap = NULL;
+  cpu->profile = NULL;
+  cpu->tracebuf = NULL;
+  cpu->covpages = NULL;
+
+  cpu->getbank = NULL;
+  cpu->mbpexec = SDL_FALSE;
+  cpu->untilevent = NULL;
+  cpu->quietio = NULL;
+  cpu->idlestate = IDLE_NONE;
 
   if( nukebreakpoints )
   {
-    for( i=0; i<16; i++ )
+    m6502_clearbps( cpu );
+    m6502_clearmbps( cpu );
+  }
+  cpu->userdata = userdata;
+}
+
+// Free the breakpoint lists. Only for when the CPU is going away.
+void m6502_free( struct m6502 *cpu )
+{
+  if( cpu->bps ) free( cpu->bps );
+  cpu->bps = NULL;
+  cpu->maxbps = 0;
+  m6502_clearbps( cpu );
+
+  if( cpu->mbps ) free( cpu->mbps );
+  cpu->mbps = NULL;
+  cpu->maxmbps = 0;
+  m6502_clearmbps( cpu );
+}
+
+/*
+** Give a CPU that was copied from another its own breakpoint
+** lists, so the two don't share (and free) the same ones. If there
+** is no memory for them, the copy is left with no breakpoints.
+*/
+SDL_bool m6502_unshare( struct m6502 *cpu )
+{
+  struct breakpoint *bps = cpu->bps;
+  struct membreakpoint *mbps = cpu->mbps;
+
+  cpu->bps = NULL;
+  cpu->mbps = NULL;
+  if( ( bps ) && ( cpu->maxbps ) )
+  {
+    cpu->bps = malloc( sizeof( struct breakpoint ) * cpu->maxbps );
+    if( !cpu->bps )
     {
-      cpu->breakpoints[i] = -1;
-      cpu->membreakpoints[i].flags = 0;
+      m6502_free( cpu );
+      return SDL_FALSE;
     }
-    cpu->anybp = SDL_FALSE;
-    cpu->anymbp = SDL_FALSE;
+    memcpy( cpu->bps, bps, sizeof( struct breakpoint ) * cpu->numbps );
   }
-  cpu->userdata = userdata;
+  else
+  {
+    cpu->maxbps = 0;
+    m6502_clearbps( cpu );
+  }
+
+  if( ( mbps ) && ( cpu->maxmbps ) )
+  {
+    cpu->mbps = malloc( sizeof( struct membreakpoint ) * cpu->maxmbps );
+    if( !cpu->mbps )
+    {
+      m6502_free( cpu );
+      return SDL_FALSE;
+    }
+    memcpy( cpu->mbps, mbps, sizeof( struct membreakpoint ) * cpu->nummbps );
+  }
+  else
+  {
+    cpu->maxmbps = 0;
+    m6502_clearmbps( cpu );
+  }
+  return SDL_TRUE;
+}
+
+/*
+** Add an execution breakpoint. Returns its ID, or -1 if
+** there was no memory for it. Adding one that is already
+** set just returns the existing ID.
+*/
+int m6502_addbp( struct m6502 *cpu, Uint16 addr, int bank )
+{
+  struct breakpoint *newbps;
+  int i;
+
+  for( i=0; i<cpu->numbps; i++ )
+  {
+    if( ( cpu->bps[i].addr == addr ) && ( cpu->bps[i].bank == bank ) )
+      return i;
+  }
+
+  if( cpu->numbps >= cpu->maxbps )
+  {
+    newbps = realloc( cpu->bps, sizeof( struct breakpoint ) * ( cpu->maxbps + 64 ) );
+    if( !newbps ) return -1;
+    cpu->bps = newbps;
+    cpu->maxbps += 64;
+  }
+
+  i = cpu->numbps++;
+  cpu->bps[i].addr = addr;
+  cpu->bps[i].bank = bank;
+  cpu->bpmap[addr>>3] |= 1<<(addr&7);
+  cpu->anybp = SDL_TRUE;
+  return i;
+}
+
+// Remove an execution breakpoint. IDs above it move down by one.
+void m6502_delbp( struct m6502 *cpu, int id )
+{
+  Uint16 addr;
+
+  if( ( id < 0 ) || ( id >= cpu->numbps ) ) return;
+
+  addr = cpu->bps[id].addr;
+  cpu->numbps--;
+  memmove( &cpu->bps[id], &cpu->bps[id+1], sizeof( struct breakpoint ) * ( cpu->numbps - id ) );
+
+  // Another bank might still have one here
+  if( m6502_findbp( cpu, addr ) == -1 )
+    cpu->bpmap[addr>>3] &= ~(1<<(addr&7));
+  cpu->anybp = ( cpu->numbps > 0 );
+}
+
+void m6502_clearbps( struct m6502 *cpu )
+{
+  memset( cpu->bpmap, 0, sizeof( cpu->bpmap ) );
+  cpu->numbps = 0;
+  cpu->anybp = SDL_FALSE;
+}
+
+// ID of the first breakpoint at addr in any bank, or -1
+int m6502_findbp( struct m6502 *cpu, Uint16 addr )
+{
+  int i;
+
+  if( !( cpu->bpmap[addr>>3] & (1<<(addr&7)) ) )
+    return -1;
+
+  for( i=0; i<cpu->numbps; i++ )
+  {
+    if( cpu->bps[i].addr == addr )
+      return i;
+  }
+  return -1;
+}
+
+static void m6502_mbpsetpages( struct m6502 *cpu )
+{
+  int i, j;
+
+  memset( cpu->mbppages, 0, sizeof( cpu->mbppages ) );
+  for( i=0; i<cpu->nummbps; i++ )
+  {
+    for( j=cpu->mbps[i].addr>>8; j<=(cpu->mbps[i].end>>8); j++ )
+      cpu->mbppages[j] |= cpu->mbps[i].flags;
+  }
+  cpu->anymbp = ( cpu->nummbps > 0 );
+}
+
+/*
+** Add a memory breakpoint. Returns its ID, or -1 if there
+** was no memory for it. The machine has to rebuild its memory
+** map afterwards so the affected pages get checked.
+*/
+int m6502_addmbp( struct m6502 *cpu, Uint16 addr, Uint16 end, Uint8 flags )
+{
+  struct membreakpoint *newmbps;
+  int i;
+
+  if( end < addr ) end = addr;
+
+  if( cpu->nummbps >= cpu->maxmbps )
+  {
+    newmbps = realloc( cpu->mbps, sizeof( struct membreakpoint ) * ( cpu->maxmbps + 16 ) );
+    if( !newmbps ) return -1;
+    cpu->mbps = newmbps;
+    cpu->maxmbps += 16;
+  }
+
+  i = cpu->nummbps++;
+  cpu->mbps[i].addr  = addr;
+  cpu->mbps[i].end   = end;
+  cpu->mbps[i].flags = flags;
+  m6502_mbpsetpages( cpu );
+  return i;
+}
+
+// Remove a memory breakpoint. IDs above it move down by one.
+void m6502_delmbp( struct m6502 *cpu, int id )
+{
+  if( ( id < 0 ) || ( id >= cpu->nummbps ) ) return;
+
+  cpu->nummbps--;
+  memmove( &cpu->mbps[id], &cpu->mbps[id+1], sizeof( struct membreakpoint ) * ( cpu->nummbps - id ) );
+  m6502_mbpsetpages( cpu );
+}
+
+void m6502_clearmbps( struct m6502 *cpu )
+{
+  cpu->nummbps = 0;
+  cpu->mbphit = 0;
+  m6502_mbpsetpages( cpu );
+}
+
+static void m6502_mbpcheck( struct m6502 *cpu, Uint16 addr, Uint8 flags )
+{
+  int i;
+
+  // Only the first hit of an instruction is reported
+  if( ( !cpu->mbpexec ) || ( cpu->mbphit ) )
+    return;
+
+  for( i=0; i<cpu->nummbps; i++ )
+  {
+    if( ( cpu->mbps[i].flags & flags ) &&
+        ( addr >= cpu->mbps[i].addr ) &&
+        ( addr <= cpu->mbps[i].end ) )
+    {
+      cpu->mbphit  = cpu->mbps[i].flags & flags;
+      cpu->mbpaddr = addr;
+      return;
+    }
+  }
+}
+
+// Called by the machine for reads from a page flagged in mbppages
+void m6502_mbpread( struct m6502 *cpu, Uint16 addr )
+{
+  m6502_mbpcheck( cpu, addr, MBPF_READ );
+}
+
+// Called by the machine for writes to a page flagged in mbppages
+void m6502_mbpwrite( struct m6502 *cpu, Uint16 addr, Uint8 oldval, Uint8 newval )
+{
+  m6502_mbpcheck( cpu, addr, ( oldval != newval ) ? MBPF_WRITE|MBPF_CHANGE : MBPF_WRITE );
+}
+
+// Is there a breakpoint at addr for the bank currently visible there?
+static SDL_bool m6502_bphit( struct m6502 *cpu, Uint16 addr )
+{
+  int i, bank;
+
+  if( !( cpu->bpmap[addr>>3] & (1<<(addr&7)) ) )
+    return SDL_FALSE;
+
+  bank = cpu->getbank ? cpu->getbank( cpu, addr ) : BPBANK_ANY;
+  for( i=0; i<cpu->numbps; i++ )
+  {
+    if( ( cpu->bps[i].addr == addr ) &&
+        ( ( cpu->bps[i].bank == BPBANK_ANY ) ||
+          ( bank == BPBANK_ANY ) ||
+          ( cpu->bps[i].bank == bank ) ) )
+      return SDL_TRUE;
+  }
+  return SDL_FALSE;
 }
 
 /*
@@ -178,23 +427,77 @@ void m6502_reset( struct m6502 *cpu )
                }
 
 
-#define BADDR_ZP  baddr = cpu->read( cpu, cpu->pc )
-#define BADDR_ZPX baddr = (cpu->read( cpu, cpu->pc ) + cpu->x)&0xff
-#define BADDR_ZPY baddr = (cpu->read( cpu, cpu->pc ) + cpu->y)&0xff
-#define BADDR_ABS baddr = (cpu->read( cpu, cpu->pc+1 )<<8) | cpu->read( cpu, cpu->pc )
-#define BADDR_ABX baddr = ((cpu->read( cpu, cpu->pc+1 )<<8) | cpu->read( cpu, cpu->pc ))+cpu->x
-#define BADDR_ABY baddr = ((cpu->read( cpu, cpu->pc+1 )<<8) | cpu->read( cpu, cpu->pc ))+cpu->y
-#define BADDR_ZIX baddr = (unsigned char)(cpu->read( cpu, cpu->pc )+cpu->x); baddr = (cpu->read( cpu, baddr+1 )<<8) | cpu->read( cpu, baddr )
-#define BADDR_ZIY baddr = cpu->read( cpu, cpu->pc ); baddr = ((cpu->read( cpu, baddr+1 )<<8) | cpu->read( cpu, baddr ))+cpu->y
-
-#define NBADDR_ZP  baddr = cpu->read( cpu, cpu->calcpc+1 )
-#define NBADDR_ZPX baddr = (cpu->read( cpu, cpu->calcpc+1 ) + cpu->x)&0xff
-#define NBADDR_ZPY baddr = (cpu->read( cpu, cpu->calcpc+1 ) + cpu->y)&0xff
-#define NBADDR_ABS baddr = (cpu->read( cpu, cpu->calcpc+2 )<<8) | cpu->read( cpu, cpu->calcpc+1 )
-#define NBADDR_ABX baddr = ((cpu->read( cpu, cpu->calcpc+2 )<<8) | cpu->read( cpu, cpu->calcpc+1 ))+cpu->x
-#define NBADDR_ABY baddr = ((cpu->read( cpu, cpu->calcpc+2 )<<8) | cpu->read( cpu, cpu->calcpc+1 ))+cpu->y
-#define NBADDR_ZIX baddr = (unsigned char)(cpu->read( cpu, cpu->calcpc+1 )+cpu->x); baddr = (cpu->read( cpu, baddr+1 )<<8) | cpu->read( cpu, baddr )
-#define NBADDR_ZIY baddr = cpu->read( cpu, cpu->calcpc+1 ); baddr = ((cpu->read( cpu, baddr+1 )<<8) | cpu->read( cpu, baddr ))+cpu->y
+// Fetch a byte of code. This skips the read handler when the
+// CPU has been given a direct pointer to the page. There is no
+// cache of decoded code: decoding is one switch on the opcode,
+// and reading through the page table means self-modifying code,
+// overlay and bank switches are always seen with nothing to
+// invalidate.
+static inline unsigned char m6502_fetchbyte( struct m6502 *cpu, unsigned short addr )
+{
+  Uint8 *page;
+
+  if( ( cpu->fetchpages ) && ( ( page = cpu->fetchpages[addr>>8] ) ) )
+    return page[addr&0xff];
+  return cpu->read( cpu, addr );
+}
+
+// Fetch a 16-bit operand, looking the page up once when both
+// bytes are on it
+static inline unsigned short m6502_fetchword( struct m6502 *cpu, unsigned short addr )
+{
+  Uint8 *page;
+
+  if( ( (addr&0xff) != 0xff ) && ( cpu->fetchpages ) && ( ( page = cpu->fetchpages[addr>>8] ) ) )
+    return (page[(addr&0xff)+1]<<8) | page[addr&0xff];
+  return (m6502_fetchbyte( cpu, addr+1 )<<8) | m6502_fetchbyte( cpu, addr );
+}
+
+// Data reads and writes go straight to the page when the machine
+// has said it is plain memory, and through the handlers otherwise
+static inline unsigned char m6502_readbyte( struct m6502 *cpu, unsigned short addr )
+{
+  Uint8 *page;
+
+  if( ( cpu->fastread ) && ( ( page = cpu->fastread[addr>>8] ) ) )
+    return page[addr&0xff];
+  return cpu->read( cpu, addr );
+}
+
+static inline void m6502_writebyte( struct m6502 *cpu, unsigned short addr, unsigned char data )
+{
+  Uint8 *page;
+
+  if( ( cpu->fastwrite ) && ( ( page = cpu->fastwrite[addr>>8] ) ) )
+  {
+    page[addr&0xff] = data;
+    return;
+  }
+  cpu->write( cpu, addr, data );
+}
+
+#define FETCH(n) m6502_fetchbyte( cpu, n )
+#define FETCHW(n) m6502_fetchword( cpu, n )
+#define MREAD(n) m6502_readbyte( cpu, n )
+#define MWRITE(n,v) m6502_writebyte( cpu, n, v )
+
+#define BADDR_ZP  baddr = FETCH( cpu->pc )
+#define BADDR_ZPX baddr = (FETCH( cpu->pc ) + cpu->x)&0xff
+#define BADDR_ZPY baddr = (FETCH( cpu->pc ) + cpu->y)&0xff
+#define BADDR_ABS baddr = (FETCH( cpu->pc+1 )<<8) | FETCH( cpu->pc )
+#define BADDR_ABX baddr = ((FETCH( cpu->pc+1 )<<8) | FETCH( cpu->pc ))+cpu->x
+#define BADDR_ABY baddr = ((FETCH( cpu->pc+1 )<<8) | FETCH( cpu->pc ))+cpu->y
+#define BADDR_ZIX baddr = (unsigned char)(FETCH( cpu->pc )+cpu->x); baddr = (MREAD( baddr+1 )<<8) | MREAD( baddr )
+#define BADDR_ZIY baddr = FETCH( cpu->pc ); baddr = ((MREAD( baddr+1 )<<8) | MREAD( baddr ))+cpu->y
+
+#define NBADDR_ZP  baddr = FETCH( cpu->calcpc+1 )
+#define NBADDR_ZPX baddr = (FETCH( cpu->calcpc+1 ) + cpu->x)&0xff
+#define NBADDR_ZPY baddr = (FETCH( cpu->calcpc+1 ) + cpu->y)&0xff
+#define NBADDR_ABS baddr = FETCHW( cpu->calcpc+1 )
+#define NBADDR_ABX baddr = FETCHW( cpu->calcpc+1 )+cpu->x
+#define NBADDR_ABY baddr = FETCHW( cpu->calcpc+1 )+cpu->y
+#define NBADDR_ZIX baddr = (unsigned char)(FETCH( cpu->calcpc+1 )+cpu->x); baddr = (MREAD( baddr+1 )<<8) | MREAD( baddr )
+#define NBADDR_ZIY baddr = FETCH( cpu->calcpc+1 ); baddr = ((MREAD( baddr+1 )<<8) | MREAD( baddr ))+cpu->y
 
 #define R_BADDR_ZP   NBADDR_ZP; raddr = baddr; rlen = 1
 #define W_BADDR_ZP   NBADDR_ZP; waddr = baddr; wlen = 1
@@ -222,29 +525,29 @@ void m6502_reset( struct m6502 *cpu )
 #define RW_BADDR_ZIY NBADDR_ZIY; waddr = raddr = baddr; wlen = rlen = 1
 
 // Macros for each addressing mode of the 6502
-#define READ_IMM v=cpu->read( cpu, cpu->pc++ )
-#define READ_ZP  v=cpu->read( cpu, cpu->read( cpu, cpu->pc++ ) )
-#define READ_ZPX v=cpu->read( cpu, (cpu->read( cpu, cpu->pc++ ) + cpu->x)&0xff )
-#define READ_ZPY v=cpu->read( cpu, (cpu->read( cpu, cpu->pc++ ) + cpu->y)&0xff )
-#define READ_ABS v=cpu->read( cpu, (cpu->read( cpu, cpu->pc+1 )<<8) | cpu->read( cpu, cpu->pc ) ); cpu->pc+=2
-#define READ_ABX BADDR_ABX; v = cpu->read( cpu, baddr ); cpu->pc+=2
-#define READ_ABY BADDR_ABY; v = cpu->read( cpu, baddr ); cpu->pc+=2
-#define READ_ZIX BADDR_ZIX; v = cpu->read( cpu, baddr ); cpu->pc++
-#define READ_ZIY BADDR_ZIY; v = cpu->read( cpu, baddr ); cpu->pc++
-
-#define KREAD_ZP  baddr = cpu->read( cpu, cpu->pc++ ); v = cpu->read( cpu, baddr )
-#define KREAD_ZPX baddr = (unsigned char)(cpu->read( cpu, cpu->pc++ )+cpu->x); v = cpu->read( cpu, baddr )
-#define KREAD_ABS baddr = (cpu->read( cpu, cpu->pc+1 )<<8) | cpu->read( cpu, cpu->pc ); v=cpu->read( cpu, baddr ); cpu->pc+=2
+#define READ_IMM v=FETCH( cpu->pc++ )
+#define READ_ZP  v=MREAD( FETCH( cpu->pc++ ) )
+#define READ_ZPX v=MREAD( (FETCH( cpu->pc++ ) + cpu->x)&0xff )
+#define READ_ZPY v=MREAD( (FETCH( cpu->pc++ ) + cpu->y)&0xff )
+#define READ_ABS v=MREAD( (FETCH( cpu->pc+1 )<<8) | FETCH( cpu->pc ) ); cpu->pc+=2
+#define READ_ABX BADDR_ABX; v = MREAD( baddr ); cpu->pc+=2
+#define READ_ABY BADDR_ABY; v = MREAD( baddr ); cpu->pc+=2
+#define READ_ZIX BADDR_ZIX; v = MREAD( baddr ); cpu->pc++
+#define READ_ZIY BADDR_ZIY; v = MREAD( baddr ); cpu->pc++
+
+#define KREAD_ZP  baddr = FETCH( cpu->pc++ ); v = MREAD( baddr )
+#define KREAD_ZPX baddr = (unsigned char)(FETCH( cpu->pc++ )+cpu->x); v = MREAD( baddr )
+#define KREAD_ABS baddr = (FETCH( cpu->pc+1 )<<8) | FETCH( cpu->pc ); v=MREAD( baddr ); cpu->pc+=2
 
 // .. and for writing
-#define WRITE_ZP(n)  cpu->write( cpu, cpu->read( cpu, cpu->pc++ ), n )
-#define WRITE_ZPX(n) cpu->write( cpu, (cpu->read( cpu, cpu->pc++ ) + cpu->x)&0xff, n )
-#define WRITE_ZPY(n) cpu->write( cpu, (cpu->read( cpu, cpu->pc++ ) + cpu->y)&0xff, n )
-#define WRITE_ABS(n) cpu->write( cpu, (cpu->read( cpu, cpu->pc+1 )<<8) | cpu->read( cpu, cpu->pc ), n ); cpu->pc+=2
-#define WRITE_ABX(n) baddr = ((cpu->read( cpu, cpu->pc+1 )<<8) | cpu->read( cpu, cpu->pc )); cpu->write( cpu, baddr + cpu->x, n ); cpu->pc+=2
-#define WRITE_ABY(n) baddr = ((cpu->read( cpu, cpu->pc+1 )<<8) | cpu->read( cpu, cpu->pc )); cpu->write( cpu, baddr + cpu->y, n ); cpu->pc+=2
-#define WRITE_ZIX(n) baddr = (unsigned char)(cpu->read( cpu, cpu->pc++ )+cpu->x); cpu->write( cpu, (cpu->read( cpu, baddr+1 )<<8) | cpu->read( cpu, baddr ), n )
-#define WRITE_ZIY(n) baddr = cpu->read( cpu, cpu->pc++ ); baddr = (cpu->read( cpu, baddr+1 )<<8) | cpu->read( cpu, baddr ); cpu->write( cpu, baddr + cpu->y, n )
+#define WRITE_ZP(n)  MWRITE( FETCH( cpu->pc++ ), n )
+#define WRITE_ZPX(n) MWRITE( (FETCH( cpu->pc++ ) + cpu->x)&0xff, n )
+#define WRITE_ZPY(n) MWRITE( (FETCH( cpu->pc++ ) + cpu->y)&0xff, n )
+#define WRITE_ABS(n) MWRITE( (FETCH( cpu->pc+1 )<<8) | FETCH( cpu->pc ), n ); cpu->pc+=2
+#define WRITE_ABX(n) baddr = ((FETCH( cpu->pc+1 )<<8) | FETCH( cpu->pc )); MWRITE( baddr + cpu->x, n ); cpu->pc+=2
+#define WRITE_ABY(n) baddr = ((FETCH( cpu->pc+1 )<<8) | FETCH( cpu->pc )); MWRITE( baddr + cpu->y, n ); cpu->pc+=2
+#define WRITE_ZIX(n) baddr = (unsigned char)(FETCH( cpu->pc++ )+cpu->x); MWRITE( (MREAD( baddr+1 )<<8) | MREAD( baddr ), n )
+#define WRITE_ZIY(n) baddr = FETCH( cpu->pc++ ); baddr = (MREAD( baddr+1 )<<8) | MREAD( baddr ); MWRITE( baddr + cpu->y, n )
 
 // Page check to see if an offset takes you out of the base page (baddr)
 #define PAGECHECK(n) ( ((baddr+n)&0xff00) != (baddr&0xff00) )
@@ -262,26 +565,79 @@ void m6502_reset( struct m6502 *cpu )
 #define IBRANCH(condition) cpu->icycles = 2;\
                            if( condition )\
                            {\
-                             cpu->baddr = cpu->calcpc+2+((signed char)cpu->read( cpu, cpu->calcpc+1 ));\
+                             cpu->baddr = cpu->calcpc+2+((signed char)FETCH( cpu->calcpc+1 ));\
                              cpu->icycles++;\
                              if( BPAGECHECK ) cpu->icycles++;\
                            }\
 
 // Macros to simplify pushing and popping
-#define PUSHB(n) cpu->write( cpu, (cpu->sp--)+0x100, n )
-#define POPB cpu->read( cpu, (++cpu->sp)+0x100 )
+#define PUSHB(n) MWRITE( (cpu->sp--)+0x100, n )
+#define POPB MREAD( (++cpu->sp)+0x100 )
 #define PUSHW(n) PUSHB( n>>8 ); PUSHB( n )
-#define POPW(n)  n = (cpu->read(cpu,((cpu->sp+2)&0xff)+0x100)<<8)|cpu->read(cpu,((cpu->sp+1)&0xff)+0x100); cpu->sp+=2
+#define POPW(n)  n = (MREAD(((cpu->sp+2)&0xff)+0x100)<<8)|MREAD(((cpu->sp+1)&0xff)+0x100); cpu->sp+=2
 
 
-// Get the number of cycles the NEXT cpu instruction will take
-// Returns TRUE if we've hit some kind of breakpoint
-SDL_bool m6502_set_icycles( struct m6502 *cpu, SDL_bool dobp, char *bpmsg )
+// Pricing modes for m6502_exec. PM_FIX opcodes always take the
+// same number of cycles, the rest take longer for a taken branch
+// or when the indexed address crosses a page.
+enum
 {
-  unsigned short baddr;
-  unsigned int extra = 0;
-  int i;
+  PM_FIX = 0,
+  PM_REL,
+  PM_ABX,
+  PM_ABY,
+  PM_ZIY
+};
+
+struct m6502_opcost
+{
+  Uint8 cycles;
+  Uint8 mode;
+};
 
+// Base cycles and pricing mode for every opcode. This must
+// match the switch in m6502_set_icycles.
+static const struct m6502_opcost opcosts[256] =
+{
+  { 7, PM_FIX }, { 6, PM_FIX }, { 6, PM_FIX }, { 8, PM_FIX }, { 3, PM_FIX }, { 3, PM_FIX }, { 5, PM_FIX }, { 5, PM_FIX }, // 00
+  { 3, PM_FIX }, { 2, PM_FIX }, { 2, PM_FIX }, { 2, PM_FIX }, { 4, PM_FIX }, { 4, PM_FIX }, { 6, PM_FIX }, { 6, PM_FIX }, // 08
+  { 2, PM_REL }, { 5, PM_ZIY }, { 6, PM_FIX }, { 8, PM_FIX }, { 4, PM_FIX }, { 4, PM_FIX }, { 6, PM_FIX }, { 6, PM_FIX }, // 10
+  { 2, PM_FIX }, { 4, PM_ABY }, { 2, PM_FIX }, { 7, PM_FIX }, { 4, PM_ABX }, { 4, PM_ABX }, { 7, PM_FIX }, { 7, PM_FIX }, // 18
+  { 6, PM_FIX }, { 6, PM_FIX }, { 6, PM_FIX }, { 8, PM_FIX }, { 3, PM_FIX }, { 3, PM_FIX }, { 5, PM_FIX }, { 5, PM_FIX }, // 20
+  { 4, PM_FIX }, { 2, PM_FIX }, { 2, PM_FIX }, { 2, PM_FIX }, { 4, PM_FIX }, { 4, PM_FIX }, { 6, PM_FIX }, { 6, PM_FIX }, // 28
+  { 2, PM_REL }, { 5, PM_ZIY }, { 6, PM_FIX }, { 8, PM_FIX }, { 4, PM_FIX }, { 4, PM_FIX }, { 6, PM_FIX }, { 6, PM_FIX }, // 30
+  { 2, PM_FIX }, { 4, PM_ABY }, { 2, PM_FIX }, { 7, PM_FIX }, { 4, PM_ABX }, { 4, PM_ABX }, { 7, PM_FIX }, { 7, PM_FIX }, // 38
+  { 6, PM_FIX }, { 6, PM_FIX }, { 6, PM_FIX }, { 6, PM_FIX }, { 3, PM_FIX }, { 3, PM_FIX }, { 5, PM_FIX }, { 6, PM_FIX }, // 40
+  { 3, PM_FIX }, { 2, PM_FIX }, { 2, PM_FIX }, { 2, PM_FIX }, { 3, PM_FIX }, { 4, PM_FIX }, { 6, PM_FIX }, { 6, PM_FIX }, // 48
+  { 2, PM_REL }, { 5, PM_ZIY }, { 6, PM_FIX }, { 6, PM_FIX }, { 4, PM_FIX }, { 4, PM_FIX }, { 6, PM_FIX }, { 6, PM_FIX }, // 50
+  { 2, PM_FIX }, { 4, PM_ABY }, { 2, PM_FIX }, { 6, PM_FIX }, { 4, PM_ABX }, { 4, PM_ABX }, { 7, PM_FIX }, { 6, PM_FIX }, // 58
+  { 6, PM_FIX }, { 6, PM_FIX }, { 6, PM_FIX }, { 8, PM_FIX }, { 3, PM_FIX }, { 3, PM_FIX }, { 5, PM_FIX }, { 5, PM_FIX }, // 60
+  { 4, PM_FIX }, { 2, PM_FIX }, { 2, PM_FIX }, { 2, PM_FIX }, { 5, PM_FIX }, { 4, PM_FIX }, { 6, PM_FIX }, { 6, PM_FIX }, // 68
+  { 2, PM_REL }, { 5, PM_ZIY }, { 6, PM_FIX }, { 8, PM_FIX }, { 4, PM_FIX }, { 4, PM_FIX }, { 6, PM_FIX }, { 6, PM_FIX }, // 70
+  { 2, PM_FIX }, { 4, PM_ABY }, { 2, PM_FIX }, { 7, PM_FIX }, { 4, PM_ABX }, { 4, PM_ABX }, { 7, PM_FIX }, { 7, PM_FIX }, // 78
+  { 2, PM_FIX }, { 6, PM_FIX }, { 2, PM_FIX }, { 6, PM_FIX }, { 3, PM_FIX }, { 3, PM_FIX }, { 3, PM_FIX }, { 3, PM_FIX }, // 80
+  { 2, PM_FIX }, { 2, PM_FIX }, { 2, PM_FIX }, { 2, PM_FIX }, { 4, PM_FIX }, { 4, PM_FIX }, { 4, PM_FIX }, { 4, PM_FIX }, // 88
+  { 2, PM_REL }, { 6, PM_FIX }, { 6, PM_FIX }, { 6, PM_FIX }, { 4, PM_FIX }, { 4, PM_FIX }, { 4, PM_FIX }, { 4, PM_FIX }, // 90
+  { 2, PM_FIX }, { 5, PM_FIX }, { 2, PM_FIX }, { 5, PM_FIX }, { 5, PM_FIX }, { 5, PM_FIX }, { 5, PM_FIX }, { 5, PM_FIX }, // 98
+  { 2, PM_FIX }, { 6, PM_FIX }, { 2, PM_FIX }, { 6, PM_FIX }, { 3, PM_FIX }, { 3, PM_FIX }, { 3, PM_FIX }, { 3, PM_FIX }, // A0
+  { 2, PM_FIX }, { 2, PM_FIX }, { 2, PM_FIX }, { 2, PM_FIX }, { 4, PM_FIX }, { 4, PM_FIX }, { 4, PM_FIX }, { 4, PM_FIX }, // A8
+  { 2, PM_REL }, { 5, PM_ZIY }, { 6, PM_FIX }, { 5, PM_ZIY }, { 4, PM_FIX }, { 4, PM_FIX }, { 4, PM_FIX }, { 4, PM_FIX }, // B0
+  { 2, PM_FIX }, { 4, PM_ABY }, { 2, PM_FIX }, { 4, PM_ZIY }, { 4, PM_ABX }, { 4, PM_ABX }, { 4, PM_ABY }, { 4, PM_ABY }, // B8
+  { 2, PM_FIX }, { 6, PM_FIX }, { 2, PM_FIX }, { 8, PM_FIX }, { 3, PM_FIX }, { 3, PM_FIX }, { 5, PM_FIX }, { 5, PM_FIX }, // C0
+  { 2, PM_FIX }, { 2, PM_FIX }, { 2, PM_FIX }, { 2, PM_FIX }, { 4, PM_FIX }, { 4, PM_FIX }, { 6, PM_FIX }, { 6, PM_FIX }, // C8
+  { 2, PM_REL }, { 5, PM_ZIY }, { 6, PM_FIX }, { 8, PM_FIX }, { 4, PM_FIX }, { 4, PM_FIX }, { 6, PM_FIX }, { 6, PM_FIX }, // D0
+  { 2, PM_FIX }, { 4, PM_ABY }, { 2, PM_FIX }, { 7, PM_FIX }, { 4, PM_ABX }, { 4, PM_ABX }, { 7, PM_FIX }, { 7, PM_FIX }, // D8
+  { 2, PM_FIX }, { 6, PM_FIX }, { 2, PM_FIX }, { 8, PM_FIX }, { 3, PM_FIX }, { 3, PM_FIX }, { 5, PM_FIX }, { 5, PM_FIX }, // E0
+  { 2, PM_FIX }, { 2, PM_FIX }, { 2, PM_FIX }, { 2, PM_FIX }, { 4, PM_FIX }, { 4, PM_FIX }, { 6, PM_FIX }, { 6, PM_FIX }, // E8
+  { 2, PM_REL }, { 5, PM_ZIY }, { 6, PM_FIX }, { 8, PM_FIX }, { 4, PM_FIX }, { 4, PM_FIX }, { 6, PM_FIX }, { 6, PM_FIX }, // F0
+  { 2, PM_FIX }, { 4, PM_ABY }, { 2, PM_FIX }, { 7, PM_FIX }, { 4, PM_ABX }, { 4, PM_ABX }, { 7, PM_FIX }, { 7, PM_FIX }, // F8
+};
+
+// Work out where the NEXT cpu instruction is (taking interrupts into
+// account), fetch its opcode and check for breakpoints.
+// Returns TRUE if we've hit some kind of breakpoint
+static inline SDL_bool m6502_dofetch( struct m6502 *cpu, SDL_bool dobp, char *bpmsg )
+{
   if( cpu->nmicount > 0 )
   {
     cpu->nmicount--;
@@ -291,11 +647,9 @@ SDL_bool m6502_set_icycles( struct m6502 *cpu, SDL_bool dobp, char *bpmsg )
 
   if( cpu->nmi )
   {
-    extra = 7;
     cpu->calcpc = (cpu->read( cpu, 0xfffb )<<8)|cpu->read( cpu, 0xfffa );
     cpu->calcint = 2;
   } else if( ( cpu->irq ) && ( cpu->f_i == 0 ) ) {
-    extra = 7;
     cpu->calcpc = (cpu->read( cpu, 0xffff )<<8)|cpu->read( cpu, 0xfffe );
     cpu->calcint = 1;
   }
@@ -305,357 +659,48 @@ SDL_bool m6502_set_icycles( struct m6502 *cpu, SDL_bool dobp, char *bpmsg )
     cpu->calcint = 0;
   }
 
-  cpu->calcop = cpu->read( cpu, cpu->calcpc );
-  if( dobp )
+  cpu->calcop = FETCH( cpu->calcpc );
+
+  // Did the last instruction hit a memory breakpoint?
+  if( cpu->mbphit )
   {
-    if( cpu->anybp )
-    {
-      for( i=0; i<16; i++ )
-      {
-        if( ( cpu->breakpoints[i] != -1 ) && ( cpu->calcpc == cpu->breakpoints[i] ) )
-          return SDL_TRUE;
-      }
-    }
+    Uint8 hit = cpu->mbphit;
 
-    if( cpu->anymbp )
+    cpu->mbphit = 0;
+    if( dobp )
     {
-      unsigned short waddr, raddr, wlen, rlen;
-
-      waddr = raddr = 0;
-      wlen = rlen = 0;
-    
-      // Going to read or write?
-      switch( cpu->calcop )
-      {
-        case 0x00: // { "BRK", AM_IMP },  // 00
-          waddr = (cpu->sp+0x100)-3;
-          wlen  = 3;
-          break;
-
-        case 0x40: // { "RTI", AM_IMP },  // 40
-          waddr = (cpu->sp+0x100);
-          wlen = 3;
-          break;
-
-        case 0x08: // { "PHP", AM_IMP },  // 08
-        case 0x48: // { "PHA", AM_IMP },  // 48
-          waddr = (cpu->sp+0x100)-1;
-          wlen = 1;
-          break;
-
-        case 0x28: // { "PLP", AM_IMP },  // 28
-        case 0x68: // { "PLA", AM_IMP },  // 68
-          raddr = cpu->sp+0x100;
-          rlen = 1;
-          break;
-
-        case 0x60: // { "RTS", AM_IMP },  // 60
-          raddr = cpu->sp+0x100;
-          rlen = 2;
-          break;
-
-        case 0x20: // { "JSR", AM_ABS },  // 20
-          waddr = (cpu->sp+0x100)-2;
-          wlen = 2;
-          break;
-
-        case 0x06: // { "ASL", AM_ZP  },  // 06
-        case 0x26: // { "ROL", AM_ZP  },  // 26
-        case 0x46: // { "LSR", AM_ZP  },  // 46
-        case 0x66: // { "ROR", AM_ZP  },  // 66
-        case 0xC6: // { "DEC", AM_ZP  },  // C6
-        case 0xE6: // { "INC", AM_ZP  },  // E6
-#ifdef ILLEGALS
-        case 0xC7: // { "DCP", AM_ZP  },  // C7 (illegal)
-        case 0xE7: // { "ISC", AM_ZP  },  // E7 (illegal)
-        case 0x27: // { "RLA", AM_ZP  },  // 27 (illegal)
-        case 0x67: // { "RRA", AM_ZP  },  // 67 (illegal)
-        case 0x07: // { "SLO", AM_ZP  },  // 07 (illegal)
-        case 0x47: // { "SRE", AM_ZP  },  // 47 (illegal)
-#endif
-		  RW_BADDR_ZP;
-          break;
-
-        case 0x0E: // { "ASL", AM_ABS },  // 0E
-        case 0x2E: // { "ROL", AM_ABS },  // 2E
-        case 0x4E: // { "LSR", AM_ABS },  // 4E
-        case 0x6E: // { "ROR", AM_ABS },  // 6E
-        case 0xCE: // { "DEC", AM_ABS },  // CE
-        case 0xEE: // { "INC", AM_ABS },  // EE
-#ifdef ILLEGALS
-        case 0xCF: // { "DCP", AM_ABS },  // CF (illegal)
-        case 0xEF: // { "ISC", AM_ABS },  // EF (illegal)
-        case 0x2F: // { "RLA", AM_ABS },  // 2F (illegal)
-        case 0x6F: // { "RRA", AM_ABS },  // 6F (illegal)
-        case 0x0F: // { "SLO", AM_ABS },  // 0F (illegal)
-        case 0x4F: // { "SRE", AM_ABS },  // 4F (illegal)
-#endif
-		  RW_BADDR_ABS;
-          break;
-
-        case 0x1E: // { "ASL", AM_ABX },  // 1E
-        case 0x3E: // { "ROL", AM_ABX },  // 3E
-        case 0x5E: // { "LSR", AM_ABX },  // 5E
-        case 0x7E: // { "ROR", AM_ABX },  // 7E
-        case 0xDE: // { "DEC", AM_ABX },  // DE
-        case 0xFE: // { "INC", AM_ABX },  // FE
-#ifdef ILLEGALS
-        case 0xDF: // { "DCP", AM_ABX },  // DF (illegal)
-        case 0xFF: // { "ISC", AM_ABX },  // FF (illegal)
-        case 0x3F: // { "RLA", AM_ABX },  // 3F (illegal)
-        case 0x7F: // { "RRA", AM_ABX },  // 7F (illegal)
-        case 0x1F: // { "SLO", AM_ABX },  // 1F (illegal)
-        case 0x5F: // { "SRE", AM_ABX },  // 5F (illegal)
-#endif
-		  RW_BADDR_ABX;
-          break;
-
-        case 0x16: // { "ASL", AM_ZPX },  // 16
-        case 0x36: // { "ROL", AM_ZPX },  // 36
-        case 0x56: // { "LSR", AM_ZPX },  // 56
-        case 0x76: // { "ROR", AM_ZPX },  // 76
-        case 0xD6: // { "DEC", AM_ZPX },  // D6
-        case 0xF6: // { "INC", AM_ZPX },  // F6
-#ifdef ILLEGALS
-        case 0xD7: // { "DCP", AM_ZPX },  // D7 (illegal)
-        case 0xF7: // { "ISC", AM_ZPX },  // F7 (illegal)
-        case 0x37: // { "RLA", AM_ZPX },  // 37 (illegal)
-        case 0x77: // { "RRA", AM_ZPX },  // 77 (illegal)
-        case 0x17: // { "SLO", AM_ZPX },  // 17 (illegal)
-        case 0x57: // { "SRE", AM_ZPX },  // 57 (illegal)
-#endif
-		  RW_BADDR_ZPX;
-          break;
-        
-#ifdef ILLEGALS
-        case 0xDB: // { "DCP", AM_ABY },  // DB (illegal)
-        case 0xFB: // { "ISC", AM_ABY },  // FB (illegal)
-        case 0x3B: // { "RLA", AM_ABY },  // 3B (illegal)
-        case 0x7B: // { "RRA", AM_ABY },  // 7B (illegal)
-        case 0x1B: // { "SLO", AM_ABY },  // 1B (illegal)
-        case 0x5B: // { "SRE", AM_ABY },  // 5B (illegal)
-          RW_BADDR_ABY;
-          break;
-        
-        case 0xC3: // { "DCP", AM_ZIX },  // C3 (illegal)
-        case 0xE3: // { "ISC", AM_ZIX },  // E3 (illegal)
-        case 0x23: // { "RLA", AM_ZIX },  // 23 (illegal)
-        case 0x63: // { "RRA", AM_ZIX },  // 63 (illegal)
-        case 0x03: // { "SLO", AM_ZIX },  // 03 (illegal)
-        case 0x43: // { "SRE", AM_ZIX },  // 43 (illegal)
-          RW_BADDR_ZIX;
-          break;
-        
-        case 0xD3: // { "DCP", AM_ZIY },  // D3 (illegal)
-        case 0xF3: // { "ISC", AM_ZIY },  // F3 (illegal)
-        case 0x33: // { "RLA", AM_ZIY },  // 33 (illegal)
-        case 0x73: // { "RRA", AM_ZIY },  // 73 (illegal)
-        case 0x13: // { "SLO", AM_ZIY },  // 13 (illegal)
-        case 0x53: // { "SRE", AM_ZIY },  // 53 (illegal)
-          RW_BADDR_ZIY;
-          break;
-#endif
-
-        case 0x01: // { "ORA", AM_ZIX },  // 01
-        case 0x21: // { "AND", AM_ZIX },  // 21
-        case 0x41: // { "EOR", AM_ZIX },  // 41
-        case 0x61: // { "ADC", AM_ZIX },  // 61
-        case 0xA1: // { "LDA", AM_ZIX },  // A1
-        case 0xC1: // { "CMP", AM_ZIX },  // C1
-        case 0xE1: // { "SBC", AM_ZIX },  // E1
-#ifdef ILLEGALS
-        case 0xA3: // { "LAX", AM_ZIX },  // A3 (illegal)
-#endif
-		  R_BADDR_ZIX;
-          break;
-
-        case 0x11: // { "ORA", AM_ZIY },  // 11
-        case 0x31: // { "AND", AM_ZIY },  // 31
-        case 0x51: // { "EOR", AM_ZIY },  // 51
-        case 0x71: // { "ADC", AM_ZIY },  // 71
-        case 0xB1: // { "LDA", AM_ZIY },  // B1
-        case 0xD1: // { "CMP", AM_ZIY },  // D1
-        case 0xF1: // { "SBC", AM_ZIY },  // F1
-        case 0xBB: // { "LAS", AM_ZIY },  // BB
-#ifdef ILLEGALS
-        case 0xB3: // { "LAX", AM_ZIY },  // B3 (illegal)
-#endif
-		  R_BADDR_ZIY;
-          break;
-
-        case 0x05: // { "ORA", AM_ZP  },  // 05
-        case 0x24: // { "BIT", AM_ZP  },  // 24
-        case 0x25: // { "AND", AM_ZP  },  // 25
-        case 0x45: // { "EOR", AM_ZP  },  // 45
-        case 0x65: // { "ADC", AM_ZP  },  // 65
-        case 0xA4: // { "LDY", AM_ZP  },  // A4
-        case 0xA5: // { "LDA", AM_ZP  },  // A5
-        case 0xA6: // { "LDX", AM_ZP  },  // A6
-        case 0xC4: // { "CPY", AM_ZP  },  // C4
-        case 0xC5: // { "CMP", AM_ZP  },  // C5
-        case 0xE4: // { "CPX", AM_ZP  },  // E4
-        case 0xE5: // { "SBC", AM_ZP  },  // E5
-#ifdef ILLEGALS
-        case 0xA7: // { "LAX", AM_ZP  },  // A7 (illegal)
-#endif
-		  R_BADDR_ZP;
-          break;
-
-        case 0x0D: // { "ORA", AM_ABS },  // 0D
-        case 0x2C: // { "BIT", AM_ABS },  // 2C
-        case 0x2D: // { "AND", AM_ABS },  // 2D
-        case 0x4D: // { "EOR", AM_ABS },  // 4D
-        case 0x6D: // { "ADC", AM_ABS },  // 6D
-        case 0xAC: // { "LDY", AM_ABS },  // AC
-        case 0xAD: // { "LDA", AM_ABS },  // AD
-        case 0xAE: // { "LDX", AM_ABS },  // AE
-        case 0xCC: // { "CPY", AM_ABS },  // CC
-        case 0xCD: // { "CMP", AM_ABS },  // CD
-        case 0xEC: // { "CPX", AM_ABS },  // EC
-        case 0xED: // { "SBC", AM_ABS },  // ED
-#ifdef ILLEGALS
-        case 0xAF: // { "LAX", AM_ABS },  // AF (illegal)
-#endif
-		  R_BADDR_ABS;
-          break;
-
-        case 0x15: // { "ORA", AM_ZPX },  // 15
-        case 0x35: // { "AND", AM_ZPX },  // 35
-        case 0x55: // { "EOR", AM_ZPX },  // 55
-        case 0x75: // { "ADC", AM_ZPX },  // 75
-        case 0xB4: // { "LDY", AM_ZPX },  // B4
-        case 0xB5: // { "LDA", AM_ZPX },  // B5
-        case 0xD5: // { "CMP", AM_ZPX },  // D5
-        case 0xF5: // { "SBC", AM_ZPX },  // F5
-          R_BADDR_ZPX;
-          break;
-
-        case 0x19: // { "ORA", AM_ABY },  // 19
-        case 0x39: // { "AND", AM_ABY },  // 39
-        case 0x59: // { "EOR", AM_ABY },  // 59
-        case 0x79: // { "ADC", AM_ABY },  // 79
-        case 0xB9: // { "LDA", AM_ABY },  // B9
-        case 0xBE: // { "LDX", AM_ABY },  // BE
-        case 0xD9: // { "CMP", AM_ABY },  // D9
-        case 0xF9: // { "SBC", AM_ABY },  // F9
-#ifdef ILLEGALS
-        case 0xBF: // { "LAX", AM_ABY },  // BF (illegal)
-#endif
-		  R_BADDR_ABY;
-          break;    
-
-        case 0x1D: // { "ORA", AM_ABX },  // 1D
-        case 0x3D: // { "AND", AM_ABX },  // 3D
-        case 0x5D: // { "EOR", AM_ABX },  // 5D
-        case 0x7D: // { "ADC", AM_ABX },  // 7D
-        case 0xBC: // { "LDY", AM_ABX },  // BC
-        case 0xBD: // { "LDA", AM_ABX },  // BD
-        case 0xDD: // { "CMP", AM_ABX },  // DD
-        case 0xFD: // { "SBC", AM_ABX },  // FD
-          R_BADDR_ABX;
-          break;    
-
-        case 0xB6: // { "LDX", AM_ZPY },  // B6
-#ifdef ILLEGALS
-		case 0xB7: // { "LAX", AM_ZPY },  // B7 (illegal)
-#endif
-		  R_BADDR_ZPY;
-          break;
-
-        case 0x6C: // { "JMP", AM_IND },  // 6C
-          raddr = (cpu->read( cpu, cpu->calcpc+2 )<<8)|cpu->read( cpu, cpu->calcpc+1 );
-          rlen = 2;
-          break;
-          
-        case 0x81: // { "STA", AM_ZIX },  // 81
-#ifdef ILLEGALS
-        case 0x83: // { "SAX", AM_ZIX },  // 83 (illegal)
-#endif
-		  W_BADDR_ZIX;
-          break;
-
-        case 0x84: // { "STY", AM_ZP  },  // 84
-        case 0x85: // { "STA", AM_ZP  },  // 85
-        case 0x86: // { "STX", AM_ZP  },  // 86
-#ifdef ILLEGALS
-        case 0x87: // { "SAX", AM_ZP  },  // 87 (illegal)
-#endif
-		  W_BADDR_ZP;
-          break;
-         
-        case 0x8C: // { "STY", AM_ABS },  // 8C
-        case 0x8D: // { "STA", AM_ABS },  // 8D
-        case 0x8E: // { "STX", AM_ABS },  // 8E
-#ifdef ILLEGALS
-        case 0x8F: // { "SAX", AM_ABS },  // 8F (illegal)
-#endif
-		  W_BADDR_ABS;
-          break;
-
-        case 0x91: // { "STA", AM_ZIY },  // 91
-          W_BADDR_ZIY;
-          break;
+      if( hit & MBPF_CHANGE )
+        sprintf( bpmsg, "Break after $%04X changed", cpu->mbpaddr );
+      else if( hit & MBPF_WRITE )
+        sprintf( bpmsg, "Break on WRITE to $%04X", cpu->mbpaddr );
+      else
+        sprintf( bpmsg, "Break on READ from $%04X", cpu->mbpaddr );
+      return SDL_TRUE;
+    }
+  }
 
-        case 0x94: // { "STY", AM_ZPX },  // 94
-        case 0x95: // { "STA", AM_ZPX },  // 95
-          W_BADDR_ZPX;
-          break;
+  if( ( dobp ) && ( cpu->anybp ) && ( m6502_bphit( cpu, cpu->calcpc ) ) )
+    return SDL_TRUE;
 
-        case 0x96: // { "STX", AM_ZPY },  // 96
-#ifdef ILLEGALS
-        case 0x97: // { "SAX", AM_ZPY },  // 97 (illegal)
-#endif
-		  W_BADDR_ZPY;
-          break;
+  return SDL_FALSE;
+}
 
-        case 0x99: // { "STA", AM_ABY },  // 99
-#ifdef ILLEGALS
-        case 0x9F: // { "AHX", AM_ABY },  // 9F (illegal, unstable)
-        case 0x9B: // { "TAS", AM_ABY },  // 9B (illegal, unstable)
-#endif
-		  W_BADDR_ABY;
-          break;
+SDL_bool m6502_fetch( struct m6502 *cpu, SDL_bool dobp, char *bpmsg )
+{
+  return m6502_dofetch( cpu, dobp, bpmsg );
+}
 
-        case 0x9D: // { "STA", AM_ABX },  // 9D
-          W_BADDR_ABX;
-          break;
-      }
+// Get the number of cycles the NEXT cpu instruction will take
+// Returns TRUE if we've hit some kind of breakpoint
+SDL_bool m6502_set_icycles( struct m6502 *cpu, SDL_bool dobp, char *bpmsg )
+{
+  unsigned short baddr;
+  unsigned int extra;
 
-      for( i=0; i<16; i++ )
-      {
-        if( ( wlen != 0 ) && ( cpu->membreakpoints[i].flags & MBPF_WRITE ) )
-        {
-          if( ( cpu->membreakpoints[i].addr >= waddr ) &&
-              ( cpu->membreakpoints[i].addr < (waddr+wlen) ) )
-          {
-            sprintf( bpmsg, "Break on WRITE to $%04X", cpu->membreakpoints[i].addr );
-            return SDL_TRUE;
-          }
-        }
-
-        if( ( rlen != 0 ) && ( cpu->membreakpoints[i].flags & MBPF_READ ) )
-        {
-          if( ( cpu->membreakpoints[i].addr >= raddr ) &&
-              ( cpu->membreakpoints[i].addr < (raddr+rlen) ) )
-          {
-            sprintf( bpmsg, "Break on READ from $%04X", cpu->membreakpoints[i].addr );
-            return SDL_TRUE;
-          }
-        }
-
-        if( cpu->membreakpoints[i].flags & MBPF_CHANGE )
-        {
-          if( cpu->membreakpoints[i].lastval != cpu->read( cpu, cpu->membreakpoints[i].addr ) )
-          {
-            cpu->membreakpoints[i].lastval = cpu->read( cpu, cpu->membreakpoints[i].addr );
-            sprintf( bpmsg, "Break after $%04X changed", cpu->membreakpoints[i].addr );
-            return SDL_TRUE;
-          }
-        }
-      }
-    }
-  }
+  if( m6502_fetch( cpu, dobp, bpmsg ) )
+    return SDL_TRUE;
 
+  extra = cpu->calcint ? 7 : 0;
 
   switch( cpu->calcop )
   {
@@ -889,7 +934,7 @@ SDL_bool m6502_set_icycles( struct m6502 *cpu, SDL_bool dobp, char *bpmsg )
     case 0xD1: // { "CMP", AM_ZIY },  // D1
     case 0xF1: // { "SBC", AM_ZIY },  // F1
     case 0xB3: // { "LAX", AM_ZIY },  // B3 (illegal)
-      baddr = cpu->read( cpu, cpu->calcpc+1 );
+      baddr = FETCH( cpu->calcpc+1 );
       baddr = ((cpu->read( cpu, baddr+1 )<<8) | cpu->read( cpu, baddr ));
       cpu->icycles = 5;
       cpu->baddr = baddr+cpu->y;
@@ -897,7 +942,7 @@ SDL_bool m6502_set_icycles( struct m6502 *cpu, SDL_bool dobp, char *bpmsg )
       break;
 
     case 0xBB: // { "LAS", AM_ZIY },  // BB
-      baddr = cpu->read( cpu, cpu->calcpc+1 );
+      baddr = FETCH( cpu->calcpc+1 );
       baddr = ((cpu->read( cpu, baddr+1 )<<8) | cpu->read( cpu, baddr ));
       cpu->icycles = 4;
       cpu->baddr = baddr+cpu->y;
@@ -976,14 +1021,321 @@ SDL_bool m6502_set_icycles( struct m6502 *cpu, SDL_bool dobp, char *bpmsg )
   return SDL_FALSE;
 }
 
+// Price and execute the instruction found by m6502_fetch in one go.
+// The cycle count comes from the opcost table instead of the big
+// switch in m6502_set_icycles, and is passed to cpu->clock (if set)
+// before the instruction runs, so devices are clocked exactly as
+// they would be with the set_icycles/inst pair.
+// Returns TRUE if a JAM instruction was executed
+static inline SDL_bool m6502_doexec( struct m6502 *cpu )
+{
+  const struct m6502_opcost *oc = &opcosts[cpu->calcop];
+  unsigned short baddr;
+  Uint8 f;
+
+  cpu->icycles = oc->cycles;
+  switch( oc->mode )
+  {
+    case PM_REL:
+      // Bits 7-6 select the flag, bit 5 the state that takes the branch
+      switch( cpu->calcop>>6 )
+      {
+        case 0:  f = cpu->f_n; break;
+        case 1:  f = cpu->f_v; break;
+        case 2:  f = cpu->f_c; break;
+        default: f = cpu->f_z; break;
+      }
+      if( (f!=0) == ((cpu->calcop>>5)&1) )
+      {
+        cpu->baddr = cpu->calcpc+2+((signed char)FETCH( cpu->calcpc+1 ));
+        cpu->icycles++;
+        if( BPAGECHECK ) cpu->icycles++;
+      }
+      break;
+
+    // The effective address is worked out once here and left in
+    // cpu->baddr, which m6502_inst reads through for these opcodes
+    case PM_ABX:
+      NBADDR_ABS;
+      cpu->baddr = baddr+cpu->x;
+      if( CPAGECHECK ) cpu->icycles++;
+      break;
+
+    case PM_ABY:
+      NBADDR_ABS;
+      cpu->baddr = baddr+cpu->y;
+      if( CPAGECHECK ) cpu->icycles++;
+      break;
+
+    case PM_ZIY:
+      baddr = FETCH( cpu->calcpc+1 );
+      baddr = ((MREAD( baddr+1 )<<8) | MREAD( baddr ));
+      cpu->baddr = baddr+cpu->y;
+      if( CPAGECHECK ) cpu->icycles++;
+      break;
+  }
+
+  if( cpu->calcint > 0 )
+    cpu->icycles += 7;
+
+  if( cpu->clock )
+    cpu->clock( cpu, cpu->icycles );
+
+  return m6502_inst( cpu );
+}
+
+SDL_bool m6502_exec( struct m6502 *cpu )
+{
+  return m6502_doexec( cpu );
+}
+
+/*
+** Idle loop detection.
+**
+** Every time the CPU jumps backwards, the target is a candidate
+** loop head. If it gets back there with the same registers, the
+** next time round is watched: the read and write handlers are
+** swapped for ones that note any I/O access (other than reads the
+** machine says are quiet) and any write that changes memory. If
+** that pass gets back to the head with the same registers again,
+** nothing the loop can see changes until a device does something,
+** so whole passes are skipped up to the next device event or the
+** end of the raster line. Interrupts and device events start the
+** whole thing over.
+*/
+static unsigned char m6502_idleread( struct m6502 *cpu, unsigned short addr )
+{
+  if( ( !cpu->fetchpages[addr>>8] ) &&
+      ( ( !cpu->quietio ) || ( !cpu->quietio( cpu, addr ) ) ) )
+    cpu->idlefail = SDL_TRUE;
+  return cpu->idleread( cpu, addr );
+}
+
+// Compared with what is under the write, which isn't what
+// reads see where there is RAM under ROM or an overlay
+static void m6502_idlewrite( struct m6502 *cpu, unsigned short addr, unsigned char data )
+{
+  Uint8 *page = cpu->writepages[addr>>8];
+
+  if( ( !page ) || ( page[addr&0xff] != data ) )
+    cpu->idlefail = SDL_TRUE;
+  cpu->idlewrite( cpu, addr, data );
+}
+
+static void m6502_idleunwatch( struct m6502 *cpu )
+{
+  if( cpu->idlestate != IDLE_WATCH ) return;
+  cpu->read  = cpu->idleread;
+  cpu->write = cpu->idlewrite;
+  cpu->fastwrite = cpu->idlefastwrite;
+  cpu->idlestate = IDLE_SEEN;
+}
+
+// Forget any loop being tracked. Must be called if anything
+// outside the CPU might have changed memory.
+void m6502_idlereset( struct m6502 *cpu )
+{
+  m6502_idleunwatch( cpu );
+  cpu->idlestate = IDLE_NONE;
+}
+
+// Called after an instruction that moved the pc backwards
+static void m6502_idlecheck( struct m6502 *cpu )
+{
+  Uint32 regs = cpu->a|(cpu->x<<8)|(cpu->y<<16)|(cpu->sp<<24);
+  Uint8 flags = MAKEFLAGS;
+  int budget, period;
+
+  if( ( cpu->anymbp ) || ( cpu->nmi ) || ( cpu->nmicount ) || ( !cpu->fetchpages ) || ( !cpu->writepages ) )
+  {
+    m6502_idlereset( cpu );
+    return;
+  }
+
+  if( cpu->pc != cpu->idlehead )
+  {
+    // Some other jump inside the loop?
+    if( ( cpu->idlestate != IDLE_NONE ) && ( ( cpu->cycles - cpu->idlestart ) < IDLE_MAXPERIOD ) )
+      return;
+
+    m6502_idlereset( cpu );
+  }
+
+  if( ( cpu->idlestate == IDLE_NONE ) ||
+      ( regs != cpu->idleregs ) ||
+      ( flags != cpu->idleflags ) ||
+      ( ( cpu->idlestate == IDLE_CONFIRMED ) && ( (Sint32)( cpu->cycles - cpu->idleuntil ) >= 0 ) ) )
+  {
+    // New candidate
+    m6502_idleunwatch( cpu );
+    cpu->idlestate = IDLE_SEEN;
+    cpu->idlehead  = cpu->pc;
+    cpu->idleregs  = regs;
+    cpu->idleflags = flags;
+    cpu->idlestart = cpu->cycles;
+    return;
+  }
+
+  period = cpu->cycles - cpu->idlestart;
+  cpu->idlestart = cpu->cycles;
+
+  switch( cpu->idlestate )
+  {
+    case IDLE_SEEN:
+      // Same state twice. Watch the next pass for side effects.
+      // Reads that skip cpu->read are of plain memory, so can't
+      // have any, but every write has to be seen.
+      cpu->idlefail  = SDL_FALSE;
+      cpu->idleread  = cpu->read;
+      cpu->idlewrite = cpu->write;
+      cpu->idlefastwrite = cpu->fastwrite;
+      cpu->read  = m6502_idleread;
+      cpu->write = m6502_idlewrite;
+      cpu->fastwrite = NULL;
+      cpu->idlestate = IDLE_WATCH;
+      return;
+
+    case IDLE_WATCH:
+      m6502_idleunwatch( cpu );
+      if( cpu->idlefail )
+        return;
+      cpu->idlestate = IDLE_CONFIRMED;
+      cpu->idleuntil = cpu->cycles + cpu->untilevent( cpu );
+      break;
+  }
+
+  // Skip as many whole passes as fit before anything can change
+  budget = cpu->untilevent( cpu ) - 1;
+  if( budget > cpu->rastercycles - 1 )
+    budget = cpu->rastercycles - 1;
+  if( ( period <= 0 ) || ( budget < period ) )
+    return;
+
+  budget -= budget % period;
+  if( cpu->profile )
+    cpu->profile( cpu, cpu->pc, budget, SDL_FALSE );
+  cpu->cycles       += budget;
+  cpu->rastercycles -= budget;
+  cpu->idlestart    += budget;
+  if( cpu->clock )
+    cpu->clock( cpu, budget );
+}
+
+/*
+** Run instructions back to back until rastercycles is used up.
+** The caller's hook is only called for instructions where the pc
+** or the fetched pc is flagged in the hook map, so the usual case
+** stays inside the core, with the fetch and exec steps inlined.
+** Stops early on a breakpoint or JAM.
+*/
+int m6502_run( struct m6502 *cpu, SDL_bool dobp, char *bpmsg )
+{
+  SDL_bool jammed;
+  Uint16 calcpc;
+
+  while( cpu->rastercycles > 0 )
+  {
+    if( m6502_dofetch( cpu, dobp, bpmsg ) )
+    {
+      m6502_idleunwatch( cpu );
+      return M6502_RUN_BREAK;
+    }
+
+    if( ( cpu->hook ) &&
+        ( ( !cpu->hookmap ) ||
+          ( cpu->hookmap[cpu->calcpc>>3] & (1<<(cpu->calcpc&7)) ) ||
+          ( cpu->hookmap[cpu->pc>>3] & (1<<(cpu->pc&7)) ) ) )
+    {
+      calcpc = cpu->calcpc;
+      cpu->hook( cpu );
+
+      // A patch that did something isn't idle
+      if( ( cpu->idlestate == IDLE_WATCH ) && ( cpu->calcpc != calcpc ) )
+        cpu->idlefail = SDL_TRUE;
+    }
+
+    jammed = m6502_doexec( cpu );
+    cpu->rastercycles -= cpu->icycles;
+    if( jammed )
+    {
+      m6502_idleunwatch( cpu );
+      return M6502_RUN_JAM;
+    }
+
+    if( cpu->calcint )
+      m6502_idlereset( cpu );
+    else if( ( cpu->pc <= cpu->calcpc ) && ( cpu->untilevent ) )
+      m6502_idlecheck( cpu );
+  }
+
+  // Don't leave the watch handlers in place for the caller
+  m6502_idleunwatch( cpu );
+  return M6502_RUN_DONE;
+}
+
+static SDL_bool m6502_doinst( struct m6502 *cpu );
+
 // Execute one 6502 instruction
 SDL_bool m6502_inst( struct m6502 *cpu )
+{
+  SDL_bool ret;
+
+  if( !cpu->anymbp )
+    return m6502_doinst( cpu );
+
+  // Let memory breakpoints see the accesses it makes
+  cpu->mbpexec = SDL_TRUE;
+  ret = m6502_doinst( cpu );
+  cpu->mbpexec = SDL_FALSE;
+  return ret;
+}
+
+// Operand bytes for the trace, without going through the read handler
+static inline Uint8 m6502_tracebyte( struct m6502 *cpu, Uint16 addr )
+{
+  Uint8 *page;
+
+  if( ( cpu->fetchpages ) && ( ( page = cpu->fetchpages[addr>>8] ) ) )
+    return page[addr&0xff];
+  return 0;
+}
+
+// Put the instruction about to run into the trace ring
+static inline void m6502_trace( struct m6502 *cpu )
+{
+  struct m6502_tracerec *r = &cpu->tracebuf[cpu->tracehead & cpu->tracemask];
+  Uint16 pc = cpu->calcpc;
+
+  r->cycles = cpu->cycles;
+  r->pc     = pc;
+  r->op[0]  = cpu->calcop;
+  r->op[1]  = m6502_tracebyte( cpu, pc+1 );
+  r->op[2]  = m6502_tracebyte( cpu, pc+2 );
+  r->a      = cpu->a;
+  r->x      = cpu->x;
+  r->y      = cpu->y;
+  r->sp     = cpu->sp;
+  r->p      = MAKEFLAGS;
+  r->bank   = ( ( pc >= 0xc000 ) && ( cpu->getbank ) ) ? cpu->getbank( cpu, pc ) : TRACE_NOBANK;
+  r->intr   = cpu->calcint;
+  cpu->tracehead++;
+}
+
+static SDL_bool m6502_doinst( struct m6502 *cpu )
 {
   unsigned char v;
   unsigned short r, t, baddr;
 
+  if( cpu->tracebuf )
+    m6502_trace( cpu );
+
   // Make sure you call set_icycles before this routine!
   cpu->cycles += cpu->icycles;
+  cpu->insts++;
+  if( cpu->profile )
+    cpu->profile( cpu, cpu->calcpc, cpu->icycles, SDL_TRUE );
+  if( cpu->covpages )
+    cpu->covpages[cpu->calcpc>>8][cpu->calcpc&0xff] |= COV_EXEC;
 
   if( cpu->calcint > 0 )
   {
@@ -998,10 +1350,6 @@ SDL_bool m6502_inst( struct m6502 *cpu )
     }
   }
 
-#if defined(DEBUG_CPU_TRACE) && DEBUG_CPU_TRACE > 0
-  mon_traceinst(cpu);
-#endif
-
   cpu->lastpc = cpu->pc = cpu->calcpc;
   cpu->pc++;
   switch( cpu->calcop )
@@ -1011,7 +1359,7 @@ SDL_bool m6502_inst( struct m6502 *cpu )
       PUSHB( MAKEFLAGS | (1<<4) );   // Set B on the stack
       cpu->f_i = 1;
       cpu->f_d = 0;
-      cpu->pc = (cpu->read( cpu, 0xffff )<<8) | cpu->read( cpu, 0xfffe );
+      cpu->pc = (MREAD( 0xffff )<<8) | MREAD( 0xfffe );
       break;
 
     case 0x01: // { "ORA", AM_ZIX },  // 01
@@ -1027,7 +1375,7 @@ SDL_bool m6502_inst( struct m6502 *cpu )
     case 0x06: // { "ASL", AM_ZP  },  // 06
       KREAD_ZP;
       DO_ASL(v);
-      cpu->write( cpu, baddr, v );
+      MWRITE( baddr, v );
       break;
 
     case 0x08: // { "PHP", AM_IMP },  // 08
@@ -1051,7 +1399,7 @@ SDL_bool m6502_inst( struct m6502 *cpu )
     case 0x0E: // { "ASL", AM_ABS },  // 0E
       KREAD_ABS;
       DO_ASL(v);
-      cpu->write( cpu, baddr, v );
+      MWRITE( baddr, v );
       break;
 
     case 0x10: // { "BPL", AM_REL },  // 10
@@ -1059,7 +1407,7 @@ SDL_bool m6502_inst( struct m6502 *cpu )
       break;
 
     case 0x11: // { "ORA", AM_ZIY },  // 11
-      v = cpu->read( cpu, cpu->baddr );  // baddr is already calculated for this case
+      v = MREAD( cpu->baddr );  // baddr is already calculated for this case
       cpu->pc++;
       DO_ORA;
       break;
@@ -1072,7 +1420,7 @@ SDL_bool m6502_inst( struct m6502 *cpu )
     case 0x16: // { "ASL", AM_ZPX },  // 16
       KREAD_ZPX;
       DO_ASL(v);
-      cpu->write( cpu, baddr, v );
+      MWRITE( baddr, v );
       break;
     
     case 0x18: // { "CLC", AM_IMP },  // 18
@@ -1081,7 +1429,7 @@ SDL_bool m6502_inst( struct m6502 *cpu )
 
     case 0x19: // { "ORA", AM_ABY },  // 19
     case 0x1D: // { "ORA", AM_ABX },  // 1D
-      v = cpu->read( cpu, cpu->baddr );  // baddr is already calculated for this case
+      v = MREAD( cpu->baddr );  // baddr is already calculated for this case
       cpu->pc+=2;
       DO_ORA;
       break;    
@@ -1089,11 +1437,11 @@ SDL_bool m6502_inst( struct m6502 *cpu )
     case 0x1E: // { "ASL", AM_ABX },  // 1E
       READ_ABX;
       DO_ASL(v);
-      cpu->write( cpu, baddr, v );
+      MWRITE( baddr, v );
       break;
 
     case 0x20: // { "JSR", AM_ABS },  // 20
-      baddr = (cpu->read( cpu, cpu->pc+1 )<<8) | cpu->read( cpu, cpu->pc );
+      baddr = (FETCH( cpu->pc+1 )<<8) | FETCH( cpu->pc );
       PUSHW( (cpu->pc+1) );
       cpu->pc = baddr;
       break;
@@ -1118,7 +1466,7 @@ SDL_bool m6502_inst( struct m6502 *cpu )
     case 0x26: // { "ROL", AM_ZP  },  // 26
       KREAD_ZP;
       DO_ROL(v);
-      cpu->write( cpu, baddr, v );
+      MWRITE( baddr, v );
       break;
 
     case 0x28: // { "PLP", AM_IMP },  // 28
@@ -1150,7 +1498,7 @@ SDL_bool m6502_inst( struct m6502 *cpu )
     case 0x2E: // { "ROL", AM_ABS },  // 2E
       KREAD_ABS;
       DO_ROL(v);
-      cpu->write( cpu, baddr, v );
+      MWRITE( baddr, v );
       break;
 
     case 0x30: // { "BMI", AM_REL },  // 30
@@ -1158,7 +1506,7 @@ SDL_bool m6502_inst( struct m6502 *cpu )
       break;
 
     case 0x31: // { "AND", AM_ZIY },  // 31
-      v = cpu->read( cpu, cpu->baddr );  // baddr is already calculated for this case
+      v = MREAD( cpu->baddr );  // baddr is already calculated for this case
       cpu->pc++;
       DO_AND;
       break;
@@ -1171,7 +1519,7 @@ SDL_bool m6502_inst( struct m6502 *cpu )
     case 0x36: // { "ROL", AM_ZPX },  // 36
       KREAD_ZPX;
       DO_ROL(v);
-      cpu->write( cpu, baddr, v );
+      MWRITE( baddr, v );
       break;
 
     case 0x38: // { "SEC", AM_IMP },  // 38
@@ -1180,7 +1528,7 @@ SDL_bool m6502_inst( struct m6502 *cpu )
 
     case 0x39: // { "AND", AM_ABY },  // 39
     case 0x3D: // { "AND", AM_ABX },  // 3D
-      v = cpu->read( cpu, cpu->baddr );  // baddr is already calculated for this case
+      v = MREAD( cpu->baddr );  // baddr is already calculated for this case
       cpu->pc+=2;
       DO_AND;
       break;    
@@ -1188,7 +1536,7 @@ SDL_bool m6502_inst( struct m6502 *cpu )
     case 0x3E: // { "ROL", AM_ABX },  // 3E
       READ_ABX;
       DO_ROL(v);
-      cpu->write( cpu, baddr, v );
+      MWRITE( baddr, v );
       break;
 
     case 0x40: // { "RTI", AM_IMP },  // 40
@@ -1210,7 +1558,7 @@ SDL_bool m6502_inst( struct m6502 *cpu )
     case 0x46: // { "LSR", AM_ZP  },  // 46
       KREAD_ZP;
       DO_LSR(v);
-      cpu->write( cpu, baddr, v );
+      MWRITE( baddr, v );
       break;
 
     case 0x48: // { "PHA", AM_IMP },  // 48
@@ -1227,7 +1575,7 @@ SDL_bool m6502_inst( struct m6502 *cpu )
       break;
 
     case 0x4C: // { "JMP", AM_ABS },  // 4C
-      cpu->pc = (cpu->read( cpu, cpu->pc+1 )<<8)|cpu->read( cpu, cpu->pc );
+      cpu->pc = (FETCH( cpu->pc+1 )<<8)|FETCH( cpu->pc );
       break;
 
     case 0x4D: // { "EOR", AM_ABS },  // 4D
@@ -1238,7 +1586,7 @@ SDL_bool m6502_inst( struct m6502 *cpu )
     case 0x4E: // { "LSR", AM_ABS },  // 4E
       KREAD_ABS;
       DO_LSR(v);
-      cpu->write( cpu, baddr, v );
+      MWRITE( baddr, v );
       break;
 
     case 0x50: // { "BVC", AM_REL },  // 50
@@ -1246,7 +1594,7 @@ SDL_bool m6502_inst( struct m6502 *cpu )
       break;
 
     case 0x51: // { "EOR", AM_ZIY },  // 51
-      v = cpu->read( cpu, cpu->baddr );  // baddr is already calculated for this case
+      v = MREAD( cpu->baddr );  // baddr is already calculated for this case
       cpu->pc++;
       DO_EOR;
       break;
@@ -1259,7 +1607,7 @@ SDL_bool m6502_inst( struct m6502 *cpu )
     case 0x56: // { "LSR", AM_ZPX },  // 56
       KREAD_ZPX;
       DO_LSR(v);
-      cpu->write( cpu, baddr, v );
+      MWRITE( baddr, v );
       break;
 
     case 0x58: // { "CLI", AM_IMP },  // 58
@@ -1268,7 +1616,7 @@ SDL_bool m6502_inst( struct m6502 *cpu )
 
     case 0x59: // { "EOR", AM_ABY },  // 59
     case 0x5D: // { "EOR", AM_ABX },  // 5D
-      v = cpu->read( cpu, cpu->baddr );  // baddr is already calculated for this case
+      v = MREAD( cpu->baddr );  // baddr is already calculated for this case
       cpu->pc+=2;
       DO_EOR;
       break;    
@@ -1276,7 +1624,7 @@ SDL_bool m6502_inst( struct m6502 *cpu )
     case 0x5E: // { "LSR", AM_ABX },  // 5E
       READ_ABX;
       DO_LSR(v);
-      cpu->write( cpu, baddr, v );
+      MWRITE( baddr, v );
       break;
 
     case 0x60: // { "RTS", AM_IMP },  // 60
@@ -1297,7 +1645,7 @@ SDL_bool m6502_inst( struct m6502 *cpu )
     case 0x66: // { "ROR", AM_ZP  },  // 66
       KREAD_ZP;
       DO_ROR(v);
-      cpu->write( cpu, baddr, v );
+      MWRITE( baddr, v );
       break;
 
     case 0x68: // { "PLA", AM_IMP },  // 68
@@ -1315,8 +1663,8 @@ SDL_bool m6502_inst( struct m6502 *cpu )
       break;
 
     case 0x6C: // { "JMP", AM_IND },  // 6C
-      baddr = (cpu->read( cpu, cpu->pc+1 )<<8)|cpu->read( cpu, cpu->pc );
-      cpu->pc = (cpu->read( cpu, baddr+1 )<<8)|cpu->read( cpu, baddr );
+      baddr = (FETCH( cpu->pc+1 )<<8)|FETCH( cpu->pc );
+      cpu->pc = (MREAD( baddr+1 )<<8)|MREAD( baddr );
       break;
       
     case 0x6D: // { "ADC", AM_ABS },  // 6D
@@ -1327,7 +1675,7 @@ SDL_bool m6502_inst( struct m6502 *cpu )
     case 0x6E: // { "ROR", AM_ABS },  // 6E
       KREAD_ABS;
       DO_ROR(v);
-      cpu->write( cpu, baddr, v );
+      MWRITE( baddr, v );
       break;
 
     case 0x70: // { "BVS", AM_REL },  // 70
@@ -1335,7 +1683,7 @@ SDL_bool m6502_inst( struct m6502 *cpu )
       break;
     
     case 0x71: // { "ADC", AM_ZIY },  // 71
-      v = cpu->read( cpu, cpu->baddr );  // baddr is already calculated for this case
+      v = MREAD( cpu->baddr );  // baddr is already calculated for this case
       cpu->pc++;
       DO_ADC;
       break;
@@ -1348,7 +1696,7 @@ SDL_bool m6502_inst( struct m6502 *cpu )
     case 0x76: // { "ROR", AM_ZPX },  // 76
       KREAD_ZPX;
       DO_ROR(v);
-      cpu->write( cpu, baddr, v );
+      MWRITE( baddr, v );
       break;
 
     case 0x78: // { "SEI", AM_IMP },  // 78
@@ -1357,7 +1705,7 @@ SDL_bool m6502_inst( struct m6502 *cpu )
 
     case 0x79: // { "ADC", AM_ABY },  // 79
     case 0x7D: // { "ADC", AM_ABX },  // 7D
-      v = cpu->read( cpu, cpu->baddr );  // baddr is already calculated for this case
+      v = MREAD( cpu->baddr );  // baddr is already calculated for this case
       cpu->pc+=2;
       DO_ADC;
       break;    
@@ -1365,7 +1713,7 @@ SDL_bool m6502_inst( struct m6502 *cpu )
     case 0x7E: // { "ROR", AM_ABX },  // 7E
       READ_ABX;
       DO_ROR(v);
-      cpu->write( cpu, baddr, v );
+      MWRITE( baddr, v );
       break;
 
     case 0x81: // { "STA", AM_ZIX },  // 81
@@ -1518,7 +1866,7 @@ SDL_bool m6502_inst( struct m6502 *cpu )
       break;
 
     case 0xB1: // { "LDA", AM_ZIY },  // B1
-      cpu->a = cpu->read( cpu, cpu->baddr );  // baddr is already calculated for this case
+      cpu->a = MREAD( cpu->baddr );  // baddr is already calculated for this case
       cpu->pc++;
       FLAG_ZN(cpu->a);
       break;
@@ -1547,7 +1895,7 @@ SDL_bool m6502_inst( struct m6502 *cpu )
 
     case 0xB9: // { "LDA", AM_ABY },  // B9
     case 0xBD: // { "LDA", AM_ABX },  // BD
-      cpu->a = cpu->read( cpu, cpu->baddr );  // baddr is already calculated for this case
+      cpu->a = MREAD( cpu->baddr );  // baddr is already calculated for this case
       cpu->pc+=2;
       FLAG_ZN(cpu->a);
       break;
@@ -1558,13 +1906,13 @@ SDL_bool m6502_inst( struct m6502 *cpu )
       break;
 
     case 0xBC: // { "LDY", AM_ABX },  // BC
-      cpu->y = cpu->read( cpu, cpu->baddr );  // baddr is already calculated for this case
+      cpu->y = MREAD( cpu->baddr );  // baddr is already calculated for this case
       cpu->pc+=2;
       FLAG_ZN(cpu->y);
       break;
 
     case 0xBE: // { "LDX", AM_ABY },  // BE
-      cpu->x = cpu->read( cpu, cpu->baddr );  // baddr is already calculated for this case
+      cpu->x = MREAD( cpu->baddr );  // baddr is already calculated for this case
       cpu->pc+=2;
       FLAG_ZN(cpu->x);
       break;
@@ -1595,7 +1943,7 @@ SDL_bool m6502_inst( struct m6502 *cpu )
 
     case 0xC6: // { "DEC", AM_ZP  },  // C6
       KREAD_ZP;
-      cpu->write( cpu, baddr, --v );
+      MWRITE( baddr, --v );
       FLAG_ZN(v);
       break;
      
@@ -1629,7 +1977,7 @@ SDL_bool m6502_inst( struct m6502 *cpu )
 
     case 0xCE: // { "DEC", AM_ABS },  // CE
       KREAD_ABS;
-      cpu->write( cpu, baddr, --v );
+      MWRITE( baddr, --v );
       FLAG_ZN(v);
       break;
       
@@ -1638,7 +1986,7 @@ SDL_bool m6502_inst( struct m6502 *cpu )
       break;
 
     case 0xD1: // { "CMP", AM_ZIY },  // D1
-      r = cpu->a-cpu->read( cpu, cpu->baddr );  // baddr is already calculated for this case
+      r = cpu->a-MREAD( cpu->baddr );  // baddr is already calculated for this case
       cpu->pc++;
       FLAG_SZCN(r);
       break;
@@ -1651,7 +1999,7 @@ SDL_bool m6502_inst( struct m6502 *cpu )
     
     case 0xD6: // { "DEC", AM_ZPX },  // D6
       KREAD_ZPX;
-      cpu->write( cpu, baddr, --v );
+      MWRITE( baddr, --v );
       FLAG_ZN(v);
       break;
 
@@ -1661,14 +2009,14 @@ SDL_bool m6502_inst( struct m6502 *cpu )
 
     case 0xD9: // { "CMP", AM_ABY },  // D9
     case 0xDD: // { "CMP", AM_ABX },  // DD
-      r = cpu->a - cpu->read( cpu, cpu->baddr );  // baddr is already calculated for this case
+      r = cpu->a - MREAD( cpu->baddr );  // baddr is already calculated for this case
       cpu->pc+=2;
       FLAG_SZCN(r);
       break;
 
     case 0xDE: // { "DEC", AM_ABX },  // DE
       READ_ABX;
-      cpu->write( cpu, baddr, --v );
+      MWRITE( baddr, --v );
       FLAG_ZN(v);
       break;
 
@@ -1696,7 +2044,7 @@ SDL_bool m6502_inst( struct m6502 *cpu )
 
     case 0xE6: // { "INC", AM_ZP  },  // E6
       KREAD_ZP;
-      cpu->write( cpu, baddr, ++v );
+      MWRITE( baddr, ++v );
       FLAG_ZN(v);
       break;
 
@@ -1729,7 +2077,7 @@ SDL_bool m6502_inst( struct m6502 *cpu )
 
     case 0xEE: // { "INC", AM_ABS },  // EE
       KREAD_ABS;
-      cpu->write( cpu, baddr, ++v );
+      MWRITE( baddr, ++v );
       FLAG_ZN(v);
       break;
 
@@ -1738,7 +2086,7 @@ SDL_bool m6502_inst( struct m6502 *cpu )
       break;
 
     case 0xF1: // { "SBC", AM_ZIY },  // F1
-      v = cpu->read( cpu, cpu->baddr );  // baddr is already calculated for this case
+      v = MREAD( cpu->baddr );  // baddr is already calculated for this case
       cpu->pc++;
       DO_SBC;
       break;
@@ -1750,7 +2098,7 @@ SDL_bool m6502_inst( struct m6502 *cpu )
 
     case 0xF6: // { "INC", AM_ZPX },  // F6
       KREAD_ZPX;
-      cpu->write( cpu, baddr, ++v );
+      MWRITE( baddr, ++v );
       FLAG_ZN(v);
       break;
 
@@ -1760,14 +2108,14 @@ SDL_bool m6502_inst( struct m6502 *cpu )
 
     case 0xF9: // { "SBC", AM_ABY },  // F9
     case 0xFD: // { "SBC", AM_ABX },  // FD
-      v = cpu->read( cpu, cpu->baddr );  // baddr is already calculated for this case
+      v = MREAD( cpu->baddr );  // baddr is already calculated for this case
       cpu->pc+=2;
       DO_SBC;
       break;    
 
     case 0xFE: // { "INC", AM_ABX },  // FE
       READ_ABX;
-      cpu->write( cpu, baddr, ++v );
+      MWRITE( baddr, ++v );
       FLAG_ZN(v);
       break;
 
@@ -1870,51 +2218,51 @@ SDL_bool m6502_inst( struct m6502 *cpu )
 
     case 0xC7: // { "DCP", AM_ZP  },  // C7 (illegal)
       BADDR_ZP;
-      v = cpu->read(cpu, baddr);
-      cpu->write(cpu, baddr, --v);
+      v = MREAD(baddr);
+      MWRITE(baddr, --v);
       WRITE_ZP(--v);
       FLAG_ZN(v);
       break;
 
     case 0xD7: // { "DCP", AM_ZPX },  // D7 (illegal)
       BADDR_ZPX;
-      v = cpu->read(cpu, baddr);
-      cpu->write(cpu, baddr, --v);
+      v = MREAD(baddr);
+      MWRITE(baddr, --v);
       FLAG_ZN(v);
       break;
 
     case 0xCF: // { "DCP", AM_ABS },  // CF (illegal)
       BADDR_ABS;
-      v = cpu->read(cpu, baddr);
-      cpu->write(cpu, baddr, --v);
+      v = MREAD(baddr);
+      MWRITE(baddr, --v);
       FLAG_ZN(v);
       break;
 
     case 0xDF: // { "DCP", AM_ABX },  // DF (illegal)
       BADDR_ABX;
-      v = cpu->read(cpu, baddr);
-      cpu->write(cpu, baddr, --v);
+      v = MREAD(baddr);
+      MWRITE(baddr, --v);
       FLAG_ZN(v);
       break;
 
     case 0xDB: // { "DCP", AM_ABY },  // DB (illegal)
       BADDR_ABY;
-      v = cpu->read(cpu, baddr);
-      cpu->write(cpu, baddr, --v);
+      v = MREAD(baddr);
+      MWRITE(baddr, --v);
       FLAG_ZN(v);
       break;
 
     case 0xC3: // { "DCP", AM_ZIX },  // C3 (illegal)
       BADDR_ZIX;
-      v = cpu->read(cpu, baddr);
-      cpu->write(cpu, baddr, --v);
+      v = MREAD(baddr);
+      MWRITE(baddr, --v);
       FLAG_ZN(v);
       break;
 
     case 0xD3: // { "DCP", AM_ZIY },  // D3 (illegal)
       BADDR_ZIY;
-      v = cpu->read(cpu, baddr);
-      cpu->write(cpu, baddr, --v);
+      v = MREAD(baddr);
+      MWRITE(baddr, --v);
       FLAG_ZN(v);
       break;
 
@@ -1949,8 +2297,8 @@ SDL_bool m6502_inst( struct m6502 *cpu )
 
     case 0xE7: // { "ISC", AM_ZP  },  // E7 (illegal)
       BADDR_ZP;
-      v = cpu->read(cpu, baddr);
-      cpu->write(cpu, baddr, ++v);
+      v = MREAD(baddr);
+      MWRITE(baddr, ++v);
       r = (cpu->a - v) - (cpu->f_c^1);
       cpu->f_v = ((cpu->a^v)&(cpu->a^(r&0xff))&0x80) ? 1 : 0;
       FLAG_SZCN(r);
@@ -1960,8 +2308,8 @@ SDL_bool m6502_inst( struct m6502 *cpu )
 
     case 0xF7: // { "ISC", AM_ZPX },  // F7 (illegal)
       BADDR_ZPX;
-      v = cpu->read(cpu, baddr);
-      cpu->write(cpu, baddr, ++v);
+      v = MREAD(baddr);
+      MWRITE(baddr, ++v);
       r = (cpu->a - v) - (cpu->f_c^1);
       cpu->f_v = ((cpu->a^v)&(cpu->a^(r&0xff))&0x80) ? 1 : 0;
       FLAG_SZCN(r);
@@ -1971,8 +2319,8 @@ SDL_bool m6502_inst( struct m6502 *cpu )
 
     case 0xEF: // { "ISC", AM_ABS },  // EF (illegal)
       BADDR_ABS;
-      v = cpu->read(cpu, baddr);
-      cpu->write(cpu, baddr, ++v);
+      v = MREAD(baddr);
+      MWRITE(baddr, ++v);
       r = (cpu->a - v) - (cpu->f_c^1);
       cpu->f_v = ((cpu->a^v)&(cpu->a^(r&0xff))&0x80) ? 1 : 0;
       FLAG_SZCN(r);
@@ -1982,8 +2330,8 @@ SDL_bool m6502_inst( struct m6502 *cpu )
 
     case 0xFF: // { "ISC", AM_ABX },  // FF (illegal)
       BADDR_ABX;
-      v = cpu->read(cpu, baddr);
-      cpu->write(cpu, baddr, ++v);
+      v = MREAD(baddr);
+      MWRITE(baddr, ++v);
       r = (cpu->a - v) - (cpu->f_c^1);
       cpu->f_v = ((cpu->a^v)&(cpu->a^(r&0xff))&0x80) ? 1 : 0;
       FLAG_SZCN(r);
@@ -1993,8 +2341,8 @@ SDL_bool m6502_inst( struct m6502 *cpu )
 
     case 0xFB: // { "ISC", AM_ABY },  // FB (illegal)
       BADDR_ABY;
-      v = cpu->read(cpu, baddr);
-      cpu->write(cpu, baddr, ++v);
+      v = MREAD(baddr);
+      MWRITE(baddr, ++v);
       r = (cpu->a - v) - (cpu->f_c^1);
       cpu->f_v = ((cpu->a^v)&(cpu->a^(r&0xff))&0x80) ? 1 : 0;
       FLAG_SZCN(r);
@@ -2004,8 +2352,8 @@ SDL_bool m6502_inst( struct m6502 *cpu )
 
     case 0xE3: // { "ISC", AM_ZIX },  // E3 (illegal)
       BADDR_ZIX;
-      v = cpu->read(cpu, baddr);
-      cpu->write(cpu, baddr, ++v);
+      v = MREAD(baddr);
+      MWRITE(baddr, ++v);
       r = (cpu->a - v) - (cpu->f_c^1);
       cpu->f_v = ((cpu->a^v)&(cpu->a^(r&0xff))&0x80) ? 1 : 0;
       FLAG_SZCN(r);
@@ -2015,8 +2363,8 @@ SDL_bool m6502_inst( struct m6502 *cpu )
 
     case 0xF3: // { "ISC", AM_ZIY },  // F3 (illegal)
       BADDR_ZIY;
-      v = cpu->read(cpu, baddr);
-      cpu->write(cpu, baddr, ++v);
+      v = MREAD(baddr);
+      MWRITE(baddr, ++v);
       r = (cpu->a - v) - (cpu->f_c^1);
       cpu->f_v = ((cpu->a^v)&(cpu->a^(r&0xff))&0x80) ? 1 : 0;
       FLAG_SZCN(r);
@@ -2025,7 +2373,7 @@ SDL_bool m6502_inst( struct m6502 *cpu )
       break;
 
     case 0xBB: // { "LAS", AM_ZIY },  // BB (illegal)
-      cpu->sp &= cpu->read( cpu, cpu->baddr );
+      cpu->sp &= MREAD( cpu->baddr );
       cpu->pc++;
       cpu->a = cpu->sp;
       cpu->x = cpu->sp;
@@ -2054,7 +2402,7 @@ SDL_bool m6502_inst( struct m6502 *cpu )
       break;
 
     case 0xBF: // { "LAX", AM_ABY },  // BF (illegal)
-      cpu->a = cpu->read( cpu, cpu->baddr );  // baddr is already calculated for this case
+      cpu->a = MREAD( cpu->baddr );  // baddr is already calculated for this case
       cpu->pc+=2;
       cpu->x = cpu->a;
       FLAG_ZN(cpu->a);
@@ -2068,7 +2416,7 @@ SDL_bool m6502_inst( struct m6502 *cpu )
       break;
 
     case 0xB3: // { "LAX", AM_ZIY },  // B3 (illegal)
-      cpu->a = cpu->read( cpu, cpu->baddr );  // baddr is already calculated for this case
+      cpu->a = MREAD( cpu->baddr );  // baddr is already calculated for this case
       cpu->x = cpu->a;
       cpu->pc++;
       FLAG_ZN(cpu->a);
@@ -2076,9 +2424,9 @@ SDL_bool m6502_inst( struct m6502 *cpu )
 
     case 0x27: // { "RLA", AM_ZP  },  // 27 (illegal)
       BADDR_ZP;
-      r = (cpu->read(cpu, baddr)<<1)|cpu->f_c;
+      r = (MREAD(baddr)<<1)|cpu->f_c;
       cpu->f_c = (r&0x100)!=0;
-      cpu->write(cpu, baddr, r);
+      MWRITE(baddr, r);
       cpu->a &= r;
       FLAG_ZN(cpu->a);
       cpu->pc++;
@@ -2086,9 +2434,9 @@ SDL_bool m6502_inst( struct m6502 *cpu )
 
     case 0x37: // { "RLA", AM_ZPX },  // 37 (illegal)
       BADDR_ZPX;
-      r = (cpu->read(cpu, baddr)<<1)|cpu->f_c;
+      r = (MREAD(baddr)<<1)|cpu->f_c;
       cpu->f_c = (r&0x100)!=0;
-      cpu->write(cpu, baddr, r);
+      MWRITE(baddr, r);
       cpu->a &= r;
       FLAG_ZN(cpu->a);
       cpu->pc++;
@@ -2096,9 +2444,9 @@ SDL_bool m6502_inst( struct m6502 *cpu )
 
     case 0x2F: // { "RLA", AM_ABS },  // 2F (illegal)
       BADDR_ABS;
-      r = (cpu->read(cpu, baddr)<<1)|cpu->f_c;
+      r = (MREAD(baddr)<<1)|cpu->f_c;
       cpu->f_c = (r&0x100)!=0;
-      cpu->write(cpu, baddr, r);
+      MWRITE(baddr, r);
       cpu->a &= r;
       FLAG_ZN(cpu->a);
       cpu->pc+=2;
@@ -2106,9 +2454,9 @@ SDL_bool m6502_inst( struct m6502 *cpu )
 
     case 0x3F: // { "RLA", AM_ABX },  // 3F (illegal)
       BADDR_ABX;
-      r = (cpu->read(cpu, baddr)<<1)|cpu->f_c;
+      r = (MREAD(baddr)<<1)|cpu->f_c;
       cpu->f_c = (r&0x100)!=0;
-      cpu->write(cpu, baddr, r);
+      MWRITE(baddr, r);
       cpu->a &= r;
       FLAG_ZN(cpu->a);
       cpu->pc+=2;
@@ -2116,9 +2464,9 @@ SDL_bool m6502_inst( struct m6502 *cpu )
 
     case 0x3B: // { "RLA", AM_ABY },  // 3B (illegal)
       BADDR_ABY;
-      r = (cpu->read(cpu, baddr)<<1)|cpu->f_c;
+      r = (MREAD(baddr)<<1)|cpu->f_c;
       cpu->f_c = (r&0x100)!=0;
-      cpu->write(cpu, baddr, r);
+      MWRITE(baddr, r);
       cpu->a &= r;
       FLAG_ZN(cpu->a);
       cpu->pc+=2;
@@ -2126,9 +2474,9 @@ SDL_bool m6502_inst( struct m6502 *cpu )
 
     case 0x23: // { "RLA", AM_ZIX },  // 23 (illegal)
       BADDR_ZIX;
-      r = (cpu->read(cpu, baddr)<<1)|cpu->f_c;
+      r = (MREAD(baddr)<<1)|cpu->f_c;
       cpu->f_c = (r&0x100)!=0;
-      cpu->write(cpu, baddr, r);
+      MWRITE(baddr, r);
       cpu->a &= r;
       FLAG_ZN(cpu->a);
       cpu->pc++;
@@ -2136,9 +2484,9 @@ SDL_bool m6502_inst( struct m6502 *cpu )
 
     case 0x33: // { "RLA", AM_ZIY },  // 33 (illegal)
       BADDR_ZIY;
-      r = (cpu->read(cpu, baddr)<<1)|cpu->f_c;
+      r = (MREAD(baddr)<<1)|cpu->f_c;
       cpu->f_c = (r&0x100)!=0;
-      cpu->write(cpu, baddr, r);
+      MWRITE(baddr, r);
       cpu->a &= r;
       FLAG_ZN(cpu->a);
       cpu->pc++;
@@ -2146,10 +2494,10 @@ SDL_bool m6502_inst( struct m6502 *cpu )
 
     case 0x67: // { "RRA", AM_ZP  },  // 67 (illegal)
       BADDR_ZP;
-      r = cpu->read(cpu, baddr);
+      r = MREAD(baddr);
       v = (r>>1)|(cpu->f_c<<7);
       cpu->f_c = r&1;
-      cpu->write(cpu, baddr, v);
+      MWRITE(baddr, v);
       r = cpu->a + v + cpu->f_c;
       cpu->f_v = ((cpu->a^v)&(cpu->a^(r&0xff))&0x80) ? 1 : 0;
       FLAG_ZCN(r);
@@ -2159,10 +2507,10 @@ SDL_bool m6502_inst( struct m6502 *cpu )
 
     case 0x77: // { "RRA", AM_ZPX },  // 77 (illegal)
       BADDR_ZPX;
-      r = cpu->read(cpu, baddr);
+      r = MREAD(baddr);
       v = (r>>1)|(cpu->f_c<<7);
       cpu->f_c = r&1;
-      cpu->write(cpu, baddr, v);
+      MWRITE(baddr, v);
       r = cpu->a + v + cpu->f_c;
       cpu->f_v = ((cpu->a^v)&(cpu->a^(r&0xff))&0x80) ? 1 : 0;
       FLAG_ZCN(r);
@@ -2172,10 +2520,10 @@ SDL_bool m6502_inst( struct m6502 *cpu )
 
     case 0x6F: // { "RRA", AM_ABS },  // 6F (illegal)
       BADDR_ABS;
-      r = cpu->read(cpu, baddr);
+      r = MREAD(baddr);
       v = (r>>1)|(cpu->f_c<<7);
       cpu->f_c = r&1;
-      cpu->write(cpu, baddr, v);
+      MWRITE(baddr, v);
       r = cpu->a + v + cpu->f_c;
       cpu->f_v = ((cpu->a^v)&(cpu->a^(r&0xff))&0x80) ? 1 : 0;
       FLAG_ZCN(r);
@@ -2185,10 +2533,10 @@ SDL_bool m6502_inst( struct m6502 *cpu )
 
     case 0x7F: // { "RRA", AM_ABX },  // 7F (illegal)
       BADDR_ABX;
-      r = cpu->read(cpu, baddr);
+      r = MREAD(baddr);
       v = (r>>1)|(cpu->f_c<<7);
       cpu->f_c = r&1;
-      cpu->write(cpu, baddr, v);
+      MWRITE(baddr, v);
       r = cpu->a + v + cpu->f_c;
       cpu->f_v = ((cpu->a^v)&(cpu->a^(r&0xff))&0x80) ? 1 : 0;
       FLAG_ZCN(r);
@@ -2198,10 +2546,10 @@ SDL_bool m6502_inst( struct m6502 *cpu )
 
     case 0x7B: // { "RRA", AM_ABY },  // 7B (illegal)
       BADDR_ABY;
-      r = cpu->read(cpu, baddr);
+      r = MREAD(baddr);
       v = (r>>1)|(cpu->f_c<<7);
       cpu->f_c = r&1;
-      cpu->write(cpu, baddr, v);
+      MWRITE(baddr, v);
       r = cpu->a + v + cpu->f_c;
       cpu->f_v = ((cpu->a^v)&(cpu->a^(r&0xff))&0x80) ? 1 : 0;
       FLAG_ZCN(r);
@@ -2211,10 +2559,10 @@ SDL_bool m6502_inst( struct m6502 *cpu )
 
     case 0x63: // { "RRA", AM_ZIX },  // 63 (illegal)
       BADDR_ZIX;
-      r = cpu->read(cpu, baddr);
+      r = MREAD(baddr);
       v = (r>>1)|(cpu->f_c<<7);
       cpu->f_c = r&1;
-      cpu->write(cpu, baddr, v);
+      MWRITE(baddr, v);
       r = cpu->a + v + cpu->f_c;
       cpu->f_v = ((cpu->a^v)&(cpu->a^(r&0xff))&0x80) ? 1 : 0;
       FLAG_ZCN(r);
@@ -2224,10 +2572,10 @@ SDL_bool m6502_inst( struct m6502 *cpu )
 
     case 0x73: // { "RRA", AM_ZIY },  // 73 (illegal)
       BADDR_ZIY;
-      r = cpu->read(cpu, baddr);
+      r = MREAD(baddr);
       v = (r>>1)|(cpu->f_c<<7);
       cpu->f_c = r&1;
-      cpu->write(cpu, baddr, v);
+      MWRITE(baddr, v);
       r = cpu->a + v + cpu->f_c;
       cpu->f_v = ((cpu->a^v)&(cpu->a^(r&0xff))&0x80) ? 1 : 0;
       FLAG_ZCN(r);
@@ -2237,9 +2585,9 @@ SDL_bool m6502_inst( struct m6502 *cpu )
 
     case 0x07: // { "SLO", AM_ZP  },  // 07 (illegal)
       BADDR_ZP;
-      r = cpu->read(cpu, baddr)<<1;
+      r = MREAD(baddr)<<1;
       cpu->f_c = (r&0x100)!=0;
-      cpu->write(cpu, baddr, r);
+      MWRITE(baddr, r);
       cpu->a |= r;
       FLAG_ZN(cpu->a);
       cpu->pc++;
@@ -2247,9 +2595,9 @@ SDL_bool m6502_inst( struct m6502 *cpu )
 
     case 0x17: // { "SLO", AM_ZPX },  // 17 (illegal)
       BADDR_ZPX;
-      r = cpu->read(cpu, baddr)<<1;
+      r = MREAD(baddr)<<1;
       cpu->f_c = (r&0x100)!=0;
-      cpu->write(cpu, baddr, r);
+      MWRITE(baddr, r);
       cpu->a |= r;
       FLAG_ZN(cpu->a);
       cpu->pc++;
@@ -2257,9 +2605,9 @@ SDL_bool m6502_inst( struct m6502 *cpu )
 
     case 0x0F: // { "SLO", AM_ABS },  // 0F (illegal)
       BADDR_ABS;
-      r = cpu->read(cpu, baddr)<<1;
+      r = MREAD(baddr)<<1;
       cpu->f_c = (r&0x100)!=0;
-      cpu->write(cpu, baddr, r);
+      MWRITE(baddr, r);
       cpu->a |= r;
       FLAG_ZN(cpu->a);
       cpu->pc+=2;
@@ -2267,9 +2615,9 @@ SDL_bool m6502_inst( struct m6502 *cpu )
 
     case 0x1F: // { "SLO", AM_ABX },  // 1F (illegal)
       BADDR_ABX;
-      r = cpu->read(cpu, baddr)<<1;
+      r = MREAD(baddr)<<1;
       cpu->f_c = (r&0x100)!=0;
-      cpu->write(cpu, baddr, r);
+      MWRITE(baddr, r);
       cpu->a |= r;
       FLAG_ZN(cpu->a);
       cpu->pc+=2;
@@ -2277,9 +2625,9 @@ SDL_bool m6502_inst( struct m6502 *cpu )
 
     case 0x1B: // { "SLO", AM_ABY },  // 1B (illegal)
       BADDR_ABY;
-      r = cpu->read(cpu, baddr)<<1;
+      r = MREAD(baddr)<<1;
       cpu->f_c = (r&0x100)!=0;
-      cpu->write(cpu, baddr, r);
+      MWRITE(baddr, r);
       cpu->a |= r;
       FLAG_ZN(cpu->a);
       cpu->pc+=2;
@@ -2287,9 +2635,9 @@ SDL_bool m6502_inst( struct m6502 *cpu )
 
     case 0x03: // { "SLO", AM_ZIX },  // 03 (illegal)
       BADDR_ZIX;
-      r = cpu->read(cpu, baddr)<<1;
+      r = MREAD(baddr)<<1;
       cpu->f_c = (r&0x100)!=0;
-      cpu->write(cpu, baddr, r);
+      MWRITE(baddr, r);
       cpu->a |= r;
       FLAG_ZN(cpu->a);
       cpu->pc++;
@@ -2297,9 +2645,9 @@ SDL_bool m6502_inst( struct m6502 *cpu )
 
     case 0x13: // { "SLO", AM_ZIY },  // 13 (illegal)
       BADDR_ZIY;
-      r = cpu->read(cpu, baddr)<<1;
+      r = MREAD(baddr)<<1;
       cpu->f_c = (r&0x100)!=0;
-      cpu->write(cpu, baddr, r);
+      MWRITE(baddr, r);
       cpu->a |= r;
       FLAG_ZN(cpu->a);
       cpu->pc++;
@@ -2307,10 +2655,10 @@ SDL_bool m6502_inst( struct m6502 *cpu )
 
     case 0x47: // { "SRE", AM_ZP  },  // 47 (illegal)
       BADDR_ZP;
-      v = cpu->read(cpu, baddr);
+      v = MREAD(baddr);
       cpu->f_c = v&1;
       v >>= 1;
-      cpu->write(cpu, baddr, v);
+      MWRITE(baddr, v);
       cpu->a ^= v;
       FLAG_ZN(cpu->a);
       cpu->pc++;
@@ -2318,10 +2666,10 @@ SDL_bool m6502_inst( struct m6502 *cpu )
 
     case 0x57: // { "SRE", AM_ZPX },  // 57 (illegal)
       BADDR_ZPX;
-      v = cpu->read(cpu, baddr);
+      v = MREAD(baddr);
       cpu->f_c = v&1;
       v >>= 1;
-      cpu->write(cpu, baddr, v);
+      MWRITE(baddr, v);
       cpu->a ^= v;
       FLAG_ZN(cpu->a);
       cpu->pc++;
@@ -2329,10 +2677,10 @@ SDL_bool m6502_inst( struct m6502 *cpu )
 
     case 0x4F: // { "SRE", AM_ABS },  // 4F (illegal)
       BADDR_ABS;
-      v = cpu->read(cpu, baddr);
+      v = MREAD(baddr);
       cpu->f_c = v&1;
       v >>= 1;
-      cpu->write(cpu, baddr, v);
+      MWRITE(baddr, v);
       cpu->a ^= v;
       FLAG_ZN(cpu->a);
       cpu->pc+=2;
@@ -2340,10 +2688,10 @@ SDL_bool m6502_inst( struct m6502 *cpu )
 
     case 0x5F: // { "SRE", AM_ABX },  // 5F (illegal)
       BADDR_ABX;
-      v = cpu->read(cpu, baddr);
+      v = MREAD(baddr);
       cpu->f_c = v&1;
       v >>= 1;
-      cpu->write(cpu, baddr, v);
+      MWRITE(baddr, v);
       cpu->a ^= v;
       FLAG_ZN(cpu->a);
       cpu->pc+=2;
@@ -2351,10 +2699,10 @@ SDL_bool m6502_inst( struct m6502 *cpu )
 
     case 0x5B: // { "SRE", AM_ABY },  // 5B (illegal)
       BADDR_ABY;
-      v = cpu->read(cpu, baddr);
+      v = MREAD(baddr);
       cpu->f_c = v&1;
       v >>= 1;
-      cpu->write(cpu, baddr, v);
+      MWRITE(baddr, v);
       cpu->a ^= v;
       FLAG_ZN(cpu->a);
       cpu->pc+=2;
@@ -2362,10 +2710,10 @@ SDL_bool m6502_inst( struct m6502 *cpu )
 
     case 0x43: // { "SRE", AM_ZIX },  // 43 (illegal)
       BADDR_ZIX;
-      v = cpu->read(cpu, baddr);
+      v = MREAD(baddr);
       cpu->f_c = v&1;
       v >>= 1;
-      cpu->write(cpu, baddr, v);
+      MWRITE(baddr, v);
       cpu->a ^= v;
       FLAG_ZN(cpu->a);
       cpu->pc++;
@@ -2373,10 +2721,10 @@ SDL_bool m6502_inst( struct m6502 *cpu )
 
     case 0x53: // { "SRE", AM_ZIY },  // 53 (illegal)
       BADDR_ZIY;
-      v = cpu->read(cpu, baddr);
+      v = MREAD(baddr);
       cpu->f_c = v&1;
       v >>= 1;
-      cpu->write(cpu, baddr, v);
+      MWRITE(baddr, v);
       cpu->a ^= v;
       FLAG_ZN(cpu->a);
       cpu->pc++;
@@ -2390,7 +2738,7 @@ SDL_bool m6502_inst( struct m6502 *cpu )
       if ((cpu->cycles&7)>2) // pseudorandom 5 in 8 chance of &H
         v &= (baddr>>8)+1;
 
-      cpu->write(cpu, baddr, v);
+      MWRITE(baddr, v);
       cpu->pc+=2;
       break;
 
@@ -2402,7 +2750,7 @@ SDL_bool m6502_inst( struct m6502 *cpu )
       if ((cpu->cycles&7)>2) // pseudorandom 5 in 8 chance of &H
         v &= (baddr>>8)+1;
 
-      cpu->write(cpu, baddr, v);
+      MWRITE(baddr, v);
       cpu->pc+=2;
       break;
 
@@ -2424,7 +2772,7 @@ SDL_bool m6502_inst( struct m6502 *cpu )
     case 0x9B: // { "TAS", AM_ABY },  // 9B (illegal)
       BADDR_ABY;
       cpu->sp = cpu->x & cpu->a;
-      cpu->write(cpu, baddr, cpu->sp&((baddr>>8)+1));
+      MWRITE(baddr, cpu->sp&((baddr>>8)+1));
       cpu->pc+=2;
       break;
 
@@ -47,6 +47,24 @@
 #define IRQB_ACIA 3
 #define IRQF_ACIA (1<<IRQB_ACIA)
 
+// Returned by the *_nextevent device functions when
+// nothing is scheduled
+#define CLK_NOEVENT 0x7fffffff
+
+// Idle loop detection states (see m6502_idlecheck)
+#define IDLE_NONE      0
+#define IDLE_SEEN      1
+#define IDLE_WATCH     2
+#define IDLE_CONFIRMED 3
+
+// Longest loop that will be considered idle, in cycles
+#define IDLE_MAXPERIOD 512
+
+// m6502_run results
+#define M6502_RUN_DONE  0
+#define M6502_RUN_BREAK 1
+#define M6502_RUN_JAM   2
+
 // Memory access breakpoints
 #define MBPB_READ 0
 #define MBPF_READ (1<<MBPB_READ)
@@ -68,25 +86,88 @@
                     cpu->f_z=(n&0x02)>>1;\
                     cpu->f_c=n&0x01
 
+// Execution breakpoints. The bank only matters for addresses
+// where the machine can switch what is visible (see getbank).
+#define BPBANK_ANY -1
+
+struct breakpoint
+{
+  Uint16 addr;
+  Sint16 bank;
+};
+
+// Memory breakpoints cover addr to end inclusive. They are
+// checked by the machine's memory access path, which sends
+// pages flagged in mbppages through m6502_mbpread/m6502_mbpwrite.
 struct membreakpoint
 {
   Uint8  flags;
-  Uint8  lastval;
-  Uint16 addr;
+  Uint16 addr, end;
+};
+
+// One instruction in the trace ring (see trace.c). Kept at 16
+// bytes, since it is also the record format of streamed traces.
+#define TRACE_NOBANK 0xff
+
+struct m6502_tracerec
+{
+  Uint32 cycles;     // Low 32 bits of the cycle count before it ran
+  Uint16 pc;
+  Uint8  op[3];      // Opcode and operands (0 if not fetchable)
+  Uint8  a, x, y, sp, p;
+  Uint8  bank;       // Bank at pc if $C000 and up, or TRACE_NOBANK
+  Uint8  intr;       // 1 = IRQ, 2 = NMI taken before it
 };
 
+// Set in the coverage map for each instruction run (see coverage.c)
+#define COV_EXEC 0x01
+
 struct m6502
 {
   Sint32   rastercycles;
   Uint32   icycles;
   Uint32   cycles;
+  Uint32   insts;        // Instructions executed, for the stats
   Uint16   pc, lastpc, calcpc, calcint, baddr;
   SDL_bool nmi;
   void (*write)(struct m6502 *,Uint16,Uint8);
   unsigned char (*read)(struct m6502 *,Uint16);
+  void (*clock)(struct m6502 *,int);
+  Uint8  **fetchpages;   // Optional direct page pointers for code fetches
+  Uint8  **writepages;   // Where writes to each page land, for idle loop checks
+  Uint8  **fastread;     // Optional pages data reads can skip cpu->read for
+  Uint8  **fastwrite;    // Optional pages data writes can skip cpu->write for
+  void (*hook)(struct m6502 *);   // Called by m6502_run before flagged addresses
+  Uint8   *hookmap;      // One bit per address, NULL means hook everything
+  void (*profile)(struct m6502 *,Uint16,int,SDL_bool);  // Given the cycles spent at each PC (NULL = off)
+  Uint8  **covpages;     // Coverage map for each page, gets COV_EXEC (NULL = off)
+  struct m6502_tracerec *tracebuf;  // Ring of tracemask+1 records (NULL = off)
+  Uint32   tracemask, tracehead;    // tracehead counts every record written
   SDL_bool anybp, anymbp;
-  Sint32   breakpoints[16];
-  struct membreakpoint membreakpoints[16];
+  Uint8    bpmap[8192];  // One bit per address with any breakpoint on it
+  struct breakpoint *bps;
+  int      numbps, maxbps;
+  int    (*getbank)(struct m6502 *,Uint16);  // Bank visible at an address, or BPBANK_ANY
+  struct membreakpoint *mbps;
+  int      nummbps, maxmbps;
+  Uint8    mbppages[256];  // MBPF_* flags of all memory breakpoints on each page
+  SDL_bool mbpexec;        // Only accesses made by m6502_inst can hit them
+  Uint8    mbphit;         // MBPF_* of the hit, reported by the next m6502_fetch
+  Uint16   mbpaddr;
+
+  // Idle loop skipping. untilevent says how many cycles can pass
+  // before a device needs clocking, quietio whether an I/O read
+  // has no side effects. Both NULL disables it.
+  int    (*untilevent)(struct m6502 *);
+  SDL_bool (*quietio)(struct m6502 *,Uint16);
+  int      idlestate;
+  Uint16   idlehead;
+  Uint32   idleregs, idlestart, idleuntil;
+  Uint8    idleflags;
+  SDL_bool idlefail;
+  unsigned char (*idleread)(struct m6502 *,Uint16);
+  void (*idlewrite)(struct m6502 *,Uint16,Uint8);
+  Uint8  **idlefastwrite;
   void    *userdata;
 
   Uint8    a, x, y, sp;
@@ -95,7 +176,22 @@ struct m6502
 };
 
 void m6502_init( struct m6502 *cpu, void *userdata, SDL_bool nukebreakpoints );
+void m6502_free( struct m6502 *cpu );
+SDL_bool m6502_unshare( struct m6502 *cpu );
 void m6502_reset( struct m6502 *cpu );
 SDL_bool m6502_inst( struct m6502 *cpu );
 SDL_bool m6502_set_icycles( struct m6502 *cpu, SDL_bool dobp, char *bpmsg );
+SDL_bool m6502_fetch( struct m6502 *cpu, SDL_bool dobp, char *bpmsg );
+SDL_bool m6502_exec( struct m6502 *cpu );
+int m6502_run( struct m6502 *cpu, SDL_bool dobp, char *bpmsg );
+void m6502_idlereset( struct m6502 *cpu );
+int m6502_addbp( struct m6502 *cpu, Uint16 addr, int bank );
+void m6502_delbp( struct m6502 *cpu, int id );
+void m6502_clearbps( struct m6502 *cpu );
+int m6502_findbp( struct m6502 *cpu, Uint16 addr );
+int m6502_addmbp( struct m6502 *cpu, Uint16 addr, Uint16 end, Uint8 flags );
+void m6502_delmbp( struct m6502 *cpu, int id );
+void m6502_clearmbps( struct m6502 *cpu );
+void m6502_mbpread( struct m6502 *cpu, Uint16 addr );
+void m6502_mbpwrite( struct m6502 *cpu, Uint16 addr, Uint8 oldval, Uint8 newval );
 
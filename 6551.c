@@ -151,6 +151,21 @@ void acia_init( struct acia *acia, struct machine *oric )
   }
 }
 
+// Cycles until acia_clock next has something to do
+int acia_nextevent( struct acia *acia )
+{
+  if( 0 == ( acia->regs[ACIA_CONTROL] & ACONF_SRC ))
+    return CLK_NOEVENT;
+
+  if( 0 == acia->framecycle )
+    return CLK_NOEVENT;
+
+  if( acia->cycles >= acia->framecycle )
+    return 1;
+
+  return acia->framecycle - acia->cycles;
+}
+
 void acia_clock( struct acia *acia, unsigned int cycles )
 {
   // EXT clock used - not implemented
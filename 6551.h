@@ -133,6 +133,7 @@ struct acia
 
 void acia_init( struct acia *acia, struct machine *oric );
 void acia_clock( struct acia *acia, unsigned int cycles );
+int acia_nextevent( struct acia *acia );
 void acia_write( struct acia *acia, Uint16 addr, Uint8 data );
 Uint8 acia_read( struct acia *acia, Uint16 addr );
 
@@ -45,16 +45,9 @@
 SDL_AudioSpec obtained;
 Uint32 cyclespersample;
 
-static Sint16 audiocapbuf[AUDIO_BUFLEN];
-extern struct avi_handle *vidcap;
 
 extern Sint16 soundsilence;
-extern SDL_bool soundavailable, soundon, warpspeed;
-
-// Variables used by the queuekeys function
-// (only works for ROM routines)
-static char *keyqueue = NULL;
-static int keysqueued = 0, kqoffs = 0;
+extern SDL_bool soundavailable;
 
 // Volume levels
 Sint32 voltab[] = { 0, 513/4, 828/4, 1239/4, 1923/4, 3238/4, 4926/4, 9110/4, 10344/4, 17876/4, 24682/4, 30442/4, 38844/4, 47270/4, 56402/4, 65535/4};
@@ -89,7 +82,6 @@ unsigned char *eshapes[] = { eshape0, // 0000
                              eshape4 };//1111
 
 
-static SDL_COMPAT_KEY *keytab;
 
 // Oric keymap (QWERTY)
 //                                FE           FD           FB           F7           EF           DF           BF           7F
@@ -124,22 +116,22 @@ static SDL_COMPAT_KEY qzktab[] = { '7'        , 'n'        , '5'        , 'v'
 
 // Queue up some key presses. These key presses
 // are only detected by the standard ROM routines.
-void queuekeys( char *str )
+void queuekeys( struct ay8912 *ay, char *str )
 {
   if( str )
   {
     int len = (int)strlen( str );
-    if( keyqueue )
+    if( ay->keyqueue )
     {
-      keyqueue = realloc(keyqueue, strlen(keyqueue) + len + 1);
-      strcat(keyqueue, str);
-      keysqueued += len;
+      ay->keyqueue = realloc(ay->keyqueue, strlen(ay->keyqueue) + len + 1);
+      strcat(ay->keyqueue, str);
+      ay->keysqueued += len;
     }
     else
     {
-      keyqueue   = strdup( str );
-      keysqueued = len;
-      kqoffs     = 0;
+      ay->keyqueue   = strdup( str );
+      ay->keysqueued = len;
+      ay->kqoffs     = 0;
     }
   }
 }
@@ -361,7 +353,9 @@ void ay_callback( void *dummy, Sint8 *stream, int length )
   struct ay8912 *ay = (struct ay8912 *)dummy;
   Sint32 dcadjustave, dcadjustmax;
   SDL_bool tapenoise;
+  Uint64 t;
 
+  t = stats_start( &ay->oric->stats );
   logc    = 0;
   tlogc   = 0;
   dcadjustave = 0;
@@ -393,7 +387,7 @@ void ay_callback( void *dummy, Sint8 *stream, int length )
     fout = ay->output + ay->tapeout;
     out[j++] = fout;
     out[j++] = fout;
-    if( vidcap ) audiocapbuf[i] = fout;
+    if( ay->oric->vidcap ) ay->audiocapbuf[i] = fout;
 
     if( fout > dcadjustmax ) dcadjustmax = fout;
     dcadjustave += fout;
@@ -412,17 +406,17 @@ void ay_callback( void *dummy, Sint8 *stream, int length )
     {
       out[j++] -= dcadjustave;
       out[j++] -= dcadjustave;
-      if( vidcap ) audiocapbuf[i] -= dcadjustave;
+      if( ay->oric->vidcap ) ay->audiocapbuf[i] -= dcadjustave;
     }
   }
 
-  if( vidcap )
+  if( ay->oric->vidcap )
   {
 #if SDL_BYTEORDER == SDL_BIG_ENDIAN
     for( i=0; i<(length/4); i++ )
-      audiocapbuf[i] = SDL_Swap16( audiocapbuf[i] );
+      ay->audiocapbuf[i] = SDL_Swap16( ay->audiocapbuf[i] );
 #endif
-    avi_addaudio( &vidcap, audiocapbuf, length/2 );
+    avi_addaudio( &ay->oric->vidcap, ay->audiocapbuf, length/2 );
   }
 
   if (ay->logged > logc)
@@ -453,23 +447,27 @@ void ay_callback( void *dummy, Sint8 *stream, int length )
   ay->do_logcycle_reset = SDL_TRUE;
 //  ay->logged   = 0;
   ay->tlogged  = 0;
+
+  stats_stopaudio( &ay->oric->stats, t );
 }
 
 /*
-** Emulate the AY for some clock cycles
-** Output is cycle-exact.
+** Inject queued keys and do the jasmin auto reset.
+** These hook the ROM keyboard routine, so this must
+** be called after the next instruction is fetched but
+** before it is executed.
 */
-void ay_ticktock( struct ay8912 *ay, int cycles )
+void ay_patches( struct ay8912 *ay )
 {
   // Need to do queued keys?
-  if( ( keyqueue ) && ( keysqueued ) )
+  if( ( ay->keyqueue ) && ( ay->keysqueued ) )
   {
-    if( kqoffs >= keysqueued )
+    if( ay->kqoffs >= ay->keysqueued )
     {
-      free(keyqueue);
-      keyqueue = NULL;
-      keysqueued = 0;
-      kqoffs = 0;
+      free(ay->keyqueue);
+      ay->keyqueue = NULL;
+      ay->keysqueued = 0;
+      ay->kqoffs = 0;
     } else {
       switch( ay->oric->type )
       {
@@ -477,7 +475,7 @@ void ay_ticktock( struct ay8912 *ay, int cycles )
         case MACH_PRAVETZ:
           if( ( ay->oric->cpu.pc == 0xeb78 ) && ( ay->oric->romon ) )
           {
-            ay->oric->cpu.a = keyqueue[kqoffs++];
+            ay->oric->cpu.a = ay->keyqueue[ay->kqoffs++];
             ay->oric->cpu.write( &ay->oric->cpu, 0x2df, 0 );
             ay->oric->cpu.f_n = 1;
             ay->oric->cpu.calcpc = 0xeb88;
@@ -489,7 +487,7 @@ void ay_ticktock( struct ay8912 *ay, int cycles )
         case MACH_ORIC1_16K:
           if( ( ay->oric->cpu.pc == 0xe905 ) && ( ay->oric->romon ) )
           {
-            ay->oric->cpu.a = keyqueue[kqoffs++];
+            ay->oric->cpu.a = ay->keyqueue[ay->kqoffs++];
             ay->oric->cpu.write( &ay->oric->cpu, 0x2df, 0 );
             ay->oric->cpu.f_n = 1;
             ay->oric->cpu.calcpc = 0xe915;
@@ -516,6 +514,7 @@ void ay_ticktock( struct ay8912 *ay, int cycles )
             m6502_reset( &ay->oric->cpu );
             m6502_set_icycles( &ay->oric->cpu, SDL_FALSE, NULL );
             via_init( &ay->oric->via, ay->oric, VIA_MAIN );
+            machine_sync( ay->oric );
             ay->oric->auto_jasmin_reset = SDL_FALSE;
           }
           break;
@@ -529,6 +528,7 @@ void ay_ticktock( struct ay8912 *ay, int cycles )
             m6502_reset( &ay->oric->cpu );
             m6502_set_icycles( &ay->oric->cpu, SDL_FALSE, NULL );
             via_init( &ay->oric->via, ay->oric, VIA_MAIN );
+            machine_sync( ay->oric );
             ay->oric->auto_jasmin_reset = SDL_FALSE;
           }
           break;
@@ -539,7 +539,22 @@ void ay_ticktock( struct ay8912 *ay, int cycles )
       ay->oric->auto_jasmin_reset = SDL_FALSE;
     }
   }
+}
 
+/*
+** Cycles until ay_ticktock next has something to do
+*/
+int ay_nextevent( struct ay8912 *ay )
+{
+  return ( ay->keybitdelay > 0 ) ? (int)ay->keybitdelay : CLK_NOEVENT;
+}
+
+/*
+** Emulate the AY for some clock cycles
+** Output is cycle-exact.
+*/
+void ay_ticktock( struct ay8912 *ay, int cycles )
+{
   if( ay->keybitdelay > 0 )
   {
     if( cycles >= ay->keybitdelay )
@@ -550,19 +565,27 @@ void ay_ticktock( struct ay8912 *ay, int cycles )
       ay->keybitdelay -= cycles;
     }
   }
+}
 
+/*
+** Move on the time AY writes and tape edges are logged at.
+** The cycles passed in were run before any rebase the audio
+** callback has asked for, so they are counted first.
+*/
+void ay_logtime( struct ay8912 *ay, int cycles )
+{
+  ay->logcycle += cycles;
   if( ay->do_logcycle_reset )
   {
     ay->logcycle = ay->newlogcycle;
     ay->do_logcycle_reset = SDL_FALSE;
   }
-  ay->logcycle += cycles;
 }
 
 void ay_lockaudio( struct ay8912 *ay )
 {
   if( ay->audiolocked ) return;
-  if( ( ay->oric->emu_mode != EM_RUNNING ) || ( !soundon ) || ( warpspeed ) ) return;
+  if( ( ay->oric->emu_mode != EM_RUNNING ) || ( !ay->oric->soundon ) || ( ay->oric->warpspeed ) ) return;
   SDL_LockAudio();
   ay->audiolocked = SDL_TRUE;
 }
@@ -584,9 +607,9 @@ SDL_bool ay_init( struct ay8912 *ay, struct machine *oric )
 
   switch( oric->keymap )
   {
-    case KMAP_AZERTY: keytab = azktab; break;
-    case KMAP_QWERTZ: keytab = qzktab; break;
-    default:          keytab = qwktab; break;
+    case KMAP_AZERTY: ay->keytab = azktab; break;
+    case KMAP_QWERTZ: ay->keytab = qzktab; break;
+    default:          ay->keytab = qwktab; break;
   }
 
   // No oric keys pressed
@@ -618,7 +641,7 @@ SDL_bool ay_init( struct ay8912 *ay, struct machine *oric )
   ay->bmode   = 0;          // GI silly addressing mode
   ay->creg    = 0;          // Current register to 0
   ay->oric    = oric;
-  ay->soundon = soundavailable && soundon && (!warpspeed);
+  ay->soundon = soundavailable && ay->oric->soundon && (!ay->oric->warpspeed);
   ay->currnoise = 0;
   ay->rndrack = 1;
   ay->logged  = 0;
@@ -670,7 +693,7 @@ void ay_keypress( struct ay8912 *ay, SDL_COMPAT_KEY key, SDL_bool down )
 
   // Does this key exist on the Oric?
   for( i=0; i<64; i++ )
-    if( keytab[i] == key ) break;
+    if( ay->keytab[i] == key ) break;
 
   // No...
   if( i == 64 ) return;
@@ -743,7 +766,7 @@ void ay_modeset( struct ay8912 *ay )
         case AY_ENV_PER_L:
         case AY_ENV_PER_H:
         case AY_ENV_CYCLE:
-          if( ( !soundon ) || ( warpspeed ) )
+          if( ( !ay->oric->soundon ) || ( ay->oric->warpspeed ) )
           {
             struct aywrite writenow;
 
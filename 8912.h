@@ -95,6 +95,12 @@ struct ay8912
   Uint32          ccycle, lastcyc, ccyc;
   Uint32          keybitdelay, currkeyoffs;
 
+  // Keys queued up by queuekeys
+  char           *keyqueue;
+  int             keysqueued, kqoffs;
+  SDL_COMPAT_KEY *keytab;
+  Sint16          audiocapbuf[AUDIO_BUFLEN];
+
   SDL_bool        audiolocked;
   SDL_bool        do_logcycle_reset;
   Sint32          logged, tlogged;
@@ -103,11 +109,14 @@ struct ay8912
   struct tnchange tapelog[TAPELOG_SIZE];
 };
 
-void queuekeys( char *str );
+void queuekeys( struct ay8912 *ay, char *str );
 
 SDL_bool ay_init( struct ay8912 *ay, struct machine *oric );
 void ay_callback( void *dummy, Sint8 *stream, int length );
+void ay_patches( struct ay8912 *ay );
 void ay_ticktock( struct ay8912 *ay, int cycles );
+void ay_logtime( struct ay8912 *ay, int cycles );
+int ay_nextevent( struct ay8912 *ay );
 void ay_update_keybits( struct ay8912 *ay );
 void ay_keypress( struct ay8912 *ay, SDL_COMPAT_KEY key, SDL_bool down );
 
@@ -0,0 +1,452 @@
+/*
+**  Oricutron
+**  Copyright (C) 2009-2014 Peter Gordon
+**
+**  This program is free software; you can redistribute it and/or
+**  modify it under the terms of the GNU General Public License
+**  as published by the Free Software Foundation, version 2
+**  of the License.
+**
+**  This program is distributed in the hope that it will be useful,
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**  GNU General Public License for more details.
+**
+**  You should have received a copy of the GNU General Public License
+**  along with this program; if not, write to the Free Software
+**  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+**
+**  Running many headless machines at once
+**
+**  The manifest has one job per line:
+**
+**    <image> [key=value ...]
+**
+**  where <image> is a tape, disk or snapshot, and the keys are
+**  machine, drive, cycles, frames, pc, mem (addr,value), text and
+**  dump. Values with spaces can be put in double quotes. Anything
+**  after a # is ignored. Keys that aren't given come from the
+**  command line.
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "system.h"
+#include "6502.h"
+#include "via.h"
+#include "8912.h"
+#include "gui.h"
+#include "disk.h"
+#include "monitor.h"
+#include "6551.h"
+#include "machine.h"
+#include "ula.h"
+#include "tape.h"
+#include "snapshot.h"
+#include "headless.h"
+#include "batch.h"
+
+struct batch
+{
+  struct machine  *proto;         // Every job starts as a copy of this
+  struct batchjob *jobs;
+  int              numjobs;
+  int              nextjob;
+
+  // Machine setup and teardown touch the ROM images, menus and
+  // monitor symbol tables, which are shared. So they happen one at
+  // a time under this lock. Only the runs themselves are parallel.
+  SDL_mutex       *lock;
+};
+
+static char *machnames[] = { "oric1|1", "o16k", "atmos|a", "telestrat|t", "pravetz|p", NULL };
+static Sint32 machtypes[] = { MACH_ORIC1, MACH_ORIC1_16K, MACH_ATMOS, MACH_TELESTRAT, MACH_PRAVETZ };
+
+static char *drivenames[] = { "none", "microdisc|m", "jasmin|j", "pravetz|p", NULL };
+static Sint32 drivetypes[] = { DRV_NONE, DRV_MICRODISC, DRV_JASMIN, DRV_PRAVETZ };
+
+// Find str in a list of |-separated alternatives
+static int batch_lookup( char **names, char *str )
+{
+  int i, len;
+  char *n;
+
+  for( i=0; names[i]; i++ )
+  {
+    for( n=names[i]; *n; n+=len )
+    {
+      if( *n == '|' ) n++;
+      for( len=0; ( n[len] ) && ( n[len] != '|' ); len++ ) ;
+      if( ( strlen( str ) == len ) && ( strncasecmp( n, str, len ) == 0 ) )
+        return i;
+    }
+  }
+  return -1;
+}
+
+// Cut the next token out of *buf. Double quotes group spaces into
+// the token and are removed. Returns NULL at the end of the line.
+static char *batch_token( char **buf )
+{
+  char *s = *buf, *d, *tok;
+  SDL_bool quoted = SDL_FALSE;
+
+  while( isws( *s ) ) s++;
+  if( ( *s == 0 ) || ( *s == '#' ) || ( *s == 10 ) || ( *s == 13 ) ) return NULL;
+
+  tok = d = s;
+  while( *s )
+  {
+    if( *s == '"' ) { quoted = !quoted; s++; continue; }
+    if( ( !quoted ) && ( isws( *s ) || ( *s == 10 ) || ( *s == 13 ) ) ) break;
+    *(d++) = *(s++);
+  }
+  if( *s ) s++;
+  *d = 0;
+
+  *buf = s;
+  return tok;
+}
+
+static SDL_bool batch_parsejob( struct batch *b, struct batchjob *job, char *buf, int jobnum, struct headless *defaults )
+{
+  char *tok, *val;
+  int i;
+  unsigned int addr, v;
+
+  job->machine = b->proto->type;
+  job->drive   = b->proto->drivetype;
+  job->hl      = *defaults;
+  job->ok      = SDL_FALSE;
+
+  // A --dump name on the command line is a prefix for every job
+  if( ( defaults->dumpname[0] ) &&
+      ( snprintf( job->hl.dumpname, sizeof( job->hl.dumpname ), "%s%04d", defaults->dumpname, jobnum+1 ) >= (int)sizeof( job->hl.dumpname ) ) )
+  {
+    fprintf( stderr, "Line %d: Dump name is too long\n", job->line );
+    return SDL_FALSE;
+  }
+
+  tok = batch_token( &buf );
+  strncpy( job->image, tok, sizeof( job->image ) );
+  job->image[sizeof( job->image )-1] = 0;
+
+  // Pick the machine and drive like the command line does
+  job->imagetype = detect_image_type( job->image );
+  switch( job->imagetype )
+  {
+    case IMG_ATMOS_MICRODISC: job->machine = MACH_ATMOS;     job->drive = DRV_MICRODISC; break;
+    case IMG_ATMOS_JASMIN:    job->machine = MACH_ATMOS;     job->drive = DRV_JASMIN;    break;
+    case IMG_TELESTRAT_DISK:  job->machine = MACH_TELESTRAT; job->drive = DRV_MICRODISC; break;
+    case IMG_PRAVETZ_DISK:    job->machine = MACH_PRAVETZ;   job->drive = DRV_PRAVETZ;   break;
+    case IMG_GUESS_MICRODISC: job->drive = DRV_MICRODISC; break;
+    case IMG_SNAPSHOT:
+    case IMG_TAPE:
+      break;
+
+    default:
+      fprintf( stderr, "Line %d: Unable to use '%s'\n", job->line, job->image );
+      return SDL_FALSE;
+  }
+
+  while( ( tok = batch_token( &buf ) ) )
+  {
+    val = strchr( tok, '=' );
+    if( !val )
+    {
+      fprintf( stderr, "Line %d: Expected key=value, not '%s'\n", job->line, tok );
+      return SDL_FALSE;
+    }
+    *(val++) = 0;
+
+    if( strcasecmp( tok, "machine" ) == 0 )
+    {
+      if( ( i = batch_lookup( machnames, val ) ) == -1 ) break;
+      job->machine = machtypes[i];
+      continue;
+    }
+
+    if( strcasecmp( tok, "drive" ) == 0 )
+    {
+      if( ( i = batch_lookup( drivenames, val ) ) == -1 ) break;
+      job->drive = drivetypes[i];
+      continue;
+    }
+
+    if( strcasecmp( tok, "cycles" ) == 0 )
+    {
+      job->hl.maxcycles = strtoull( val, NULL, 10 );
+      continue;
+    }
+
+    if( strcasecmp( tok, "frames" ) == 0 )
+    {
+      job->hl.maxframes = atoi( val );
+      continue;
+    }
+
+    if( strcasecmp( tok, "pc" ) == 0 )
+    {
+      i = 0;
+      if( !mon_getnum( b->proto, &addr, val, &i, SDL_FALSE, SDL_FALSE, SDL_FALSE, SDL_FALSE ) ) break;
+      job->hl.pc = addr&0xffff;
+      continue;
+    }
+
+    if( strcasecmp( tok, "mem" ) == 0 )
+    {
+      i = 0;
+      if( ( !mon_getnum( b->proto, &addr, val, &i, SDL_FALSE, SDL_FALSE, SDL_FALSE, SDL_FALSE ) ) ||
+          ( val[i++] != ',' ) ||
+          ( !mon_getnum( b->proto, &v, val, &i, SDL_FALSE, SDL_FALSE, SDL_FALSE, SDL_FALSE ) ) )
+        break;
+      job->hl.memaddr = addr&0xffff;
+      job->hl.memval  = v&0xff;
+      continue;
+    }
+
+    if( strcasecmp( tok, "text" ) == 0 )
+    {
+      strncpy( job->hl.text, val, HL_TEXTLEN );
+      job->hl.text[HL_TEXTLEN] = 0;
+      continue;
+    }
+
+    if( strcasecmp( tok, "dump" ) == 0 )
+    {
+      strncpy( job->hl.dumpname, val, sizeof( job->hl.dumpname ) );
+      job->hl.dumpname[sizeof( job->hl.dumpname )-1] = 0;
+      continue;
+    }
+
+    fprintf( stderr, "Line %d: Unknown key '%s'\n", job->line, tok );
+    return SDL_FALSE;
+  }
+
+  if( tok )
+  {
+    fprintf( stderr, "Line %d: Bad value for '%s'\n", job->line, tok );
+    return SDL_FALSE;
+  }
+
+  if( !headless_hascondition( &job->hl ) )
+  {
+    fprintf( stderr, "Line %d: No exit condition\n", job->line );
+    return SDL_FALSE;
+  }
+
+  return SDL_TRUE;
+}
+
+static SDL_bool batch_load( struct batch *b, char *manifest, struct headless *defaults )
+{
+  FILE *f;
+  char line[2048], *p;
+  int lineno, space;
+  struct batchjob *tmp;
+
+  f = fopen( manifest, "r" );
+  if( !f )
+  {
+    fprintf( stderr, "Unable to open '%s'\n", manifest );
+    return SDL_FALSE;
+  }
+
+  space = 0;
+  for( lineno=1; fgets( line, sizeof( line ), f ); lineno++ )
+  {
+    p = line;
+    while( isws( *p ) ) p++;
+    if( ( *p == 0 ) || ( *p == '#' ) || ( *p == 10 ) || ( *p == 13 ) ) continue;
+
+    if( b->numjobs >= space )
+    {
+      space += 32;
+      tmp = realloc( b->jobs, space * sizeof( struct batchjob ) );
+      if( !tmp )
+      {
+        fprintf( stderr, "Out of memory\n" );
+        fclose( f );
+        return SDL_FALSE;
+      }
+      b->jobs = tmp;
+    }
+
+    b->jobs[b->numjobs].line = lineno;
+    if( !batch_parsejob( b, &b->jobs[b->numjobs], p, b->numjobs, defaults ) )
+    {
+      fclose( f );
+      return SDL_FALSE;
+    }
+    b->numjobs++;
+  }
+
+  fclose( f );
+  return SDL_TRUE;
+}
+
+// Called with the lock held
+static SDL_bool batch_insert( struct machine *oric, struct batchjob *job )
+{
+  switch( job->imagetype )
+  {
+    case IMG_SNAPSHOT:
+      return load_snapshot( oric, job->image );
+
+    case IMG_TAPE:
+      if( !tape_load_tap( oric, job->image ) ) return SDL_FALSE;
+      queuekeys( &oric->ay, "CLOAD\"\"\x0d" );
+      break;
+
+    default:
+      if( !diskimage_load( oric, job->image, 0 ) ) return SDL_FALSE;
+      switch( oric->drivetype )
+      {
+        case DRV_PRAVETZ:
+          queuekeys( &oric->ay, "CALL#320\x0d" );
+          break;
+
+        case DRV_JASMIN:
+          oric->auto_jasmin_reset = SDL_TRUE;
+          break;
+      }
+      break;
+  }
+
+  return SDL_TRUE;
+}
+
+static void batch_runjob( struct batch *b, struct batchjob *job, int jobnum )
+{
+  struct machine *oric;
+  Uint32 start;
+
+  SDL_LockMutex( b->lock );
+  oric = headless_newmachine( b->proto, job->machine, job->drive );
+  job->ok = ( oric != NULL ) && batch_insert( oric, job );
+  SDL_UnlockMutex( b->lock );
+
+  if( job->ok )
+  {
+    start = SDL_GetTicks();
+    headless_run( oric, &job->hl );
+    job->ms   = SDL_GetTicks() - start;
+    job->pc   = oric->cpu.calcpc;
+    job->hash = headless_screenhash( oric );
+    headless_dump( oric, &job->hl );
+  }
+
+  SDL_LockMutex( b->lock );
+  if( oric ) headless_freemachine( oric );
+  if( job->ok )
+    printf( "job=%d image=%s exit=%s cycles=%llu frames=%d pc=$%04X hash=%08X ms=%u\n",
+      jobnum+1, job->image, headless_reason( job->hl.reason ), (unsigned long long)job->hl.cycles,
+      job->hl.frames, job->pc, job->hash, job->ms );
+  else
+    printf( "job=%d image=%s exit=setup\n", jobnum+1, job->image );
+  fflush( stdout );
+  SDL_UnlockMutex( b->lock );
+}
+
+static int batch_worker( void *data )
+{
+  struct batch *b = (struct batch *)data;
+  int jobnum;
+
+  for( ;; )
+  {
+    SDL_LockMutex( b->lock );
+    jobnum = b->nextjob++;
+    SDL_UnlockMutex( b->lock );
+
+    if( jobnum >= b->numjobs ) break;
+    batch_runjob( b, &b->jobs[jobnum], jobnum );
+  }
+
+  return 0;
+}
+
+/*
+** Run every job in the manifest, numthreads at a time. Each job gets
+** its own machine, so the only thing the threads share is the lock.
+** Returns 0 if every job reached its pc, mem or text condition, 1 if
+** any hit a cycle or frame limit instead, and 2 if any failed to set
+** up, jammed or hit another breakpoint.
+*/
+int batch_run( struct machine *proto, struct headless *defaults, char *manifest, int numthreads )
+{
+  struct batch b;
+  SDL_Thread **threads;
+  int i, ret, passed, limited, failed;
+  Uint32 start;
+
+  b.proto   = proto;
+  b.jobs    = NULL;
+  b.numjobs = 0;
+  b.nextjob = 0;
+
+  if( !batch_load( &b, manifest, defaults ) )
+  {
+    if( b.jobs ) free( b.jobs );
+    return 2;
+  }
+
+  if( numthreads > b.numjobs ) numthreads = b.numjobs;
+  if( numthreads < 1 ) numthreads = 1;
+
+  b.lock  = SDL_CreateMutex();
+  threads = malloc( numthreads * sizeof( SDL_Thread * ) );
+  if( ( !b.lock ) || ( !threads ) )
+  {
+    fprintf( stderr, "Unable to start the batch threads\n" );
+    if( b.lock ) SDL_DestroyMutex( b.lock );
+    if( threads ) free( threads );
+    free( b.jobs );
+    return 2;
+  }
+
+  // This thread is one of the workers
+  start = SDL_GetTicks();
+  for( i=1; i<numthreads; i++ )
+    threads[i] = SDL_COMPAT_CreateThread( batch_worker, "batch", &b );
+
+  batch_worker( &b );
+  for( i=1; i<numthreads; i++ )
+  {
+    if( threads[i] ) SDL_WaitThread( threads[i], NULL );
+  }
+
+  passed = limited = failed = 0;
+  for( i=0; i<b.numjobs; i++ )
+  {
+    if( !b.jobs[i].ok ) { failed++; continue; }
+    switch( b.jobs[i].hl.reason )
+    {
+      case HLEXIT_PC:
+      case HLEXIT_MEM:
+      case HLEXIT_TEXT:
+        passed++;
+        break;
+
+      case HLEXIT_CYCLES:
+      case HLEXIT_FRAMES:
+        limited++;
+        break;
+
+      default:
+        failed++;
+        break;
+    }
+  }
+
+  printf( "jobs=%d threads=%d passed=%d limited=%d failed=%d ms=%u\n",
+    b.numjobs, numthreads, passed, limited, failed, SDL_GetTicks() - start );
+
+  ret = failed ? 2 : ( limited ? 1 : 0 );
+  SDL_DestroyMutex( b.lock );
+  free( threads );
+  free( b.jobs );
+  return ret;
+}
@@ -0,0 +1,39 @@
+/*
+**  Oricutron
+**  Copyright (C) 2009-2014 Peter Gordon
+**
+**  This program is free software; you can redistribute it and/or
+**  modify it under the terms of the GNU General Public License
+**  as published by the Free Software Foundation, version 2
+**  of the License.
+**
+**  This program is distributed in the hope that it will be useful,
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**  GNU General Public License for more details.
+**
+**  You should have received a copy of the GNU General Public License
+**  along with this program; if not, write to the Free Software
+**  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+**
+**  Running many headless machines at once
+*/
+
+// One line of the manifest
+struct batchjob
+{
+  int             line;             // Manifest line, for messages
+  char            image[1024];
+  int             imagetype;        // IMG_*
+  Sint32          machine;          // MACH_*
+  Sint32          drive;            // DRV_*
+  struct headless hl;               // Exit conditions and results
+
+  // Results
+  SDL_bool        ok;               // Set up and ran
+  Uint16          pc;
+  Uint32          hash;             // headless_screenhash
+  Uint32          ms;               // Wall time for the run
+};
+
+int batch_run( struct machine *proto, struct headless *defaults, char *manifest, int numthreads );
@@ -0,0 +1,371 @@
+/*
+**  Oricutron
+**  Copyright (C) 2009-2014 Peter Gordon
+**
+**  This program is free software; you can redistribute it and/or
+**  modify it under the terms of the GNU General Public License
+**  as published by the Free Software Foundation, version 2
+**  of the License.
+**
+**  This program is distributed in the hope that it will be useful,
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**  GNU General Public License for more details.
+**
+**  You should have received a copy of the GNU General Public License
+**  along with this program; if not, write to the Free Software
+**  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+**
+**  Emulator benchmarks
+**
+**  Each workload runs a fixed number of emulated cycles on a fresh
+**  machine, flat out, and reports one CSV line. Everything a workload
+**  needs apart from the ROMs is built here, so the results can be
+**  compared between builds and hosts.
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "system.h"
+#include "6502.h"
+#include "via.h"
+#include "8912.h"
+#include "gui.h"
+#include "disk.h"
+#include "monitor.h"
+#include "6551.h"
+#include "machine.h"
+#include "ula.h"
+#include "tape.h"
+#include "headless.h"
+#include "bench.h"
+
+extern Uint32 cyclespersample;
+
+#define BENCH_CODE      0x0400      // Where the machine code workloads go
+#define BENCH_TAPELEN   16384       // Bytes of data on the bench tape
+
+struct benchload
+{
+  char     *name;
+  Sint32    machine;
+  Sint32    drive;
+  Uint32    warmup;                 // Cycles to boot and type before timing
+  Uint32    cycles;                 // Cycles to time
+  char     *keys;                   // Typed at the BASIC prompt
+  SDL_bool (*setup)( struct machine *oric );
+};
+
+// Put some code into RAM and start running it
+static void bench_code( struct machine *oric, Uint8 *code, int len, Uint16 start )
+{
+  memcpy( &oric->mem[BENCH_CODE], code, len );
+  oric->cpu.pc  = start;
+  oric->cpu.f_i = 1;
+}
+
+// Write AY registers through the VIA, like the ROM does
+static SDL_bool bench_ay( struct machine *oric )
+{
+  static Uint8 code[] = {
+    0x8e, 0x0f, 0x03,  // 0400 STX $030F   ; register
+    0xa0, 0xff,        // 0403 LDY #$FF
+    0x8c, 0x0c, 0x03,  // 0405 STY $030C   ; latch address
+    0xa0, 0xdd,        // 0408 LDY #$DD
+    0x8c, 0x0c, 0x03,  // 040A STY $030C   ; inactive
+    0x8d, 0x0f, 0x03,  // 040D STA $030F   ; value
+    0xa0, 0xfd,        // 0410 LDY #$FD
+    0x8c, 0x0c, 0x03,  // 0412 STY $030C   ; write
+    0xa0, 0xdd,        // 0415 LDY #$DD
+    0x8c, 0x0c, 0x03,  // 0417 STY $030C   ; inactive
+    0x60,              // 041A RTS
+    0xea, 0xea, 0xea, 0xea, 0xea,
+    0x78,              // 0420 SEI
+    0xa9, 0xff,        // 0421 LDA #$FF
+    0x8d, 0x03, 0x03,  // 0423 STA $0303   ; DDRA all out
+    0xa2, 0x07,        // 0426 LDX #7
+    0xa9, 0xf8,        // 0428 LDA #$F8    ; tones on
+    0x20, 0x00, 0x04,  // 042A JSR $0400
+    0xe6, 0x00,        // 042D INC $00
+    0xa2, 0x00,        // 042F LDX #0
+    0xa5, 0x00,        // 0431 LDA $00     ; sweep the periods
+    0x20, 0x00, 0x04,  // 0433 JSR $0400
+    0xe8,              // 0436 INX
+    0xe0, 0x06,        // 0437 CPX #6
+    0xd0, 0xf6,        // 0439 BNE $0431
+    0xa2, 0x08,        // 043B LDX #8
+    0xa9, 0x0f,        // 043D LDA #$0F    ; full volume
+    0x20, 0x00, 0x04,  // 043F JSR $0400
+    0xe8,              // 0442 INX
+    0xe0, 0x0b,        // 0443 CPX #11
+    0xd0, 0xf6,        // 0445 BNE $043D
+    0x4c, 0x2d, 0x04   // 0447 JMP $042D
+  };
+
+  bench_code( oric, code, sizeof( code ), 0x0420 );
+  return SDL_TRUE;
+}
+
+// Copy and checksum a page in RAM, calling a subroutine that
+// is changed on every pass
+static SDL_bool bench_cpu( struct machine *oric )
+{
+  static Uint8 code[] = {
+    0x78,              // 0400 SEI
+    0xa2, 0x00,        // 0401 LDX #0
+    0x8a,              // 0403 TXA         ; fill $0500 with 0-255
+    0x9d, 0x00, 0x05,  // 0404 STA $0500,X
+    0xe8,              // 0407 INX
+    0xd0, 0xf9,        // 0408 BNE $0403
+    0xa9, 0x00,        // 040A LDA #0      ; ($02) = $0500
+    0x85, 0x02,        // 040C STA $02
+    0xa9, 0x05,        // 040E LDA #5
+    0x85, 0x03,        // 0410 STA $03
+    0xa0, 0x00,        // 0412 LDY #0
+    0xb1, 0x02,        // 0414 LDA ($02),Y
+    0x20, 0x30, 0x04,  // 0416 JSR $0430
+    0x91, 0x02,        // 0419 STA ($02),Y
+    0x45, 0x00,        // 041B EOR $00
+    0x85, 0x00,        // 041D STA $00     ; checksum
+    0xc8,              // 041F INY
+    0xd0, 0xf2,        // 0420 BNE $0414
+    0xee, 0x32, 0x04,  // 0422 INC $0432   ; change the ADC below
+    0x8d, 0x80, 0xbb,  // 0425 STA $BB80   ; show the checksum
+    0x4c, 0x0a, 0x04,  // 0428 JMP $040A
+    0xea, 0xea, 0xea, 0xea, 0xea,
+    0x0a,              // 0430 ASL
+    0x69, 0x01,        // 0431 ADC #1
+    0x60               // 0433 RTS
+  };
+
+  bench_code( oric, code, sizeof( code ), 0x0400 );
+  return SDL_TRUE;
+}
+
+// Read sectors 1-17 of track 0 over and over
+static SDL_bool bench_microdisc( struct machine *oric )
+{
+  static Uint8 code[] = {
+    0x78,              // 0400 SEI
+    0xa9, 0x82,        // 0401 LDA #$82    ; EPROM off, ROM on, no IRQ
+    0x8d, 0x14, 0x03,  // 0403 STA $0314
+    0xa2, 0x01,        // 0406 LDX #1
+    0x8e, 0x12, 0x03,  // 0408 STX $0312   ; sector
+    0xa9, 0x80,        // 040B LDA #$80
+    0x8d, 0x10, 0x03,  // 040D STA $0310   ; read sector
+    0xa0, 0x00,        // 0410 LDY #0
+    0xad, 0x18, 0x03,  // 0412 LDA $0318   ; wait for DRQ
+    0x30, 0xfb,        // 0415 BMI $0412
+    0xad, 0x13, 0x03,  // 0417 LDA $0313
+    0x99, 0x00, 0x05,  // 041A STA $0500,Y
+    0xc8,              // 041D INY
+    0xd0, 0xf2,        // 041E BNE $0412
+    0xad, 0x10, 0x03,  // 0420 LDA $0310   ; wait for not busy
+    0x4a,              // 0423 LSR
+    0xb0, 0xfa,        // 0424 BCS $0420
+    0xe8,              // 0426 INX
+    0xe0, 0x12,        // 0427 CPX #18
+    0xd0, 0xdd,        // 0429 BNE $0408
+    0xf0, 0xd9         // 042B BEQ $0406
+  };
+
+  if( !diskimage_format( oric, 0, 1, 1, 17, "bench.dsk" ) ) return SDL_FALSE;
+  bench_code( oric, code, sizeof( code ), 0x0400 );
+  return SDL_TRUE;
+}
+
+// Step through all eight banks, reading from each one
+static SDL_bool bench_telestrat( struct machine *oric )
+{
+  static Uint8 code[] = {
+    0x78,              // 0400 SEI
+    0xa9, 0x07,        // 0401 LDA #7
+    0x8d, 0x23, 0x03,  // 0403 STA $0323   ; DDRA bank bits out
+    0xa2, 0x00,        // 0406 LDX #0
+    0x8e, 0x21, 0x03,  // 0408 STX $0321   ; select bank
+    0xad, 0x00, 0xc0,  // 040B LDA $C000
+    0xe8,              // 040E INX
+    0x8a,              // 040F TXA
+    0x29, 0x07,        // 0410 AND #7
+    0xaa,              // 0412 TAX
+    0x4c, 0x08, 0x04   // 0413 JMP $0408
+  };
+
+  bench_code( oric, code, sizeof( code ), 0x0400 );
+  return SDL_TRUE;
+}
+
+// A long machine code file, loaded at real speed
+static SDL_bool bench_tape( struct machine *oric )
+{
+  static Uint8 header[] = { 0x16, 0x16, 0x16, 0x16, 0x24,
+                            0x00, 0x00, 0x80, 0x00,
+                            (0x0600+BENCH_TAPELEN-1)>>8, (0x0600+BENCH_TAPELEN-1)&0xff,
+                            0x06, 0x00, 0x00,
+                            'B', 'E', 'N', 'C', 'H', 0 };
+  Uint8 *buf;
+  SDL_bool ok;
+  int i;
+
+  buf = malloc( sizeof( header ) + BENCH_TAPELEN );
+  if( !buf ) return SDL_FALSE;
+
+  memcpy( buf, header, sizeof( header ) );
+  for( i=0; i<BENCH_TAPELEN; i++ )
+    buf[sizeof( header )+i] = i*7;
+
+  ok = tape_load_buffer( oric, buf, sizeof( header ) + BENCH_TAPELEN, "bench.tap" );
+  free( buf );
+
+  oric->tapeturbo = SDL_FALSE;
+  return ok;
+}
+
+static struct benchload loads[] =
+  { { "basic",     MACH_ATMOS,     DRV_NONE,      3000000, 20000000,
+      "10 A=A+1.5*2.25/3:B=SQR(A):GOTO 10\x0dRUN\x0d", NULL },
+    { "hires",     MACH_ATMOS,     DRV_NONE,      3000000, 20000000,
+      "10 HIRES:P=1\x0d" "20 FOR Y=0 TO 199:CURSET 0,Y,P:DRAW 239,0,P:NEXT\x0d" "30 P=1-P:GOTO 20\x0dRUN\x0d", NULL },
+    { "cpu",       MACH_ATMOS,     DRV_NONE,      0,       20000000, NULL, bench_cpu },
+    { "ay",        MACH_ATMOS,     DRV_NONE,      0,       20000000, NULL, bench_ay },
+    { "tape",      MACH_ATMOS,     DRV_NONE,      3000000, 20000000, "CLOAD\"\"\x0d", bench_tape },
+    { "microdisc", MACH_ATMOS,     DRV_MICRODISC, 0,       20000000, NULL, bench_microdisc },
+    { "telestrat", MACH_TELESTRAT, DRV_MICRODISC, 0,       20000000, NULL, bench_telestrat },
+    { NULL, } };
+
+static char *machnames[] = { "oric1", "oric1-16k", "atmos", "telestrat", "pravetz" };
+
+// Is "name" in the comma separated list "which"?
+static SDL_bool bench_wanted( char *which, char *name )
+{
+  int len = (int)strlen( name );
+  char *p;
+
+  if( strcasecmp( which, "all" ) == 0 ) return SDL_TRUE;
+
+  for( p=which; p; p=strchr( p, ',' ) )
+  {
+    if( *p == ',' ) p++;
+    if( ( strncasecmp( p, name, len ) == 0 ) && ( ( p[len] == ',' ) || ( p[len] == 0 ) ) )
+      return SDL_TRUE;
+  }
+  return SDL_FALSE;
+}
+
+/*
+** Run one workload a frame at a time. After each frame the AY is
+** asked for that frame's worth of audio, like the SDL callback
+** would do if sound were on, so its cost shows up in the figures.
+*/
+static SDL_bool bench_one( struct machine *proto, struct benchload *bl )
+{
+  struct machine *oric;
+  struct headless hl;
+  Sint16 audiobuf[AUDIO_BUFLEN*2];
+  Uint64 cycles, samples, want, start, t, us, cpu_us, video_us, audio_us;
+  int frames, n;
+  char *status;
+
+  oric = headless_newmachine( proto, bl->machine, bl->drive );
+  if( ( oric ) && ( bl->setup ) && ( !bl->setup( oric ) ) )
+  {
+    headless_freemachine( oric );
+    oric = NULL;
+  }
+
+  if( !oric )
+  {
+    printf( "%s,%s,skipped,0,0,00000000,0,0.000,0.0,0,0,0,0\n", bl->name, machnames[bl->machine] );
+    return SDL_FALSE;
+  }
+
+  if( bl->keys ) queuekeys( &oric->ay, bl->keys );
+
+  headless_defaults( &hl );
+  hl.dumpname[0] = 0;
+  if( bl->warmup )
+  {
+    hl.maxcycles = bl->warmup;
+    headless_run( oric, &hl );
+  }
+
+  hl.maxcycles = 0;
+  hl.maxframes = 1;
+  hl.timed     = SDL_TRUE;
+
+  cycles = samples = cpu_us = video_us = audio_us = 0;
+  frames = 0;
+  status = "ok";
+
+  start = SDL_COMPAT_GetTicksUS();
+  while( cycles < bl->cycles )
+  {
+    if( headless_run( oric, &hl ) != HLEXIT_FRAMES )
+    {
+      status = headless_reason( hl.reason );
+      break;
+    }
+
+    cycles   += hl.cycles;
+    cpu_us   += hl.cpu_us;
+    video_us += hl.video_us;
+    frames++;
+
+    t = SDL_COMPAT_GetTicksUS();
+    want = ( cycles * AUDIO_FREQ ) / CYCLESPERSECOND - samples;
+    while( want > 0 )
+    {
+      n = ( want > AUDIO_BUFLEN ) ? AUDIO_BUFLEN : (int)want;
+      ay_callback( &oric->ay, (Sint8 *)audiobuf, n*2*sizeof( Uint16 ) );
+      samples += n;
+      want -= n;
+    }
+    audio_us += SDL_COMPAT_GetTicksUS() - t;
+  }
+  us = SDL_COMPAT_GetTicksUS() - start;
+  if( !us ) us = 1;
+
+  printf( "%s,%s,%s,%llu,%d,%08X,%llu,%.3f,%.1f,%llu,%llu,%llu,%llu\n",
+    bl->name, machnames[bl->machine], status,
+    (unsigned long long)cycles, frames, headless_screenhash( oric ), (unsigned long long)us,
+    (double)cycles / (double)us,
+    ( (double)cycles * 100.0 ) / ( (double)us * CYCLESPERSECOND / 1000000.0 ),
+    (unsigned long long)cpu_us, (unsigned long long)video_us, (unsigned long long)audio_us,
+    (unsigned long long)( ( us > cpu_us+video_us+audio_us ) ? us-(cpu_us+video_us+audio_us) : 0 ) );
+  fflush( stdout );
+
+  headless_freemachine( oric );
+  return ( hl.reason == HLEXIT_FRAMES );
+}
+
+/*
+** Run the workloads named in "which" (comma separated, or "all")
+** and print a CSV line for each. Returns 0 if they all ran.
+*/
+int bench_run( struct machine *proto, char *which )
+{
+  struct benchload *bl;
+  SDL_bool ok = SDL_TRUE, any = SDL_FALSE;
+
+  // Nothing opened the audio, but the AY still needs to know this
+  if( !cyclespersample )
+    cyclespersample = ( CYCLESPERSECOND << FPBITS ) / AUDIO_FREQ;
+
+  printf( "workload,machine,status,cycles,frames,hash,us,mhz,speed,cpu_us,video_us,audio_us,other_us\n" );
+  for( bl=loads; bl->name; bl++ )
+  {
+    if( !bench_wanted( which, bl->name ) ) continue;
+    any = SDL_TRUE;
+    if( !bench_one( proto, bl ) ) ok = SDL_FALSE;
+  }
+
+  if( !any )
+  {
+    fprintf( stderr, "No such benchmark '%s'\n", which );
+    return EXIT_FAILURE;
+  }
+
+  return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
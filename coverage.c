@@ -0,0 +1,240 @@
+/*
+**  Oricutron
+**  Copyright (C) 2009-2014 Peter Gordon
+**
+**  This program is free software; you can redistribute it and/or
+**  modify it under the terms of the GNU General Public License
+**  as published by the Free Software Foundation, version 2
+**  of the License.
+**
+**  This program is distributed in the hope that it will be useful,
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**  GNU General Public License for more details.
+**
+**  You should have received a copy of the GNU General Public License
+**  along with this program; if not, write to the Free Software
+**  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+**
+**  Code and data coverage
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "system.h"
+#include "6502.h"
+#include "via.h"
+#include "8912.h"
+#include "gui.h"
+#include "disk.h"
+#include "monitor.h"
+#include "6551.h"
+#include "machine.h"
+
+extern unsigned char rom_microdisc[], rom_jasmin[];
+
+static char *cov_regionname( struct machine *oric, int region )
+{
+  static char *telebanks[] = { "bank0", "bank1", "bank2", "bank3", "bank4", "bank5", "bank6", "bank7" };
+
+  if( region < 0 ) return "ram";
+  if( oric->type == MACH_TELESTRAT ) return telebanks[region&7];
+  switch( region )
+  {
+    case COV_ROM:     return "rom";
+    case COV_OVERLAY: return "romdis";
+    case COV_DISKROM: return "diskrom";
+  }
+  return "?";
+}
+
+// Hook the coverage back into the CPU after init_machine
+void coverage_attach( struct machine *oric )
+{
+  oric->cpu.covpages = oric->cov.map ? oric->cov.pages : NULL;
+}
+
+// The bank a page above $C000 is counted in, from what it is mapped to.
+// With the disk ROM in, the rest of the overlay RAM stays visible.
+static int coverage_bank( struct machine *oric, int page )
+{
+  Uint8 *p = oric->mapread[page];
+
+  if( oric->type == MACH_TELESTRAT )
+    return ( ( oric->tele_currbank >= 0 ) && ( oric->tele_currbank < COV_BANKS ) ) ? oric->tele_currbank : 0;
+
+  if( ( oric->rom ) && ( p >= oric->rom ) && ( p < &oric->rom[0x4000] ) )
+    return COV_ROM;
+  if( ( p >= rom_microdisc ) && ( p < &rom_microdisc[0x2000] ) )
+    return COV_DISKROM;
+  if( ( p >= rom_jasmin ) && ( p < &rom_jasmin[0x800] ) )
+    return COV_DISKROM;
+  return COV_OVERLAY;
+}
+
+// Point the pages at the right part of the map for the
+// current memory configuration. Called by setmemmap.
+void coverage_setpages( struct machine *oric )
+{
+  struct coverage *c = &oric->cov;
+  int i;
+
+  if( !c->map ) return;
+
+  for( i=0; i<0xc0; i++ )
+    c->pages[i] = &c->map[i<<8];
+  for( ; i<256; i++ )
+    c->pages[i] = &c->map[COV_RAMSIZE + coverage_bank( oric, i )*0x4000 + ((i-0xc0)<<8)];
+}
+
+/*
+** Reads and writes only get seen on pages that are not in the
+** direct page tables, so setmemmap takes them all out while
+** coverage is on. Code fetches don't go through there, so they
+** don't count as reads.
+*/
+SDL_bool coverage_start( struct machine *oric )
+{
+  if( !oric->cov.map )
+  {
+    oric->cov.map = calloc( COV_SIZE, 1 );
+    if( !oric->cov.map ) return SDL_FALSE;
+    setmemmap( oric );
+  }
+
+  coverage_attach( oric );
+  return SDL_TRUE;
+}
+
+void coverage_stop( struct machine *oric )
+{
+  if( oric->cov.map ) free( oric->cov.map );
+  oric->cov.map = NULL;
+  coverage_attach( oric );
+  setmemmap( oric );
+}
+
+void coverage_reset( struct machine *oric )
+{
+  if( oric->cov.map ) memset( oric->cov.map, 0, COV_SIZE );
+}
+
+// Count the addresses in a region with each flag
+static void coverage_count( Uint8 *map, int len, int *counts )
+{
+  int i;
+
+  counts[0] = counts[1] = counts[2] = 0;
+  for( i=0; i<len; i++ )
+  {
+    if( map[i] & COV_EXEC )  counts[0]++;
+    if( map[i] & COV_READ )  counts[1]++;
+    if( map[i] & COV_WRITE ) counts[2]++;
+  }
+}
+
+void coverage_show( struct machine *oric )
+{
+  int counts[3], i;
+
+  if( !oric->cov.map )
+  {
+    mon_str( "Coverage off" );
+    return;
+  }
+
+  mon_str( "Region   Executed     Read  Written" );
+  coverage_count( oric->cov.map, COV_RAMSIZE, counts );
+  mon_printf( "%-8s %8d %8d %8d", cov_regionname( oric, -1 ), counts[0], counts[1], counts[2] );
+  for( i=0; i<COV_BANKS; i++ )
+  {
+    coverage_count( &oric->cov.map[COV_RAMSIZE+i*0x4000], 0x4000, counts );
+    if( ( !counts[0] ) && ( !counts[1] ) && ( !counts[2] ) ) continue;
+    mon_printf( "%-8s %8d %8d %8d", cov_regionname( oric, i ), counts[0], counts[1], counts[2] );
+  }
+}
+
+// The symbol at addr in a region, the way the monitor would see it if that bank was switched in
+static struct msym *coverage_sym( struct machine *oric, int region, Uint16 addr )
+{
+  struct msym *sym;
+  SDL_bool romdis;
+  int currbank;
+
+  if( region < 0 )
+    return mon_find_sym_by_addr( oric, addr, NULL );
+
+  currbank = oric->tele_currbank;
+  if( oric->type == MACH_TELESTRAT )
+    oric->tele_currbank = region;
+  romdis = ( region > 0 );
+  sym = mon_find_sym_by_addr( oric, addr, &romdis );
+  oric->tele_currbank = currbank;
+  return sym;
+}
+
+// Write out each run of addresses with the same flags
+static void coverage_writeregion( struct machine *oric, FILE *f, int region, Uint8 *map, Uint16 base, int len )
+{
+  struct msym *sym;
+  int i, j;
+
+  for( i=0; i<len; i=j )
+  {
+    for( j=i+1; ( j<len ) && ( map[j] == map[i] ); j++ ) ;
+    if( !map[i] ) continue;
+
+    fprintf( f, "%-6s $%04X-$%04X %c%c%c", cov_regionname( oric, region ), base+i, base+j-1,
+      ( map[i] & COV_EXEC ) ? 'x' : '-',
+      ( map[i] & COV_READ ) ? 'r' : '-',
+      ( map[i] & COV_WRITE ) ? 'w' : '-' );
+    if( ( map[i] & COV_EXEC ) && ( ( sym = coverage_sym( oric, region, base+i ) ) ) )
+      fprintf( f, " %s", sym->name );
+    fprintf( f, "\n" );
+  }
+}
+
+/*
+** Write the coverage as text, one line for each run of addresses
+** with the same flags:
+**   rom    $C000-$C00F x-- <symbol at the start, if executed>
+*/
+SDL_bool coverage_save( struct machine *oric, char *fname )
+{
+  FILE *f;
+  int i;
+
+  if( !oric->cov.map ) return SDL_FALSE;
+
+  f = fopen( fname, "w" );
+  if( !f ) return SDL_FALSE;
+
+  fprintf( f, "; Oricutron coverage (x = executed, r = read, w = written)\n" );
+  coverage_writeregion( oric, f, -1, oric->cov.map, 0, COV_RAMSIZE );
+  for( i=0; i<COV_BANKS; i++ )
+    coverage_writeregion( oric, f, i, &oric->cov.map[COV_RAMSIZE+i*0x4000], 0xc000, 0x4000 );
+
+  fclose( f );
+  return SDL_TRUE;
+}
+
+/*
+** Write the raw map, a byte of COV_* flags for each address:
+** $0000-$BFFF for RAM, then $C000-$FFFF for each of the banks.
+*/
+SDL_bool coverage_savemap( struct machine *oric, char *fname )
+{
+  FILE *f;
+  SDL_bool ok;
+
+  if( !oric->cov.map ) return SDL_FALSE;
+
+  f = fopen( fname, "wb" );
+  if( !f ) return SDL_FALSE;
+
+  ok = ( fwrite( oric->cov.map, COV_SIZE, 1, f ) == 1 );
+  fclose( f );
+  return ok;
+}
@@ -0,0 +1,54 @@
+/*
+**  Oricutron
+**  Copyright (C) 2009-2014 Peter Gordon
+**
+**  This program is free software; you can redistribute it and/or
+**  modify it under the terms of the GNU General Public License
+**  as published by the Free Software Foundation, version 2
+**  of the License.
+**
+**  This program is distributed in the hope that it will be useful,
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**  GNU General Public License for more details.
+**
+**  You should have received a copy of the GNU General Public License
+**  along with this program; if not, write to the Free Software
+**  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+**
+**  Code and data coverage
+*/
+#ifndef COVERAGE_H
+#define COVERAGE_H
+
+// A byte of flags for each address. Below $C000 there is only RAM,
+// above it there is a set for each ROM bank: the Telestrat banks,
+// or on the others the ROM, the overlay RAM under ROMDIS and the
+// Microdisc/Jasmin ROM. COV_EXEC is in 6502.h, since the CPU sets it.
+#define COV_READ    0x02
+#define COV_WRITE   0x04
+
+#define COV_ROM     0
+#define COV_OVERLAY 1
+#define COV_DISKROM 2
+
+#define COV_RAMSIZE 0xc000
+#define COV_BANKS   8
+#define COV_SIZE    (COV_RAMSIZE+COV_BANKS*0x4000)
+
+struct coverage
+{
+  Uint8 *map;           // COV_SIZE entries, NULL when off
+  Uint8 *pages[256];    // Where each page of the address space is in map
+};
+
+void coverage_attach( struct machine *oric );
+void coverage_setpages( struct machine *oric );
+SDL_bool coverage_start( struct machine *oric );
+void coverage_stop( struct machine *oric );
+void coverage_reset( struct machine *oric );
+void coverage_show( struct machine *oric );
+SDL_bool coverage_save( struct machine *oric, char *fname );
+SDL_bool coverage_savemap( struct machine *oric, char *fname );
+
+#endif
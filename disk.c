@@ -51,15 +51,8 @@
 extern char diskfile[], diskpath[], filetmp[];
 extern char telediskfile[], telediskpath[];
 extern char pravdiskfile[], pravdiskpath[];
-extern SDL_bool refreshdisks;
 
 #define GENERAL_DISK_DEBUG 0
-#define DEBUG_SECTOR_DUMP  0
-
-#if DEBUG_SECTOR_DUMP
-static char sectordumpstr[64];
-static int sectordumpcount;
-#endif
 
 #ifdef MICRODISC_FUDGE
 void microdisc_setintrq( void *md );
@@ -287,7 +280,7 @@ SDL_bool diskimage_save( struct machine *oric, char *fname, int drive )
   oric->wddisk.disk[drive]->modified_time = 0;
 
   // Remember to update the GUI
-  refreshdisks = SDL_TRUE;
+  oric->refreshdisks = SDL_TRUE;
   return SDL_TRUE;
 }
 
@@ -431,10 +424,114 @@ SDL_bool diskimage_load( struct machine *oric, char *fname, int drive )
   disk_popup( oric, drive );
 
   // Mark the disk status icons as needing a refresh
-  refreshdisks = SDL_TRUE;
+  oric->refreshdisks = SDL_TRUE;
   return SDL_TRUE;
 };
 
+// Write "count" copies of "val" to the raw image
+static Uint8 *diskimage_fill( Uint8 *ptr, Uint8 val, int count )
+{
+  memset( ptr, val, count );
+  return &ptr[count];
+}
+
+// Write an address or data mark, with the three sync bytes
+// before it, and start the CRC off
+static Uint8 *diskimage_mark( Uint8 *ptr, Uint8 mark, Uint16 *crc )
+{
+  int i;
+
+  ptr = diskimage_fill( ptr, 0x00, 12 );
+  *crc = 0xffff;
+  for( i=0; i<3; i++ )
+  {
+    *(ptr++) = 0xa1;
+    *crc = calc_crc( *crc, 0xa1 );
+  }
+  *(ptr++) = mark;
+  *crc = calc_crc( *crc, mark );
+  return ptr;
+}
+
+// Insert a newly formatted MFM disk with 256 byte sectors numbered
+// from 1, as if it had been loaded from "name". Nothing is written
+// to the host unless the disk gets saved.
+SDL_bool diskimage_format( struct machine *oric, int drive, int sides, int tracks, int sectors, char *name )
+{
+  struct diskimage *dimg;
+  Uint8 *ptr, *trk;
+  Uint16 crc;
+  int side, track, sector, i;
+
+  if( ( oric->drivetype == DRV_PRAVETZ ) || ( sides < 1 ) || ( sides > 2 ) ||
+      ( sectors < 1 ) || ( sectors > 17 ) )
+    return SDL_FALSE;
+
+  disk_eject( oric, drive );
+  dimg = oric->wddisk.disk[drive] = diskimage_alloc( 256 + sides*tracks*6400 );
+  if( !dimg )
+  {
+    do_popup( oric, "\x14\x15""Out of memory" );
+    return SDL_FALSE;
+  }
+
+  // Header
+  memset( dimg->rawimage, 0, 256 );
+  memcpy( dimg->rawimage, "MFM_DISK", 8 );
+  dimg->rawimage[8]  = sides;
+  dimg->rawimage[12] = tracks&0xff;
+  dimg->rawimage[13] = tracks>>8;
+  dimg->rawimage[16] = 1;
+
+  for( side=0; side<sides; side++ )
+  {
+    for( track=0; track<tracks; track++ )
+    {
+      trk = ptr = &dimg->rawimage[256+(side*tracks+track)*6400];
+      ptr = diskimage_fill( ptr, 0x4e, 80 );
+
+      for( sector=1; sector<=sectors; sector++ )
+      {
+        ptr = diskimage_mark( ptr, 0xfe, &crc );
+        *(ptr++) = track;
+        *(ptr++) = side;
+        *(ptr++) = sector;
+        *(ptr++) = 1;       // 256 bytes
+        for( i=4; i>0; i-- )
+          crc = calc_crc( crc, ptr[-i] );
+        *(ptr++) = crc>>8;
+        *(ptr++) = crc&0xff;
+        ptr = diskimage_fill( ptr, 0x4e, 22 );
+
+        ptr = diskimage_mark( ptr, 0xfb, &crc );
+        for( i=0; i<256; i++ )
+        {
+          *(ptr++) = i^sector;
+          crc = calc_crc( crc, i^sector );
+        }
+        *(ptr++) = crc>>8;
+        *(ptr++) = crc&0xff;
+        ptr = diskimage_fill( ptr, 0x4e, 40 );
+      }
+
+      diskimage_fill( ptr, 0x4e, 6400-(int)(ptr-trk) );
+    }
+  }
+
+  dimg->drivenum  = drive;
+  dimg->numsides  = sides;
+  dimg->numtracks = tracks;
+  dimg->geometry  = 1;
+  strncpy( dimg->filename, name, 4096+512 );
+  dimg->filename[4096+511] = 0;
+  strncpy( oric->diskname[drive], name, 32 );
+  oric->diskname[drive][31] = 0;
+
+  disk_popup( oric, drive );
+  oric->refreshdisks = SDL_TRUE;
+  return SDL_TRUE;
+}
+
 // This routine does nothing. It is just used as a default for the callback routines
 // and is usually replaced by the microdisc/jasmin/whatever implementations.
 void wd17xx_dummy( void *nothing )
@@ -442,7 +539,7 @@ void wd17xx_dummy( void *nothing )
 }
 
 // Initialise a WD17xx controller instance
-void wd17xx_init( struct wd17xx *wd )
+void wd17xx_init( struct wd17xx *wd, struct machine *oric )
 {
   wd->r_status = 0;
   wd->r_track  = 0;
@@ -464,7 +561,8 @@ void wd17xx_init( struct wd17xx *wd )
   wd->delayeddrq = 0;
   wd->distatus   = -1;
   wd->ddstatus   = -1;
-  refreshdisks = SDL_TRUE;
+  wd->oric     = oric;
+  oric->refreshdisks = SDL_TRUE;
 }
 
 // This routine emulates some cycles of disk activity.
@@ -484,7 +582,7 @@ void wd17xx_ticktock( struct wd17xx *wd, int cycles )
         wd->clrdrq( wd->drqarg );
         wd->setintrq( wd->intrqarg );
         wd->currentop = COP_NUFFINK;
-        refreshdisks = SDL_TRUE;
+        wd->oric->refreshdisks = SDL_TRUE;
 #if GENERAL_DISK_DEBUG
         dbg_printf( "DISK: Sector %d not found.", wd->r_sector );
 #endif
@@ -496,10 +594,10 @@ void wd17xx_ticktock( struct wd17xx *wd, int cycles )
         wd->delayeddrq = 60;
         wd->currentop  = (wd->currentop == COP_READ_SECTORS_FUDGE) ? COP_READ_SECTORS : COP_READ_SECTOR;
         wd->crc        = 0xe295;
-        refreshdisks = SDL_TRUE;
+        wd->oric->refreshdisks = SDL_TRUE;
 #if DEBUG_SECTOR_DUMP
-        sectordumpcount = 0;
-        sectordumpstr[0] = 0;
+        wd->sectordumpcount = 0;
+        wd->sectordumpstr[0] = 0;
 #endif
       }
     }
@@ -561,6 +659,26 @@ void wd17xx_ticktock( struct wd17xx *wd, int cycles )
   }
 }
 
+// Cycles until wd17xx_ticktock next has something to do
+int wd17xx_nextevent( struct wd17xx *wd )
+{
+  int next = CLK_NOEVENT;
+
+#ifdef MICRODISC_FUDGE
+  if ((wd->currentop == COP_READ_SECTORS_FUDGE) ||
+      (wd->currentop == COP_READ_SECTOR_FUDGE))
+    return 1;
+#endif
+
+  if( wd->delayedint > 0 )
+    next = wd->delayedint;
+
+  if( ( wd->delayeddrq > 0 ) && ( wd->delayeddrq < next ) )
+    next = wd->delayeddrq;
+
+  return next;
+}
+
 // This routine seeks to the specified track. It is used by the SEEK and STEP commands.
 void wd17xx_seek_track( struct wd17xx *wd, Uint8 track, SDL_bool dofudge )
 {
@@ -757,7 +875,7 @@ unsigned char wd17xx_read( struct wd17xx *wd, unsigned short addr )
             wd->r_status |= WSF_RNF;
             wd->clrdrq( wd->drqarg );
             wd->currentop = COP_NUFFINK;
-            refreshdisks = SDL_TRUE;
+            wd->oric->refreshdisks = SDL_TRUE;
             break;
           }
 
@@ -773,17 +891,17 @@ unsigned char wd17xx_read( struct wd17xx *wd, unsigned short addr )
           wd->clrdrq( wd->drqarg );
 
 #if DEBUG_SECTOR_DUMP
-          sprintf( &sectordumpstr[sectordumpcount*2], "%02X", wd->r_data );
-          sectordumpstr[34+sectordumpcount] = ((wd->r_data>31)&&(wd->r_data<127)) ? wd->r_data : '.';
-          sectordumpcount++;
-          if( sectordumpcount >= 16 )
+          sprintf( &wd->sectordumpstr[wd->sectordumpcount*2], "%02X", wd->r_data );
+          wd->sectordumpstr[34+wd->sectordumpcount] = ((wd->r_data>31)&&(wd->r_data<127)) ? wd->r_data : '.';
+          wd->sectordumpcount++;
+          if( wd->sectordumpcount >= 16 )
           {
-            sectordumpstr[32] = ' ';
-            sectordumpstr[33] = '\'';
-            sectordumpstr[50] = '\'';
-            sectordumpstr[51] = 0;
-            dbg_printf( "%s", sectordumpstr );
-            sectordumpcount = 0;
+            wd->sectordumpstr[32] = ' ';
+            wd->sectordumpstr[33] = '\'';
+            wd->sectordumpstr[50] = '\'';
+            wd->sectordumpstr[51] = 0;
+            dbg_printf( "%s", wd->sectordumpstr );
+            wd->sectordumpcount = 0;
           }
 #endif
 
@@ -792,15 +910,15 @@ unsigned char wd17xx_read( struct wd17xx *wd, unsigned short addr )
           {
             // If you want to do CRC checking, wd->crc should equal (wd->currsector->data_ptr[wd_curroffs]<<8)|wd->currsector->data_ptr[wd_curroffs+1] right here
 #if DEBUG_SECTOR_DUMP
-            if( sectordumpcount )
+            if( wd->sectordumpcount )
             {
-              sectordumpstr[33] = '\'';
-              sectordumpstr[34+sectordumpcount] = '\'';
-              sectordumpstr[35+sectordumpcount] = 0;
-              for( sectordumpcount*=2; sectordumpcount<33; sectordumpcount++ )
-                sectordumpstr[sectordumpcount*2] = ' ';
-              dbg_printf( "%s", sectordumpstr );
-              sectordumpcount = 0;
+              wd->sectordumpstr[33] = '\'';
+              wd->sectordumpstr[34+wd->sectordumpcount] = '\'';
+              wd->sectordumpstr[35+wd->sectordumpcount] = 0;
+              for( wd->sectordumpcount*=2; wd->sectordumpcount<33; wd->sectordumpcount++ )
+                wd->sectordumpstr[wd->sectordumpcount*2] = ' ';
+              dbg_printf( "%s", wd->sectordumpstr );
+              wd->sectordumpcount = 0;
             }
 #endif
 
@@ -826,7 +944,7 @@ unsigned char wd17xx_read( struct wd17xx *wd, unsigned short addr )
                 wd->currentop = COP_NUFFINK;   // No longer in the middle of an operation
                 wd->r_status &= (~WSF_DRQ);    // Clear DRQ (no data to read)
                 wd->clrdrq( wd->drqarg );
-                refreshdisks = SDL_TRUE;       // Turn off the disk LED in the status bar
+                wd->oric->refreshdisks = SDL_TRUE;       // Turn off the disk LED in the status bar
                 break;
               }
 
@@ -843,7 +961,7 @@ unsigned char wd17xx_read( struct wd17xx *wd, unsigned short addr )
             wd->currentop = COP_NUFFINK;   // Finished the op
             wd->r_status &= (~WSF_DRQ);    // Clear DRQ (no more data)
             wd->clrdrq( wd->drqarg );
-            refreshdisks = SDL_TRUE;       // Turn off disk LED
+            wd->oric->refreshdisks = SDL_TRUE;       // Turn off disk LED
           } else {
             wd->delayeddrq = 32;           // More data ready. DRQ to let them know!
           }
@@ -855,7 +973,7 @@ unsigned char wd17xx_read( struct wd17xx *wd, unsigned short addr )
             wd->r_status &= ~WSF_DRQ;
             wd->clrdrq( wd->drqarg );
             wd->currentop = COP_NUFFINK;
-            refreshdisks = SDL_TRUE;
+            wd->oric->refreshdisks = SDL_TRUE;
             break;
           }
           if( wd->curroffs == 0 ) wd->r_sector = wd->currsector->id_ptr[1];
@@ -867,7 +985,7 @@ unsigned char wd17xx_read( struct wd17xx *wd, unsigned short addr )
             wd->delayedint = 20;
             wd->distatus   = 0;
             wd->currentop = COP_NUFFINK;
-            refreshdisks = SDL_TRUE;
+            wd->oric->refreshdisks = SDL_TRUE;
           } else {
             wd->delayeddrq = 32;
           }
@@ -880,12 +998,12 @@ unsigned char wd17xx_read( struct wd17xx *wd, unsigned short addr )
   return 0; // ??
 }
 
-static SDL_bool last_step_in = SDL_FALSE;
 void wd17xx_write( struct machine *oric, struct wd17xx *wd, unsigned short addr, unsigned char data )
 {
   switch( addr )
   {
     case 0: // Command register
+      oric->stats.count[STAT_WDCMDS]++;
       wd->clrintrq( wd->intrqarg );
       switch( data & 0xe0 )
       {
@@ -900,7 +1018,7 @@ void wd17xx_write( struct machine *oric, struct wd17xx *wd, unsigned short addr,
               if( data & 8 ) wd->r_status |= WSFI_HEADL;
               wd17xx_seek_track( wd, 0, oric->cpu.calcpc == 0xe3a1 );
               wd->currentop = COP_NUFFINK;
-              refreshdisks = SDL_TRUE;
+              oric->refreshdisks = SDL_TRUE;
               break;
             
             case 0x10:  // Seek (Type I)
@@ -911,7 +1029,7 @@ void wd17xx_write( struct machine *oric, struct wd17xx *wd, unsigned short addr,
               if( data & 8 ) wd->r_status |= WSFI_HEADL;
               wd17xx_seek_track( wd, wd->r_data, SDL_FALSE );
               wd->currentop = COP_NUFFINK;
-              refreshdisks = SDL_TRUE;
+              oric->refreshdisks = SDL_TRUE;
               break;
           }
           break;
@@ -922,12 +1040,12 @@ void wd17xx_write( struct machine *oric, struct wd17xx *wd, unsigned short addr,
 #endif
           wd->r_status = WSF_BUSY;
           if( data & 8 ) wd->r_status |= WSFI_HEADL;
-          if( last_step_in )
+          if( wd->last_step_in )
             wd17xx_seek_track( wd, wd->c_track+1, SDL_FALSE );
           else
             wd17xx_seek_track( wd, wd->c_track > 0 ? wd->c_track-1 : 0, SDL_FALSE );
           wd->currentop = COP_NUFFINK;
-          refreshdisks = SDL_TRUE;
+          oric->refreshdisks = SDL_TRUE;
           break;
         
         case 0x40:  // Step-in (Type I)
@@ -937,9 +1055,9 @@ void wd17xx_write( struct machine *oric, struct wd17xx *wd, unsigned short addr,
           wd->r_status = WSF_BUSY;
           if( data & 8 ) wd->r_status |= WSFI_HEADL;
           wd17xx_seek_track( wd, wd->c_track+1, SDL_FALSE );
-          last_step_in = SDL_TRUE;
+          wd->last_step_in = SDL_TRUE;
           wd->currentop = COP_NUFFINK;
-          refreshdisks = SDL_TRUE;
+          oric->refreshdisks = SDL_TRUE;
           break;
         
         case 0x60:  // Step-out (Type I)
@@ -950,9 +1068,9 @@ void wd17xx_write( struct machine *oric, struct wd17xx *wd, unsigned short addr,
           if( data & 8 ) wd->r_status |= WSFI_HEADL;
           if( wd->c_track > 0 )
             wd17xx_seek_track( wd, wd->c_track-1, SDL_FALSE );
-          last_step_in = SDL_FALSE;
+          wd->last_step_in = SDL_FALSE;
           wd->currentop = COP_NUFFINK;
-          refreshdisks = SDL_TRUE;
+          oric->refreshdisks = SDL_TRUE;
           break;
 
         case 0x80:  // Read sector (Type II)
@@ -984,7 +1102,7 @@ void wd17xx_write( struct machine *oric, struct wd17xx *wd, unsigned short addr,
             wd->clrdrq( wd->drqarg );
             wd->setintrq( wd->intrqarg );
             wd->currentop = COP_NUFFINK;
-            refreshdisks = SDL_TRUE;
+            oric->refreshdisks = SDL_TRUE;
 #if GENERAL_DISK_DEBUG
             dbg_printf( "DISK: Sector %d not found.", wd->r_sector );
 #endif
@@ -997,10 +1115,10 @@ void wd17xx_write( struct machine *oric, struct wd17xx *wd, unsigned short addr,
           wd->delayeddrq = 60;
           wd->currentop  = (data&0x10) ? COP_READ_SECTORS : COP_READ_SECTOR;
           wd->crc        = 0xe295;
-          refreshdisks = SDL_TRUE;
+          oric->refreshdisks = SDL_TRUE;
 #if DEBUG_SECTOR_DUMP
-          sectordumpcount = 0;
-          sectordumpstr[0] = 0;
+          wd->sectordumpcount = 0;
+          wd->sectordumpstr[0] = 0;
 #endif
           break;
         
@@ -1025,7 +1143,7 @@ void wd17xx_write( struct machine *oric, struct wd17xx *wd, unsigned short addr,
             wd->clrdrq( wd->drqarg );
             wd->setintrq( wd->intrqarg );
             wd->currentop = COP_NUFFINK;
-            refreshdisks = SDL_TRUE;
+            oric->refreshdisks = SDL_TRUE;
 #if GENERAL_DISK_DEBUG
             dbg_printf( "DISK: Sector %d not found.", wd->r_sector );
 #endif
@@ -1038,7 +1156,7 @@ void wd17xx_write( struct machine *oric, struct wd17xx *wd, unsigned short addr,
           wd->delayeddrq = 500;
           wd->currentop  = (data&0x10) ? COP_WRITE_SECTORS : COP_WRITE_SECTOR;
           wd->crc        = 0xe295;
-          refreshdisks = SDL_TRUE;
+          oric->refreshdisks = SDL_TRUE;
           break;
         
         case 0xc0:  // Read address / Force IRQ
@@ -1060,7 +1178,7 @@ void wd17xx_write( struct machine *oric, struct wd17xx *wd, unsigned short addr,
                 wd->clrdrq( wd->drqarg );
                 wd->currentop = COP_NUFFINK;
                 wd->setintrq( wd->intrqarg );
-                refreshdisks = SDL_TRUE;
+                oric->refreshdisks = SDL_TRUE;
 #if GENERAL_DISK_DEBUG
                 dbg_printf( "DISK: No sectors on this track?" );
 #endif
@@ -1079,7 +1197,7 @@ void wd17xx_write( struct machine *oric, struct wd17xx *wd, unsigned short addr,
               wd->r_status = WSF_NOTREADY|WSF_BUSY|WSF_DRQ;
               wd->setdrq( wd->drqarg );
               wd->currentop = COP_READ_ADDRESS;
-              refreshdisks = SDL_TRUE;
+              oric->refreshdisks = SDL_TRUE;
               break;
             
             case 0x10: // Force Interrupt (Type IV)
@@ -1092,7 +1210,7 @@ void wd17xx_write( struct machine *oric, struct wd17xx *wd, unsigned short addr,
               wd->delayedint = 0;
               wd->delayeddrq = 0;
               wd->currentop = COP_NUFFINK;
-              refreshdisks = SDL_TRUE;
+              oric->refreshdisks = SDL_TRUE;
               break;
           }
           break;
@@ -1105,7 +1223,7 @@ void wd17xx_write( struct machine *oric, struct wd17xx *wd, unsigned short addr,
               dbg_printf( "DISK: (%04X) Read track", oric->cpu.pc-1 );
 #endif
               wd->currentop = COP_READ_TRACK;
-              refreshdisks = SDL_TRUE;
+              oric->refreshdisks = SDL_TRUE;
               break;
             
             case 0x10: // Write track (Type III)
@@ -1113,7 +1231,7 @@ void wd17xx_write( struct machine *oric, struct wd17xx *wd, unsigned short addr,
               dbg_printf( "DISK: (%04X) Write track", oric->cpu.pc-1 );
 #endif
               wd->currentop = COP_WRITE_TRACK;
-              refreshdisks = SDL_TRUE;
+              oric->refreshdisks = SDL_TRUE;
               break;
           }
           break;
@@ -1141,13 +1259,13 @@ void wd17xx_write( struct machine *oric, struct wd17xx *wd, unsigned short addr,
             wd->r_status |= WSF_RNF;
             wd->clrdrq( wd->drqarg );
             wd->currentop = COP_NUFFINK;
-            refreshdisks = SDL_TRUE;
+            oric->refreshdisks = SDL_TRUE;
             break;
           }
           if( wd->curroffs == 0 ) wd->currsector->data_ptr[wd->curroffs++]=0xfb;
           wd->currsector->data_ptr[wd->curroffs++] = wd->r_data;
           wd->crc = calc_crc( wd->crc, wd->r_data );
-          if( !wd->disk[wd->c_drive]->modified ) refreshdisks = SDL_TRUE;
+          if( !wd->disk[wd->c_drive]->modified ) oric->refreshdisks = SDL_TRUE;
           wd->disk[wd->c_drive]->modified = SDL_TRUE;
           wd->disk[wd->c_drive]->modified_time = 0;
           wd->r_status &= ~WSF_DRQ;
@@ -1175,7 +1293,7 @@ void wd17xx_write( struct machine *oric, struct wd17xx *wd, unsigned short addr,
                 wd->currentop = COP_NUFFINK;
                 wd->r_status &= (~WSF_DRQ);
                 wd->clrdrq( wd->drqarg );
-                refreshdisks = SDL_TRUE;
+                oric->refreshdisks = SDL_TRUE;
                 break;
               }
               wd->delayeddrq = 180;
@@ -1187,7 +1305,7 @@ void wd17xx_write( struct machine *oric, struct wd17xx *wd, unsigned short addr,
             wd->currentop = COP_NUFFINK;
             wd->r_status &= (~WSF_DRQ);
             wd->clrdrq( wd->drqarg );
-            refreshdisks = SDL_TRUE;
+            oric->refreshdisks = SDL_TRUE;
           } else {
             wd->delayeddrq = 32;
           }
@@ -1228,7 +1346,7 @@ void microdisc_clrintrq( void *md )
 
 void microdisc_init( struct microdisc *md, struct wd17xx *wd, struct machine *oric )
 {
-  wd17xx_init( wd );
+  wd17xx_init( wd, oric );
   wd->setintrq = microdisc_setintrq;
   wd->clrintrq = microdisc_clrintrq;
   wd->intrqarg = (void*)md;
@@ -1298,6 +1416,7 @@ void microdisc_write( struct microdisc *md, unsigned short addr, unsigned char d
       md->wd->c_side   = (data&MDSF_SIDE) ? 1 : 0;
       md->oric->romdis = (data&MDSF_ROMDIS) ? SDL_FALSE : SDL_TRUE;
       md->diskrom      = (data&MDSF_EPROM) ? SDL_FALSE : SDL_TRUE;
+      setmemmap( md->oric );
       break;
 
     case 0x318:
@@ -1332,7 +1451,7 @@ void jasmin_clrintrq( void *j )
 
 void jasmin_init( struct jasmin *j, struct wd17xx *wd, struct machine *oric )
 {
-  wd17xx_init( wd );
+  wd17xx_init( wd, oric );
   wd->setintrq = jasmin_setintrq;
   wd->clrintrq = jasmin_clrintrq;
   wd->intrqarg = (void*)j;
@@ -1405,11 +1524,13 @@ void jasmin_write( struct jasmin *j, unsigned short addr, unsigned char data )
     
     case 0x3fa: // overlay RAM
       j->olay = data&1;
+      setmemmap( j->oric );
       break;
     
     case 0x3fb: // romdis
       j->romdis = data&1;
       j->oric->romdis = (data!=0) ? SDL_TRUE : SDL_FALSE;
+      setmemmap( j->oric );
       break;
     
     case 0x3fc: // Drive 0
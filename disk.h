@@ -19,6 +19,8 @@
 **  WD17xx, Microdisc and Jasmin emulation
 */
 
+#define DEBUG_SECTOR_DUMP  0
+
 /******************** MICRODISC *********************/
 #define MAX_DRIVES 4
 
@@ -156,6 +158,11 @@ struct wd17xx
   int               distatus;          // The new contents for r_status when delayedint expires (or -1 to leave it untouched)
   int               ddstatus;          // The new contents for r_status when delayeddrq expires (or -1 to leave it untouched)
   Uint16            crc;
+  struct machine   *oric;              // Pointer to the Oric structure
+#if DEBUG_SECTOR_DUMP
+  char              sectordumpstr[64]; // Hex/ASCII line being built for the sector dump
+  int               sectordumpcount;   // Bytes in the above line so far
+#endif
 };
 
 // Current state of the Microdisc hardware
@@ -193,6 +200,8 @@ struct pravetz_drive
   SDL_bool dirty;
   struct diskimage *pimg;
   SDL_bool prot;
+  Uint8    rawcheck;           // Address field checksum while encoding a sector
+  Uint8    raweor;             // Running data checksum while encoding a sector
 };
 
 struct pravetz
@@ -207,11 +216,16 @@ struct pravetz
 // Functions to read/write diskimages
 SDL_bool diskimage_load( struct machine *oric, char *fname, int drive ); 
 SDL_bool diskimage_save( struct machine *oric, char *fname, int drive );
+void disk_eject( struct machine *oric, int drive );
+SDL_bool diskimage_format( struct machine *oric, int drive, int sides, int tracks, int sectors, char *name );
 void diskimage_cachetrack( struct diskimage *dimg, int track, int side );
 struct mfmsector *wd17xx_find_sector( struct wd17xx *wd, Uint8 secid );
 
+void wd17xx_init( struct wd17xx *wd, struct machine *oric );
+
 // Call this to emulate some cycles of disk activity
 void wd17xx_ticktock( struct wd17xx *wd, int cycles );
+int wd17xx_nextevent( struct wd17xx *wd );
 
 // Microdisc interface
 void microdisc_init( struct microdisc *md, struct wd17xx *wd, struct machine *oric );
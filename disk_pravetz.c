@@ -115,10 +115,8 @@ Uint8  disk_pravetz_image_raw_byte(struct machine *oric, int drive,  Uint16 t_id
 {
     long  f_pos;
 
-    static Uint8  old;
-    static Uint8  eor;
-    static Uint8  raw;
-    static Uint8  check;
+    Uint8  old;
+    Uint8  raw;
 
     struct pravetz_drive *drv = &oric->pravetz.drv[drive];
 
@@ -156,7 +154,7 @@ Uint8  disk_pravetz_image_raw_byte(struct machine *oric, int drive,  Uint16 t_id
 
     case 9:
         /* volume byte #1 */
-        check = drv->volume;
+        drv->rawcheck = drv->volume;
         return 0xAA | (drv->volume >> 1);
 
     case 10:
@@ -165,7 +163,7 @@ Uint8  disk_pravetz_image_raw_byte(struct machine *oric, int drive,  Uint16 t_id
 
     case 11:
         /* track byte #1 */
-        check ^= t_idx;
+        drv->rawcheck ^= t_idx;
         return 0xAA | (t_idx >> 1);
 
     case 12:
@@ -174,7 +172,7 @@ Uint8  disk_pravetz_image_raw_byte(struct machine *oric, int drive,  Uint16 t_id
 
     case 13:
         /* sector byte #1 */
-        check ^= s_idx;
+        drv->rawcheck ^= s_idx;
         return 0xAA | (s_idx >> 1);
 
     case 14:
@@ -183,11 +181,11 @@ Uint8  disk_pravetz_image_raw_byte(struct machine *oric, int drive,  Uint16 t_id
 
     case 15:
         /* checksum byte #1 */
-        return 0xAA | (check >> 1);
+        return 0xAA | (drv->rawcheck >> 1);
 
     case 16:
         /* checksum byte #2 */
-        return 0xAA | check;
+        return 0xAA | drv->rawcheck;
 
     case 17:
     case 371:
@@ -206,7 +204,7 @@ Uint8  disk_pravetz_image_raw_byte(struct machine *oric, int drive,  Uint16 t_id
 
     case 27:
         /* data header */
-        eor = 0;
+        drv->raweor = 0;
 
         /* Read the coming sector */
         f_pos = (256 * 16 * t_idx) + (256 * skewing[s_idx]);
@@ -218,7 +216,7 @@ Uint8  disk_pravetz_image_raw_byte(struct machine *oric, int drive,  Uint16 t_id
 
     case 370:
         /* checksum */
-        return translate[eor & 0x3F];
+        return translate[drv->raweor & 0x3F];
 
     default:
         b_idx -= 28;
@@ -228,9 +226,9 @@ Uint8  disk_pravetz_image_raw_byte(struct machine *oric, int drive,  Uint16 t_id
             /* 6 Bit */
             old  = drv->sector_ptr[b_idx - 0x56];
             old  = old >> 2;
-            eor ^= old;
-            raw  = translate[eor & 0x3F];
-            eor  = old;
+            drv->raweor ^= old;
+            raw  = translate[drv->raweor & 0x3F];
+            drv->raweor  = old;
         }
         else
         {
@@ -241,9 +239,9 @@ Uint8  disk_pravetz_image_raw_byte(struct machine *oric, int drive,  Uint16 t_id
             old |= (drv->sector_ptr[b_idx + 0x56] & 0x02) << 1;
             old |= (drv->sector_ptr[b_idx + 0xAC] & 0x01) << 5;
             old |= (drv->sector_ptr[b_idx + 0xAC] & 0x02) << 3;
-            eor ^= old;
-            raw  = translate[eor & 0x3F];
-            eor  = old;
+            drv->raweor ^= old;
+            raw  = translate[drv->raweor & 0x3F];
+            drv->raweor  = old;
         }
         break;
     }
@@ -35,6 +35,7 @@
 #include "monitor.h"
 #include "6551.h"
 #include "machine.h"
+#include "render_sw.h"
 #include "filereq.h"
 
 // Externs
@@ -337,6 +338,7 @@ SDL_bool filerequester( struct machine *oric, char *title, char *path, char *fna
       SDL_COMPAT_EnableKeyRepeat( wasunicode ? SDL_DEFAULT_REPEAT_DELAY : 0, wasunicode ? SDL_DEFAULT_REPEAT_INTERVAL : 0 );
       return SDL_FALSE;
     }
+    render_sw_mapmouse( &event );
 
     mx = -1;
     my = -1;
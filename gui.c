@@ -83,9 +83,6 @@ char snappath[4096], snapfile[512];
 char mappingpath[4096], mappingfile[512];
 char filetmp[4096+512];
 
-SDL_bool refreshstatus = SDL_TRUE, refreshdisks = SDL_TRUE, refreshavi = SDL_TRUE, refreshtape = SDL_TRUE,
-    refreshkeyboard = SDL_TRUE;
-extern struct avi_handle *vidcap;
 
 extern SDL_bool need_sdl_quit;
 extern SDL_AudioSpec obtained;
@@ -113,7 +110,7 @@ struct guiimg gimgs[NUM_GIMG]  = { { IMAGEPREFIX"statusbar.bmp",              64
                                    { IMAGEPREFIX"gfx_atmoskbd.bmp",   640, 240, NULL },
                                    { IMAGEPREFIX"gfx_pravetzkbd.bmp", 640, 240, NULL }};
 
-SDL_bool soundavailable, soundon;
+SDL_bool soundavailable;
 #if defined(__linux__)
 Sint16 soundsilence = 0;
 #else
@@ -147,7 +144,6 @@ char vsptmp[VSPTMPSIZE];
 
 // FPS calculation vars
 extern Uint32 frametimeave;
-SDL_bool warpspeed=SDL_FALSE;
 
 // Current menu, and highlighted item number
 struct osdmenu *cmenu = NULL;
@@ -530,40 +526,42 @@ void do_popup( struct machine *oric, char *str )
 
 void render_status( struct machine *oric )
 {
-  if( refreshstatus )
+  if( oric->refreshstatus )
     draw_statusbar( oric );
 
-  if( refreshdisks || refreshstatus )
+  if( oric->refreshdisks || oric->refreshstatus )
   {
     draw_disks( oric );
-    refreshdisks = SDL_FALSE;
+    oric->refreshdisks = SDL_FALSE;
   }
 
-  if( refreshavi || refreshstatus )
+  if( oric->refreshavi || oric->refreshstatus )
   {
-    draw_avirec( oric, vidcap != NULL );
-    refreshavi = SDL_FALSE;
+    draw_avirec( oric, oric->vidcap != NULL );
+    oric->refreshavi = SDL_FALSE;
   }
 
-  if( refreshtape || refreshstatus )
+  if( oric->refreshtape || oric->refreshstatus )
   {
     draw_tape( oric );
-    refreshtape = SDL_FALSE;
+    oric->refreshtape = SDL_FALSE;
   }
 
-    if(refreshkeyboard  || refreshstatus) {
+    if(oric->refreshkeyboard  || oric->refreshstatus) {
         draw_keyboard( oric );
-        refreshkeyboard = SDL_FALSE;
+        oric->refreshkeyboard = SDL_FALSE;
     }
 
-  refreshstatus = SDL_FALSE;
+  oric->refreshstatus = SDL_FALSE;
 }
 
 // Top-level rendering routine
 void render( struct machine *oric )
 {
   int perc, fps; //, i;
+  Uint64 start, t;
 
+  start = stats_start( &oric->stats );
   if( oric->emu_mode == EM_DEBUG )
     mon_update( oric );
 
@@ -582,11 +580,11 @@ void render( struct machine *oric )
       render_status( oric );
       if( oric->statusbar_mode == STATUSBARMODE_FULL )
       {
-        fps = 100000/(frametimeave?frametimeave:1);
+        fps = 100000000/(frametimeave?frametimeave:1);
         if( oric->vid_freq )
-          perc = 200000/(frametimeave?frametimeave:1);
+          perc = 200000000/(frametimeave?frametimeave:1);
         else
-          perc = 166667/(frametimeave?frametimeave:1);
+          perc = 166666667/(frametimeave?frametimeave:1);
         sprintf( oric->statusstr, "%4d.%02d%% - %4dFPS", perc/100, perc%100, fps/100 );
         oric->newstatusstr = SDL_TRUE;
       }
@@ -606,7 +604,10 @@ void render( struct machine *oric )
       break;
   }
 
+  t = stats_start( &oric->stats );
   oric->render_end( oric );
+  stats_stop( &oric->stats, STIME_PRESENT, t );
+  stats_stop( &oric->stats, STIME_RENDER, start );
 }
 
 // Draws a box in a textzone (uses the box chars in the font)
@@ -873,36 +874,42 @@ void drawitems( void )
 
 
 /***************** These functions can be used directly from the menu system ***************/
-void joinpath( char *path, char *file )
+// Join a path and filename into dest, which must hold 4096+512 chars
+void joinpathto( char *dest, char *path, char *file )
 {
 #if defined(__amigaos4__)
-  strcpy( filetmp, path );
-  IDOS->AddPart( filetmp, file, 4096 );
+  strcpy( dest, path );
+  IDOS->AddPart( dest, file, 4096 );
 #elif defined(WIN32)
   int i;
-  strncpy( filetmp, path, 4096 ); filetmp[4095] = 0;
-  i = strlen( filetmp );
-  if( ( i > 0 ) && ( filetmp[i-1] != PATHSEP ) && ( filetmp[i-1] != ':' ) )
+  strncpy( dest, path, 4096 ); dest[4095] = 0;
+  i = strlen( dest );
+  if( ( i > 0 ) && ( dest[i-1] != PATHSEP ) && ( dest[i-1] != ':' ) )
   {
-    filetmp[i++] = PATHSEP;
-    filetmp[i++] = 0;
+    dest[i++] = PATHSEP;
+    dest[i++] = 0;
   }
-  strncat( filetmp, file, 4096+512 );
-  filetmp[4096+511] = 0;
+  strncat( dest, file, 4096+512 );
+  dest[4096+511] = 0;
 #else
   int i;
-  strncpy( filetmp, path, 4096 ); filetmp[4095] = 0;
-  i = (int)strlen( filetmp );
-  if( ( i > 0 ) && ( filetmp[i-1] != PATHSEP ) )
+  strncpy( dest, path, 4096 ); dest[4095] = 0;
+  i = (int)strlen( dest );
+  if( ( i > 0 ) && ( dest[i-1] != PATHSEP ) )
   {
-    filetmp[i++] = PATHSEP;
-    filetmp[i++] = 0;
+    dest[i++] = PATHSEP;
+    dest[i++] = 0;
   }
-  strncat( filetmp, file, 4096+512 );
-  filetmp[4096+511] = 0;
+  strncat( dest, file, 4096+512 );
+  dest[4096+511] = 0;
 #endif
 }
 
+void joinpath( char *path, char *file )
+{
+  joinpathto( filetmp, path, file );
+}
+
 // "insert" a tape into the virtual tape drive, via filerequester
 void inserttape( struct machine *oric, struct osdmenuitem *mitem, int dummy )
 {
@@ -1041,7 +1048,7 @@ void inserttape( struct machine *oric, struct osdmenuitem *mitem, int dummy )
           swapmach( oric, NULL, (DRV_PRAVETZ<<16)|MACH_PRAVETZ );
           joinpath( tapepath, tapefile );
           diskimage_load( oric, filetmp, 0 );
-          queuekeys("CALL#320\x0d");
+          queuekeys( &oric->ay, "CALL#320\x0d" );
         }
         setemumode( oric, NULL, EM_RUNNING );
         return;
@@ -1056,7 +1063,7 @@ void inserttape( struct machine *oric, struct osdmenuitem *mitem, int dummy )
           swapmach( oric, NULL, (DRV_PRAVETZ<<16)|MACH_PRAVETZ );
           joinpath( tapepath, tapefile );
           diskimage_load( oric, filetmp, 0 );
-          queuekeys("CALL#320\x0d");
+          queuekeys( &oric->ay, "CALL#320\x0d" );
         }
         setemumode( oric, NULL, EM_RUNNING );
         return;
@@ -1226,7 +1233,7 @@ void insertdisk( struct machine *oric, struct osdmenuitem *mitem, int drive )
           "Would you like to switch to that configuration?"))
         {
           swapmach( oric, NULL, (DRV_PRAVETZ<<16)|MACH_PRAVETZ );
-          queuekeys("CALL#320\x0d");
+          queuekeys( &oric->ay, "CALL#320\x0d" );
         }
         break;
       }
@@ -1234,7 +1241,7 @@ void insertdisk( struct machine *oric, struct osdmenuitem *mitem, int drive )
       if (oric->drivetype == DRV_NONE)
       {
         swapmach( oric, NULL, (DRV_PRAVETZ<<16)|MACH_PRAVETZ );
-        queuekeys("CALL#320\x0d");
+        queuekeys( &oric->ay, "CALL#320\x0d" );
         break;
       }
 
@@ -1245,7 +1252,7 @@ void insertdisk( struct machine *oric, struct osdmenuitem *mitem, int drive )
           "Would you like to switch to that configuration?"))
         {
           swapmach( oric, NULL, (DRV_PRAVETZ<<16)|MACH_PRAVETZ );
-          queuekeys("CALL#320\x0d");
+          queuekeys( &oric->ay, "CALL#320\x0d" );
         }
         break;
       }
@@ -1386,19 +1393,19 @@ void toggletapenoise( struct machine *oric, struct osdmenuitem *mitem, int dummy
 // Toggle sound on/off
 void togglesound( struct machine *oric, struct osdmenuitem *mitem, int dummy )
 {
-  if( ( soundon ) || (!soundavailable) )
+  if( ( oric->soundon ) || (!soundavailable) )
   {
-    soundon = SDL_FALSE;
+    oric->soundon = SDL_FALSE;
     oric->ay.soundon = SDL_FALSE;
     mitem->name = " Sound enabled";
     if( soundavailable ) SDL_PauseAudio( 1 );
     return;
   }
 
-  soundon = SDL_TRUE;
-  oric->ay.soundon = !warpspeed;
+  oric->soundon = SDL_TRUE;
+  oric->ay.soundon = !oric->warpspeed;
   mitem->name = "\x0e""Sound enabled";
-  if( oric->emu_mode == EM_RUNNING ) SDL_PauseAudio( !warpspeed );
+  if( oric->emu_mode == EM_RUNNING ) SDL_PauseAudio( !oric->warpspeed );
 }
 
 // Toggle turbotape on/off
@@ -1721,7 +1728,7 @@ void togglestickykeys( struct machine *oric, struct osdmenuitem *mitem, int dumm
     {
         oric->sticky_mod_keys = SDL_FALSE;
         mitem->name = " Sticky mod keys";
-        release_sticky_keys();
+        release_sticky_keys( oric );
         return;
     }
 
@@ -2159,7 +2166,7 @@ void setmenutoggles( struct machine *oric )
       break;
   }
 
-  if( soundavailable && soundon )
+  if( soundavailable && oric->soundon )
     find_item_by_function(auopitems, togglesound)->name = "\x0e""Sound enabled";
   else
     find_item_by_function(auopitems, togglesound)->name = " Sound enabled";
@@ -2292,6 +2299,16 @@ SDL_bool init_gui( struct machine *oric, Sint32 rendermode )
   if( !alloc_textzone( oric, TZ_AY,       400, 228, 30, 21, "AY Status"            ) ) return SDL_FALSE;
   if( !alloc_textzone( oric, TZ_DISK,     400, 228, 30, 21, "Disk Status"          ) ) return SDL_FALSE;
 
+  soundavailable = SDL_FALSE;
+  oric->soundon = SDL_FALSE;
+
+  // No audio device or native GUI hooks without a window
+  if( oric->headless )
+  {
+    setmenutoggles( oric );
+    return SDL_TRUE;
+  }
+
   // Set up SDL audio
   wanted.freq     = AUDIO_FREQ;
   wanted.format   = AUDIO_S16SYS;
@@ -2301,11 +2318,9 @@ SDL_bool init_gui( struct machine *oric, Sint32 rendermode )
   wanted.callback = (void*)ay_callback;
   wanted.userdata = &oric->ay;
 
-  soundavailable = SDL_FALSE;
-  soundon = SDL_FALSE;
   if( SDL_OpenAudio( &wanted, &obtained ) >= 0 )
   {
-    soundon = SDL_TRUE;
+    oric->soundon = SDL_TRUE;
     soundavailable = SDL_TRUE;
     soundsilence = obtained.silence * 8192;
     cyclespersample = ((CYCLESPERSECOND<<FPBITS)/obtained.freq);
@@ -2332,6 +2347,9 @@ void shut_gui( struct machine *oric )
   for( i=0; i<NUM_TZ; i++ )
     free_textzone( oric, i );
 
+  // init_gui skips the native hooks when headless
+  if( oric->headless ) return;
+
 #if defined(__APPLE__) || defined(__BEOS__) || defined(__HAIKU__)
     shut_gui_native( oric );
 #elif defined(__WIN32__) || defined(__CYGWIN__)
@@ -153,6 +153,7 @@ void draw_keyboard( struct machine *oric );
 
 
 void statusprintstr( int x, Uint32 fc, char *str );
+void joinpathto( char *dest, char *path, char *file );
 void joinpath( char *path, char *file );
 
 /* implemented by OS-specific backends */
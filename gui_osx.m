@@ -145,7 +145,7 @@ SDL_bool clipboard_paste( struct machine *oric )
 	for (NSString *t in copiedItems) {
 		t = [t stringByReplacingOccurrencesOfString: @"\n" withString: @"\r"];
 		t = [t stringByReplacingOccurrencesOfString: @"\t" withString: @" "];
-		queuekeys( (char *)[t UTF8String] );
+		queuekeys( &oric->ay, (char *)[t UTF8String] );
 	}
 #endif
 
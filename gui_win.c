@@ -174,7 +174,7 @@ SDL_bool clipboard_paste( struct machine *oric )
       }
       p++;
     }
-    queuekeys(text);
+    queuekeys( &oric->ay, text );
   }
   return SDL_TRUE;
 }
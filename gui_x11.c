@@ -328,7 +328,7 @@ SDL_bool clipboard_paste( struct machine *oric )
       }
       p++;
     }
-    queuekeys(text);
+    queuekeys( &oric->ay, text );
     free(text);
   }
   return SDL_TRUE;
@@ -0,0 +1,327 @@
+/*
+**  Oricutron
+**  Copyright (C) 2009-2014 Peter Gordon
+**
+**  This program is free software; you can redistribute it and/or
+**  modify it under the terms of the GNU General Public License
+**  as published by the Free Software Foundation, version 2
+**  of the License.
+**
+**  This program is distributed in the hope that it will be useful,
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**  GNU General Public License for more details.
+**
+**  You should have received a copy of the GNU General Public License
+**  along with this program; if not, write to the Free Software
+**  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+**
+**  Headless batch running
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "system.h"
+#include "6502.h"
+#include "via.h"
+#include "8912.h"
+#include "gui.h"
+#include "disk.h"
+#include "monitor.h"
+#include "6551.h"
+#include "machine.h"
+#include "ula.h"
+#include "tape.h"
+#include "snapshot.h"
+#include "headless.h"
+
+extern Uint8 oricpalette[];
+
+static char *reasons[] = { "none", "pc", "mem", "text", "cycles", "frames", "break", "jam" };
+
+void headless_defaults( struct headless *hl )
+{
+  hl->maxcycles = 0;
+  hl->maxframes = 0;
+  hl->pc        = -1;
+  hl->memaddr   = -1;
+  hl->memval    = 0;
+  hl->text[0]   = 0;
+  strcpy( hl->dumpname, "oricutron_exit" );
+  hl->timed     = SDL_FALSE;
+
+  hl->reason = HLEXIT_NONE;
+  hl->cycles = 0;
+  hl->frames = 0;
+  hl->bpmsg[0] = 0;
+}
+
+/*
+** Make a new machine from proto, which has been through the
+** config and options but not init_machine. The caller has to
+** make sure nothing else is setting up or freeing a machine at
+** the same time, since that touches the shared ROMs and menus.
+*/
+struct machine *headless_newmachine( struct machine *proto, int type, int drivetype )
+{
+  struct machine *oric;
+
+  oric = malloc( sizeof( struct machine ) );
+  if( !oric ) return NULL;
+
+  *oric = *proto;
+  oric->drivetype = drivetype;
+  if( !m6502_unshare( &oric->cpu ) )
+  {
+    free( oric );
+    return NULL;
+  }
+  if( ( !init_ula( oric ) ) || ( !init_machine( oric, type, SDL_TRUE ) ) )
+  {
+    headless_freemachine( oric );
+    return NULL;
+  }
+
+  return oric;
+}
+
+// Same rules as headless_newmachine
+void headless_freemachine( struct machine *oric )
+{
+  int i;
+
+  for( i=0; i<MAX_DRIVES; i++ )
+    disk_eject( oric, i );
+  tape_eject( oric );
+  if( oric->ay.keyqueue ) free( oric->ay.keyqueue );
+  oric->ay.keyqueue = NULL;
+  shut_machine( oric );
+  shut_ula( oric );
+  m6502_free( &oric->cpu );
+  free( oric );
+}
+
+// Without one of these, a run might never end
+SDL_bool headless_hascondition( struct headless *hl )
+{
+  return ( hl->maxcycles != 0 ) || ( hl->maxframes != 0 ) ||
+         ( hl->pc != -1 ) || ( hl->memaddr != -1 ) || ( hl->text[0] != 0 );
+}
+
+char *headless_reason( int reason )
+{
+  if( ( reason < 0 ) || ( reason > HLEXIT_JAM ) ) return "?";
+  return reasons[reason];
+}
+
+// Read the byte the CPU would see, without side effects (so not the I/O page)
+static int headless_peek( struct machine *oric, Uint16 addr )
+{
+  Uint8 *page = oric->mapread[addr>>8];
+
+  if( !page ) return -1;
+  return page[addr&0xff];
+}
+
+// Decode the text the ULA is showing. In HIRES mode only the
+// bottom three lines are text, the rest comes back as spaces.
+// Serial attributes come back as spaces too.
+void headless_screentext( struct machine *oric, char text[28][41] )
+{
+  int x, y;
+  Uint8 c;
+
+  for( y=0; y<28; y++ )
+  {
+    for( x=0; x<40; x++ )
+    {
+      c = ' ';
+      if( ( y >= 25 ) || ( !( oric->vid_mode & 0x04 ) ) )
+      {
+        c = oric->mem[oric->vidbases[2] + y*40 + x] & 0x7f;
+        if( ( c & 0x60 ) == 0 ) c = ' ';
+      }
+      text[y][x] = c;
+    }
+    text[y][40] = 0;
+  }
+}
+
+// FNV-1a over the ULA output, so runs can be compared without the images
+Uint32 headless_screenhash( struct machine *oric )
+{
+  Uint32 hash = 2166136261u;
+  int i;
+
+  for( i=0; i<240*224; i++ )
+  {
+    hash ^= oric->scr[i];
+    hash *= 16777619u;
+  }
+  return hash;
+}
+
+static SDL_bool headless_findtext( struct machine *oric, char *str )
+{
+  char text[28][41];
+  int y;
+
+  headless_screentext( oric, text );
+  for( y=0; y<28; y++ )
+  {
+    if( strstr( text[y], str ) ) return SDL_TRUE;
+  }
+  return SDL_FALSE;
+}
+
+/*
+** Run the machine flat out until one of the exit conditions
+** in hl is met. This is frameloop_normal without the frame
+** pacing, rendering or events. The memory condition is looked
+** at after every raster line, the screen text after every frame.
+*/
+int headless_run( struct machine *oric, struct headless *hl )
+{
+  Uint32 lastcycles;
+  Uint64 t = 0;
+  SDL_bool newframe;
+  int ret;
+
+  hl->reason   = HLEXIT_NONE;
+  hl->cycles   = 0;
+  hl->frames   = 0;
+  hl->cpu_us   = 0;
+  hl->video_us = 0;
+
+  if( hl->pc != -1 )
+    m6502_addbp( &oric->cpu, hl->pc, BPBANK_ANY );
+
+  machine_sync( oric );
+  m6502_idlereset( &oric->cpu );
+  lastcycles = oric->cpu.cycles;
+
+  while( hl->reason == HLEXIT_NONE )
+  {
+    if( hl->timed ) t = SDL_COMPAT_GetTicksUS();
+    ret = m6502_run( &oric->cpu, SDL_TRUE, hl->bpmsg );
+    if( hl->timed ) hl->cpu_us += SDL_COMPAT_GetTicksUS() - t;
+
+    switch( ret )
+    {
+      case M6502_RUN_BREAK:
+        hl->reason = ( oric->cpu.calcpc == hl->pc ) ? HLEXIT_PC : HLEXIT_BREAK;
+        break;
+
+      case M6502_RUN_JAM:
+        hl->reason = HLEXIT_JAM;
+        break;
+    }
+
+    hl->cycles += (Uint32)( oric->cpu.cycles - lastcycles );
+    lastcycles = oric->cpu.cycles;
+
+    if( oric->cpu.rastercycles <= 0 )
+    {
+      if( hl->timed ) t = SDL_COMPAT_GetTicksUS();
+      newframe = ula_doraster( oric );
+      if( hl->timed ) hl->video_us += SDL_COMPAT_GetTicksUS() - t;
+
+      if( newframe )
+      {
+        hl->frames++;
+        stats_endframe( oric );
+        trace_sync( oric );
+        machine_sync( oric );
+        m6502_idlereset( &oric->cpu );
+
+        if( ( hl->reason == HLEXIT_NONE ) && ( hl->text[0] ) && ( headless_findtext( oric, hl->text ) ) )
+          hl->reason = HLEXIT_TEXT;
+        if( ( hl->reason == HLEXIT_NONE ) && ( hl->maxframes ) && ( hl->frames >= hl->maxframes ) )
+          hl->reason = HLEXIT_FRAMES;
+      }
+      oric->cpu.rastercycles += oric->cyclesperraster;
+    }
+
+    if( hl->reason != HLEXIT_NONE ) break;
+
+    if( ( hl->memaddr != -1 ) && ( headless_peek( oric, hl->memaddr ) == hl->memval ) )
+      hl->reason = HLEXIT_MEM;
+    else if( ( hl->maxcycles ) && ( hl->cycles >= hl->maxcycles ) )
+      hl->reason = HLEXIT_CYCLES;
+  }
+
+  // Leave the devices up to date for the snapshot
+  machine_sync( oric );
+  return hl->reason;
+}
+
+static FILE *headless_open( struct headless *hl, char *ext )
+{
+  char fname[4096+8];
+  FILE *f;
+
+  snprintf( fname, sizeof( fname ), "%s%s", hl->dumpname, ext );
+  f = fopen( fname, "wb" );
+  if( !f ) fprintf( stderr, "Unable to write '%s'\n", fname );
+  return f;
+}
+
+/*
+** Write the state the run ended in:
+**   <dumpname>.ppm - the ULA output as a 240x224 image
+**   <dumpname>.txt - the text screen
+**   <dumpname>.ram - the contents of RAM
+**   <dumpname>.sna - a snapshot
+*/
+SDL_bool headless_dump( struct machine *oric, struct headless *hl )
+{
+  char text[28][41];
+  char fname[4096+8];
+  SDL_bool ok = SDL_TRUE;
+  FILE *f;
+  int i;
+
+  if( !hl->dumpname[0] ) return SDL_TRUE;
+
+  if( ( f = headless_open( hl, ".ppm" ) ) )
+  {
+    fprintf( f, "P6\n240 224\n255\n" );
+    for( i=0; i<240*224; i++ )
+      fwrite( &oricpalette[oric->scr[i]*3], 3, 1, f );
+    fclose( f );
+  } else {
+    ok = SDL_FALSE;
+  }
+
+  if( ( f = headless_open( hl, ".txt" ) ) )
+  {
+    headless_screentext( oric, text );
+    for( i=0; i<28; i++ )
+      fprintf( f, "%s\n", text[i] );
+    fclose( f );
+  } else {
+    ok = SDL_FALSE;
+  }
+
+  if( ( f = headless_open( hl, ".ram" ) ) )
+  {
+    fwrite( oric->mem, oric->memsize, 1, f );
+    fclose( f );
+  } else {
+    ok = SDL_FALSE;
+  }
+
+  snprintf( fname, sizeof( fname ), "%s.sna", hl->dumpname );
+  if( !save_snapshot( oric, fname ) ) ok = SDL_FALSE;
+
+  return ok;
+}
+
+// There is nobody to answer, so report the message and say no
+SDL_bool headless_msgbox( struct machine *oric, int type, char *msg )
+{
+  fprintf( stderr, "%s\n", msg );
+  return SDL_FALSE;
+}
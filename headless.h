@@ -0,0 +1,71 @@
+/*
+**  Oricutron
+**  Copyright (C) 2009-2014 Peter Gordon
+**
+**  This program is free software; you can redistribute it and/or
+**  modify it under the terms of the GNU General Public License
+**  as published by the Free Software Foundation, version 2
+**  of the License.
+**
+**  This program is distributed in the hope that it will be useful,
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**  GNU General Public License for more details.
+**
+**  You should have received a copy of the GNU General Public License
+**  along with this program; if not, write to the Free Software
+**  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+**
+**  Headless batch running
+*/
+
+// Why headless_run stopped
+enum
+{
+  HLEXIT_NONE = 0,
+  HLEXIT_PC,         // Reached the exit PC
+  HLEXIT_MEM,        // Exit address holds the exit value
+  HLEXIT_TEXT,       // Exit text appeared on the screen
+  HLEXIT_CYCLES,     // Cycle limit reached
+  HLEXIT_FRAMES,     // Frame limit reached
+  HLEXIT_BREAK,      // Some other breakpoint was hit
+  HLEXIT_JAM         // CPU executed a JAM opcode
+};
+
+#define HL_TEXTLEN 40
+
+struct headless
+{
+  // Exit conditions. Whichever comes first stops the run.
+  Uint64   maxcycles;             // Cycle limit (0 = none)
+  int      maxframes;             // Frame limit (0 = none)
+  int      pc;                    // Stop when the CPU gets here (-1 = off)
+  int      memaddr;               // Stop when memaddr holds memval (-1 = off)
+  Uint8    memval;
+  char     text[HL_TEXTLEN+1];    // Stop when this is on the text screen ("" = off)
+
+  // Base filename for the dumps written by headless_dump ("" = none)
+  char     dumpname[4096];
+
+  // Time the CPU and ULA separately (costs a timer read per raster line)
+  SDL_bool timed;
+
+  // Results
+  int      reason;
+  Uint64   cycles;
+  int      frames;
+  char     bpmsg[80];             // Breakpoint message from m6502_run
+  Uint64   cpu_us;                // Time in m6502_run (if timed)
+  Uint64   video_us;              // Time in ula_doraster (if timed)
+};
+
+void headless_defaults( struct headless *hl );
+struct machine *headless_newmachine( struct machine *proto, int type, int drivetype );
+void headless_freemachine( struct machine *oric );
+SDL_bool headless_hascondition( struct headless *hl );
+int headless_run( struct machine *oric, struct headless *hl );
+char *headless_reason( int reason );
+void headless_screentext( struct machine *oric, char text[28][41] );
+Uint32 headless_screenhash( struct machine *oric );
+SDL_bool headless_dump( struct machine *oric, struct headless *hl );
+SDL_bool headless_msgbox( struct machine *oric, int type, char *msg );
@@ -42,6 +42,7 @@
 #include "keyboard.h"
 
 
+// The layouts are built once by kbd_init and only read after that
 static struct kbdkey kbd_atmos[65], kbd_oric1[65], kbd_pravetz[65];
 
 SDL_Surface* CreateSurface( int width , int height )
@@ -97,26 +98,19 @@ static SDL_COMPAT_KEY keyMapShiftedPravetz[] = {
     SDLK_LSHIFT, 'z', 'x', 'c', 'v', 'b', 'n', 'm', ',', '.', '/', SDLK_RSHIFT,
     SDLK_LEFT, SDLK_DOWN, ' ', SDLK_UP, SDLK_RIGHT, SDLK_RALT, '`', ' ', ' ', ' ', ' ', ' ' };
 
-enum {
-    MOD_CTRL = 0,
-    MOD_LSHIFT,
-    MOD_RSHIFT,
-    MOD_FUNCT,
-    MODKEY_MAX
-};
-
 static SDL_COMPAT_KEY modKeys[MODKEY_MAX] = { SDLK_LCTRL, SDLK_LSHIFT, SDLK_RSHIFT, SDLK_LALT };
 static char *modKeyNames[MODKEY_MAX] = { "Ctrl", "Left shift", "Right shift", "Funct" };
 static const int modKeyMax = MODKEY_MAX;
-static SDL_bool modKeyPressed[MODKEY_MAX];
-static SDL_bool modKeyFakePressed[MODKEY_MAX];
 
 int kbd_init( struct machine *oric )
 {
   int i, j;
 
-  memset(&modKeyPressed[0], 0, sizeof(modKeyPressed));
-  memset(&modKeyFakePressed[0], 0, sizeof(modKeyFakePressed));
+  memset(&oric->kbd.modKeyPressed[0], 0, sizeof(oric->kbd.modKeyPressed));
+  memset(&oric->kbd.modKeyFakePressed[0], 0, sizeof(oric->kbd.modKeyFakePressed));
+  oric->kbd.defining_key_map = SDL_FALSE;
+  oric->kbd.current_key = NULL;
+  oric->kbd.release_keys = SDL_FALSE;
 
   oric->keyboard_mapping.nb_map = 0;
 
@@ -273,36 +267,32 @@ int kbd_init( struct machine *oric )
   return 1;
 }
 
-static SDL_bool defining_key_map = SDL_FALSE;
-static struct kbdkey * current_key = NULL;
-static SDL_bool release_keys = SDL_FALSE;
-
 
 // This is the event handler for when you are in the menus
 SDL_bool keyboard_event( SDL_Event *ev, struct machine *oric, SDL_bool *needrender )
 {
     SDL_bool done = SDL_FALSE;
-    SDL_bool lshifted = modKeyPressed[MOD_LSHIFT];
-    SDL_bool rshifted = modKeyPressed[MOD_RSHIFT];
+    SDL_bool lshifted = oric->kbd.modKeyPressed[MOD_LSHIFT];
+    SDL_bool rshifted = oric->kbd.modKeyPressed[MOD_RSHIFT];
 
     int i, x, y, current_key_num = -1;
     static char tmp[64];
     struct kbdkey * kbd;
 
-    if (release_keys)
+    if (oric->kbd.release_keys)
     {
       x = 0;
       for (i=0; i<modKeyMax; i++)
       {
-        if (modKeyPressed[i])
+        if (oric->kbd.modKeyPressed[i])
         {
-          modKeyPressed[i] = SDL_FALSE;
+          oric->kbd.modKeyPressed[i] = SDL_FALSE;
           ay_keypress( &oric->ay, modKeys[i], SDL_FALSE );
           snprintf(tmp, sizeof(tmp), "%s released.", modKeyNames[i]);
           do_popup(oric, tmp);
           x++;
-        } else if (modKeyFakePressed[i]) {
-          modKeyFakePressed[i] = SDL_FALSE;
+        } else if (oric->kbd.modKeyFakePressed[i]) {
+          oric->kbd.modKeyFakePressed[i] = SDL_FALSE;
           ay_keypress( &oric->ay, modKeys[i], SDL_FALSE );
         }
       }
@@ -310,7 +300,7 @@ SDL_bool keyboard_event( SDL_Event *ev, struct machine *oric, SDL_bool *needrend
       if (x > 1)
         do_popup(oric, "All keys released");
 
-      release_keys = SDL_FALSE;
+      oric->kbd.release_keys = SDL_FALSE;
     }
 
     x = -1;
@@ -336,11 +326,11 @@ SDL_bool keyboard_event( SDL_Event *ev, struct machine *oric, SDL_bool *needrend
             }
 
             // find the visual key under the mouse pointer
-            current_key = NULL;
+            oric->kbd.current_key = NULL;
             for(i=0; i<62; i++) {
                 if ((x > kbd[i].x) && (x < kbd[i].x + kbd[i].w) &&
                     (y > kbd[i].y) && (y < kbd[i].y + kbd[i].h)) {
-                    current_key = &(kbd[i]);
+                    oric->kbd.current_key = &(kbd[i]);
                     current_key_num = i;
                     //if (ev->type == SDL_MOUSEBUTTONDOWN)
                     //   printf("Key %d pressed : keysim %d (%c)\n",
@@ -349,32 +339,32 @@ SDL_bool keyboard_event( SDL_Event *ev, struct machine *oric, SDL_bool *needrend
                 }
             }
 
-            if (current_key != NULL) {
+            if (oric->kbd.current_key != NULL) {
                 // check which button was pressed
                 if( ev->button.button == SDL_BUTTON_LEFT )
                 {
                     if(oric->define_mapping) {
                         do_popup( oric, "Press the key you want to use." );
-                        defining_key_map = SDL_TRUE;
+                        oric->kbd.defining_key_map = SDL_TRUE;
                     } else {
                         // manage mod keys
-                        if (current_key->is_mod_key && oric->sticky_mod_keys) {
+                        if (oric->kbd.current_key->is_mod_key && oric->sticky_mod_keys) {
                           for (i=0; i<modKeyMax; i++) {
-                            if (current_key->keysim == modKeys[i])
+                            if (oric->kbd.current_key->keysim == modKeys[i])
                               break;
                           }
 
                           if (i < modKeyMax) {
-                            if (modKeyPressed[i]) {
-                              modKeyPressed[i] = SDL_FALSE;
+                            if (oric->kbd.modKeyPressed[i]) {
+                              oric->kbd.modKeyPressed[i] = SDL_FALSE;
                               snprintf(tmp, sizeof(tmp), "%s released.", modKeyNames[i]);
                             } else {
-                              modKeyPressed[i] = SDL_TRUE;
+                              oric->kbd.modKeyPressed[i] = SDL_TRUE;
                               snprintf(tmp, sizeof(tmp), "%s pressed.", modKeyNames[i]);
                             }
                             do_popup(oric, tmp);
-                            ay_keypress( &oric->ay, current_key->keysim, modKeyPressed[i] );
-                            current_key = NULL;
+                            ay_keypress( &oric->ay, oric->kbd.current_key->keysim, oric->kbd.modKeyPressed[i] );
+                            oric->kbd.current_key = NULL;
                             return done;
                           }
                         }
@@ -385,25 +375,25 @@ SDL_bool keyboard_event( SDL_Event *ev, struct machine *oric, SDL_bool *needrend
                             case MACH_PRAVETZ:
                                 if (lshifted) {
                                     if (current_key_num == 24)
-                                        queuekeys("\x60");
-                                    if (KEYSIM_FLAG & current_key->keysimshifted)
+                                        queuekeys( &oric->ay, "\x60" );
+                                    if (KEYSIM_FLAG & oric->kbd.current_key->keysimshifted)
                                         ay_keypress( &oric->ay, modKeys[MOD_LSHIFT], SDL_FALSE );
-                                    ay_keypress( &oric->ay, KEYSIM_MASK & current_key->keysimshifted, SDL_TRUE );
+                                    ay_keypress( &oric->ay, KEYSIM_MASK & oric->kbd.current_key->keysimshifted, SDL_TRUE );
                                 } else if (rshifted) {
                                     if (current_key_num == 24)
-                                        queuekeys("\x60");
-                                    if (KEYSIM_FLAG & current_key->keysimshifted)
+                                        queuekeys( &oric->ay, "\x60" );
+                                    if (KEYSIM_FLAG & oric->kbd.current_key->keysimshifted)
                                         ay_keypress( &oric->ay, modKeys[MOD_RSHIFT], SDL_FALSE );
-                                    ay_keypress( &oric->ay, KEYSIM_MASK & current_key->keysimshifted, SDL_TRUE );
+                                    ay_keypress( &oric->ay, KEYSIM_MASK & oric->kbd.current_key->keysimshifted, SDL_TRUE );
                                 } else {
                                     if (current_key_num == 59) {
-                                        queuekeys("\x14");
-                                    } else if (KEYSIM_FLAG & current_key->keysim) {
+                                        queuekeys( &oric->ay, "\x14" );
+                                    } else if (KEYSIM_FLAG & oric->kbd.current_key->keysim) {
                                         ay_keypress( &oric->ay, modKeys[MOD_LSHIFT], SDL_TRUE );
-                                        ay_keypress( &oric->ay, KEYSIM_MASK & current_key->keysim, SDL_TRUE );
-                                        modKeyFakePressed[MOD_LSHIFT] = SDL_TRUE;
+                                        ay_keypress( &oric->ay, KEYSIM_MASK & oric->kbd.current_key->keysim, SDL_TRUE );
+                                        oric->kbd.modKeyFakePressed[MOD_LSHIFT] = SDL_TRUE;
                                     } else {
-                                        ay_keypress( &oric->ay, KEYSIM_MASK & current_key->keysim, SDL_TRUE );
+                                        ay_keypress( &oric->ay, KEYSIM_MASK & oric->kbd.current_key->keysim, SDL_TRUE );
                                     }
                                 }
                                 break;
@@ -411,19 +401,19 @@ SDL_bool keyboard_event( SDL_Event *ev, struct machine *oric, SDL_bool *needrend
                             case MACH_ORIC1_16K:
                             case MACH_ATMOS:
                             default:
-                                ay_keypress( &oric->ay, current_key->keysim, SDL_TRUE );
+                                ay_keypress( &oric->ay, oric->kbd.current_key->keysim, SDL_TRUE );
                                 break;
                         }
 
                         // start releasing mod keys if need be
-                        release_keys = SDL_TRUE;
+                        oric->kbd.release_keys = SDL_TRUE;
                     }
                 }
             }
             break;
 
         case SDL_MOUSEBUTTONUP:
-            if ((current_key == NULL) || (defining_key_map))
+            if ((oric->kbd.current_key == NULL) || (oric->kbd.defining_key_map))
                 break;
 
             // send the key to the Oric
@@ -431,29 +421,29 @@ SDL_bool keyboard_event( SDL_Event *ev, struct machine *oric, SDL_bool *needrend
             {
                 case MACH_PRAVETZ:
                     if (lshifted || rshifted) {
-                        ay_keypress( &oric->ay, KEYSIM_MASK & current_key->keysimshifted, SDL_FALSE );
+                        ay_keypress( &oric->ay, KEYSIM_MASK & oric->kbd.current_key->keysimshifted, SDL_FALSE );
                     } else {
-                        ay_keypress( &oric->ay, KEYSIM_MASK & current_key->keysim, SDL_FALSE );
+                        ay_keypress( &oric->ay, KEYSIM_MASK & oric->kbd.current_key->keysim, SDL_FALSE );
                     }
                     break;
                 case MACH_ORIC1:
                 case MACH_ORIC1_16K:
                 case MACH_ATMOS:
                 default:
-                    ay_keypress( &oric->ay, current_key->keysim, SDL_FALSE );
+                    ay_keypress( &oric->ay, oric->kbd.current_key->keysim, SDL_FALSE );
                     break;
             }
 
-            current_key = NULL;
+            oric->kbd.current_key = NULL;
             break;
 
         case SDL_KEYUP:
-            if (defining_key_map) {
+            if (oric->kbd.defining_key_map) {
                 SDL_KeyboardEvent *kbd_evt = (SDL_KeyboardEvent *) ev;
-                add_to_keyboard_mapping( &(oric->keyboard_mapping), kbd_evt->keysym.sym, current_key->keysim );
+                add_to_keyboard_mapping( &(oric->keyboard_mapping), kbd_evt->keysym.sym, oric->kbd.current_key->keysim );
                 do_popup( oric, "Key mapping done.");
-                defining_key_map = SDL_FALSE;
-                current_key = NULL;
+                oric->kbd.defining_key_map = SDL_FALSE;
+                oric->kbd.current_key = NULL;
             }
             break;
 
@@ -461,9 +451,9 @@ SDL_bool keyboard_event( SDL_Event *ev, struct machine *oric, SDL_bool *needrend
     return done;
 }
 
-void release_sticky_keys()
+void release_sticky_keys( struct machine *oric )
 {
-    release_keys = SDL_TRUE;
+    oric->kbd.release_keys = SDL_TRUE;
 }
 
 void add_to_keyboard_mapping( struct keyboard_mapping *map, SDL_COMPAT_KEY host_key, SDL_COMPAT_KEY oric_key )
@@ -31,6 +31,24 @@ struct kbdkey
   int is_mod_key;
 };
 
+enum {
+    MOD_CTRL = 0,
+    MOD_LSHIFT,
+    MOD_RSHIFT,
+    MOD_FUNCT,
+    MODKEY_MAX
+};
+
+// Which keys are held on the on-screen keyboard
+struct kbdstate
+{
+  SDL_bool modKeyPressed[MODKEY_MAX];
+  SDL_bool modKeyFakePressed[MODKEY_MAX];
+  SDL_bool defining_key_map;
+  struct kbdkey *current_key;
+  SDL_bool release_keys;
+};
+
 struct keyboard_mapping
 {
   SDL_COMPAT_KEY host_keys[65];
@@ -43,7 +61,7 @@ int kbd_init( struct machine *oric );
 
 SDL_bool keyboard_event( SDL_Event *ev, struct machine *oric, SDL_bool *needrender );
 
-void release_sticky_keys();
+void release_sticky_keys( struct machine *oric );
 
 void add_to_keyboard_mapping( struct keyboard_mapping *map, SDL_COMPAT_KEY host_key, SDL_COMPAT_KEY oric_key );
 
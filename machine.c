@@ -46,11 +46,10 @@
 #include "tape.h"
 #include "keyboard.h"
 
-extern SDL_bool warpspeed, soundavailable, soundon;
+extern SDL_bool soundavailable;
 extern char diskpath[], diskfile[], filetmp[];
 extern char telediskpath[], telediskfile[];
 extern char pravdiskpath[], pravdiskfile[];
-extern SDL_bool refreshstatus, refreshavi;
 
 char atmosromfile[1024];
 char oric1romfile[1024];
@@ -59,10 +58,6 @@ char jasmnromfile[1024];
 char pravetzromfile[2][1024];
 char telebankfiles[8][1024];
 
-struct avi_handle *vidcap = NULL;
-char vidcapname[128];
-int vidcapcount = 0;
-
 unsigned char rom_microdisc[8912], rom_jasmin[2048], rom_pravetz[512];
 struct symboltable sym_microdisc, sym_jasmin, sym_pravetz;
 SDL_bool microdiscrom_valid, jasminrom_valid, pravetzrom_valid;
@@ -228,7 +223,7 @@ void setemumode( struct machine *oric, struct osdmenuitem *mitem, int mode )
     case EM_RUNNING:
       SDL_COMPAT_EnableKeyRepeat( 0, 0 );
       SDL_COMPAT_EnableUNICODE( SDL_FALSE );
-      oric->ay.soundon = soundavailable && soundon && (!warpspeed);
+      oric->ay.soundon = soundavailable && oric->soundon && (!oric->warpspeed);
       if( oric->ay.soundon )
       {
         ay_flushlog( &oric->ay );
@@ -238,7 +233,7 @@ void setemumode( struct machine *oric, struct osdmenuitem *mitem, int mode )
       break;
 
     case EM_MENU:
-      if( vidcap ) avi_close( &vidcap );
+      if( oric->vidcap ) avi_close( &oric->vidcap );
       gotomenu( oric, NULL, 0 );
       SDL_COMPAT_EnableKeyRepeat( SDL_DEFAULT_REPEAT_DELAY, SDL_DEFAULT_REPEAT_INTERVAL );
       SDL_COMPAT_EnableUNICODE( SDL_TRUE );
@@ -248,7 +243,7 @@ void setemumode( struct machine *oric, struct osdmenuitem *mitem, int mode )
       break;
 
     case EM_DEBUG:
-      if( vidcap ) avi_close( &vidcap );
+      if( oric->vidcap ) avi_close( &oric->vidcap );
       mon_enter( oric );
       SDL_COMPAT_EnableKeyRepeat( SDL_DEFAULT_REPEAT_DELAY, SDL_DEFAULT_REPEAT_INTERVAL );
       SDL_COMPAT_EnableUNICODE( SDL_TRUE );
@@ -278,6 +273,201 @@ void setromon( struct machine *oric )
   } else {
     oric->romon = !oric->romdis;
   }
+
+  setmemmap( oric );
+}
+
+static void mapmemory( struct machine *oric )
+{
+  int i, rammask;
+
+  rammask = ( oric->type == MACH_ORIC1_16K ) ? 0x3fff : 0xffff;
+  for( i=0; i<256; i++ )
+    oric->pgread[i] = oric->pgwrite[i] = &oric->mem[(i<<8)&rammask];
+
+  // I/O
+  oric->pgread[3] = oric->pgwrite[3] = NULL;
+
+  if( oric->type == MACH_TELESTRAT )
+  {
+    for( i=0xc0; i<0x100; i++ )
+    {
+      oric->pgread[i] = &oric->rom[(i-0xc0)<<8];
+      switch( oric->tele_banktype )
+      {
+        case TELEBANK_HALFNHALF:
+          oric->pgwrite[i] = ( i < 0xe0 ) ? oric->pgread[i] : NULL;
+          break;
+
+        case TELEBANK_RAM:
+          oric->pgwrite[i] = oric->pgread[i];
+          break;
+
+        default:
+          oric->pgwrite[i] = NULL;
+          break;
+      }
+    }
+    return;
+  }
+
+  switch( oric->drivetype )
+  {
+    case DRV_MICRODISC:
+      if( oric->romdis )
+      {
+        if( oric->md.diskrom )
+        {
+          for( i=0xe0; i<0x100; i++ )
+          {
+            oric->pgread[i] = &rom_microdisc[(i-0xe0)<<8];
+            oric->pgwrite[i] = NULL;
+          }
+        }
+        return;
+      }
+      break;
+
+    case DRV_JASMIN:
+      if( oric->jasmin.olay ) return;
+      if( oric->romdis )
+      {
+        for( i=0xf8; i<0x100; i++ )
+        {
+          oric->pgread[i] = &rom_jasmin[(i-0xf8)<<8];
+          oric->pgwrite[i] = NULL;
+        }
+        return;
+      }
+      break;
+
+    case DRV_PRAVETZ:
+      // ROM is read only when the overlay is off, RAM is always written
+      if( !oric->pravetz.olay )
+      {
+        for( i=0xc0; i<0x100; i++ )
+          oric->pgread[i] = &oric->rom[(i-0xc0)<<8];
+      }
+      return;
+
+    default:
+      if( oric->romdis ) return;
+      break;
+  }
+
+  for( i=0xc0; i<0x100; i++ )
+  {
+    oric->pgread[i] = &oric->rom[(i-0xc0)<<8];
+    oric->pgwrite[i] = NULL;
+  }
+}
+
+// Rebuild the page table from the current memory configuration.
+// Must be called whenever romdis, the disk ROM/overlay or the
+// telestrat bank changes, and when memory breakpoints change.
+void setmemmap( struct machine *oric )
+{
+  Uint8 *page;
+  int i;
+
+  mapmemory( oric );
+  memcpy( oric->mapread, oric->pgread, sizeof( oric->mapread ) );
+  memcpy( oric->mapwrite, oric->pgwrite, sizeof( oric->mapwrite ) );
+
+  // Pages with memory breakpoints on them go the slow way
+  if( oric->cpu.anymbp )
+  {
+    for( i=0; i<256; i++ )
+    {
+      if( oric->cpu.mbppages[i] & MBPF_READ )
+        oric->pgread[i] = NULL;
+      if( oric->cpu.mbppages[i] & (MBPF_WRITE|MBPF_CHANGE) )
+        oric->pgwrite[i] = NULL;
+    }
+  }
+
+  // Writes to memory the ULA shows go the slow way, so it knows
+  // which lines to draw again
+  for( i=0; i<256; i++ )
+  {
+    page = oric->mapwrite[i];
+    oric->vid_watch[i] = ( page ) && ( oric->mem ) &&
+                         ( page >= oric->mem ) && ( page < &oric->mem[oric->memsize] ) &&
+                         ula_showsmem( oric, (Uint32)( page - oric->mem ), 256 );
+    if( oric->vid_watch[i] ) oric->pgwrite[i] = NULL;
+  }
+
+  // Everything goes the slow way while coverage is on
+  if( oric->cov.map )
+  {
+    memset( oric->pgread, 0, sizeof( oric->pgread ) );
+    memset( oric->pgwrite, 0, sizeof( oric->pgwrite ) );
+    coverage_setpages( oric );
+  }
+}
+
+// Page table CPU write. Anything not mapped directly
+// goes to the machine specific handler.
+static void pagedwrite( struct m6502 *cpu, unsigned short addr, unsigned char data )
+{
+  struct machine *oric = (struct machine *)cpu->userdata;
+  Uint8 *page = oric->pgwrite[addr>>8];
+
+  if( page )
+  {
+    page[addr&0xff] = data;
+    return;
+  }
+
+  page = oric->mapwrite[addr>>8];
+
+  if( oric->cov.map )
+    oric->cov.pages[addr>>8][addr&0xff] |= COV_WRITE;
+
+  if( ( oric->vid_watch[addr>>8] ) && ( page[addr&0xff] != data ) )
+    ula_memwrite( oric, (Uint32)( &page[addr&0xff] - oric->mem ) );
+
+  if( cpu->mbppages[addr>>8] )
+    m6502_mbpwrite( cpu, addr, page ? page[addr&0xff] : data, data );
+
+  if( page )
+  {
+    page[addr&0xff] = data;
+    return;
+  }
+
+  machine_sync( oric );
+  oric->slowwrite( cpu, addr, data );
+  machine_sync( oric );
+}
+
+// Page table CPU read
+static unsigned char pagedread( struct m6502 *cpu, unsigned short addr )
+{
+  struct machine *oric = (struct machine *)cpu->userdata;
+  Uint8 *page = oric->pgread[addr>>8];
+  unsigned char v;
+
+  if( page ) return page[addr&0xff];
+
+  if( oric->cov.map )
+  {
+    oric->cov.pages[addr>>8][addr&0xff] |= COV_READ;
+    page = oric->mapread[addr>>8];
+    if( ( page ) && ( !cpu->mbppages[addr>>8] ) ) return page[addr&0xff];
+  }
+
+  if( cpu->mbppages[addr>>8] )
+  {
+    m6502_mbpread( cpu, addr );
+    page = oric->mapread[addr>>8];
+    if( page ) return page[addr&0xff];
+  }
+
+  machine_sync( oric );
+  v = oric->slowread( cpu, addr );
+  machine_sync( oric );
+  return v;
 }
 
 // Oric Atmos CPU write
@@ -523,8 +713,9 @@ void pravetz_atmoswrite( struct m6502 *cpu, unsigned short addr, unsigned char d
         oric->pravetz.extension = 0x100;
         break;
       default:
-        break;
+        return;
     }
+    setmemmap( oric );
   }
 }
 
@@ -935,6 +1126,7 @@ void preinit_machine( struct machine *oric )
   oric->auto_jasmin_reset = SDL_TRUE;
 
   oric->lightpen  = SDL_FALSE;
+  oric->lightpendown = SDL_FALSE;
   oric->lightpenx = 0;
   oric->lightpeny = 0;
   oric->read_not_lightpen = NULL;
@@ -948,6 +1140,29 @@ void preinit_machine( struct machine *oric )
   oric->show_keyboard = SDL_FALSE;
   oric->define_mapping = SDL_FALSE;
   oric->sticky_mod_keys = SDL_FALSE;
+  oric->shifted = SDL_FALSE;
+
+  oric->warpspeed = SDL_FALSE;
+  oric->soundon = SDL_FALSE;
+  oric->headless = SDL_FALSE;
+  oric->refreshtape = SDL_TRUE;
+  oric->refreshdisks = SDL_TRUE;
+  oric->refreshstatus = SDL_TRUE;
+  oric->refreshavi = SDL_TRUE;
+  oric->refreshkeyboard = SDL_TRUE;
+  oric->tmptapename[0] = 0;
+
+  oric->vidcap = NULL;
+  oric->vidcapcount = 0;
+
+  oric->snapbuf = NULL;
+  oric->snapoffs = 0;
+  oric->snaphdrs = NULL;
+  oric->snapnumhdrs = 0;
+
+  oric->ay.keyqueue = NULL;
+  oric->ay.keysqueued = 0;
+  oric->ay.kqoffs = 0;
 }
 
 void load_diskroms( struct machine *oric )
@@ -998,10 +1213,9 @@ int mapkey( struct machine *oric, int key )
   return key;
 }
 
-static SDL_bool lightpendown = SDL_FALSE;
 void move_lightpen( struct machine *oric, int x, int y )
 {
-  if (!lightpendown) return;
+  if (!oric->lightpendown) return;
 
   if ((oric->rendermode == RENDERMODE_SW) || (!oric->hstretch))
   {
@@ -1024,7 +1238,6 @@ void move_lightpen( struct machine *oric, int x, int y )
   }
 }
 
-static SDL_bool shifted = SDL_FALSE;
 SDL_bool emu_event( SDL_Event *ev, struct machine *oric, SDL_bool *needrender )
 {
   Sint32 i;
@@ -1039,7 +1252,7 @@ SDL_bool emu_event( SDL_Event *ev, struct machine *oric, SDL_bool *needrender )
       switch (ev->button.button)
       {
         case SDL_BUTTON_LEFT:
-          lightpendown = SDL_TRUE;
+          oric->lightpendown = SDL_TRUE;
           move_lightpen( oric, ev->button.x, ev->button.y );
           break;
 
@@ -1052,7 +1265,7 @@ SDL_bool emu_event( SDL_Event *ev, struct machine *oric, SDL_bool *needrender )
 
     case SDL_MOUSEBUTTONUP:
       if( ev->button.button == SDL_BUTTON_LEFT )
-        lightpendown = SDL_FALSE;
+        oric->lightpendown = SDL_FALSE;
       break;
 
     case SDL_MOUSEMOTION:
@@ -1078,7 +1291,7 @@ SDL_bool emu_event( SDL_Event *ev, struct machine *oric, SDL_bool *needrender )
           break;
 
         case SDLK_F4:
-          if( ( shifted ) && ( oric->drivetype == DRV_JASMIN ) )
+          if( ( oric->shifted ) && ( oric->drivetype == DRV_JASMIN ) )
             oric->cpu.write( &oric->cpu, 0x3fb, 1 ); // ROMDIS
           if( oric->drivetype == DRV_MICRODISC )
           {
@@ -1094,26 +1307,26 @@ SDL_bool emu_event( SDL_Event *ev, struct machine *oric, SDL_bool *needrender )
 
         case SDLK_F5:
           oric->statusbar_mode = (oric->statusbar_mode+1) % STATUSBARMODE_LAST;
-          refreshstatus = SDL_TRUE;
+          oric->refreshstatus = SDL_TRUE;
           oric->statusstr[0] = 0;
           oric->newstatusstr = SDL_TRUE;
           break;
 
         case SDLK_F6:
-          if( vidcap )
+          if( oric->vidcap )
           {
-            warpspeed = SDL_FALSE;
+            oric->warpspeed = SDL_FALSE;
           }
           else
           {
-            warpspeed = warpspeed ? SDL_FALSE : SDL_TRUE;
+            oric->warpspeed = oric->warpspeed ? SDL_FALSE : SDL_TRUE;
           }
 
-          if( soundavailable && soundon )
+          if( soundavailable && oric->soundon )
           {
             ay_flushlog( &oric->ay );
-            oric->ay.soundon = !warpspeed;
-            SDL_PauseAudio( warpspeed );
+            oric->ay.soundon = !oric->warpspeed;
+            SDL_PauseAudio( oric->warpspeed );
           }
           break;
 
@@ -1124,7 +1337,7 @@ SDL_bool emu_event( SDL_Event *ev, struct machine *oric, SDL_bool *needrender )
           {
             if( ( oric->wddisk.disk[i] ) && ( oric->wddisk.disk[i]->modified ) )
             {
-              if( shifted )
+              if( oric->shifted )
               {
                 char frname[64];
                 char *dpath, *dfile;
@@ -1170,27 +1383,27 @@ SDL_bool emu_event( SDL_Event *ev, struct machine *oric, SDL_bool *needrender )
           break;
 
         case SDLK_F10:
-           if( vidcap )
+           if( oric->vidcap )
            {
              ay_lockaudio( &oric->ay );
-             avi_close( &vidcap );
+             avi_close( &oric->vidcap );
              ay_unlockaudio( &oric->ay );
              do_popup( oric, "AVI capture stopped" );
-             refreshavi = SDL_TRUE;
+             oric->refreshavi = SDL_TRUE;
              break;
            }
 
-           sprintf( vidcapname, "Capturing to video%02d.avi", vidcapcount );
-           warpspeed = SDL_FALSE;
+           sprintf( oric->vidcapname, "Capturing to video%02d.avi", oric->vidcapcount );
+           oric->warpspeed = SDL_FALSE;
            ay_lockaudio( &oric->ay );
-           vidcap = avi_open( &vidcapname[13], oricpalette, soundavailable&&soundon, oric->vid_freq );
+           oric->vidcap = avi_open( &oric->vidcapname[13], oricpalette, soundavailable&&oric->soundon, oric->vid_freq );
            ay_unlockaudio( &oric->ay );
-           if( vidcap )
+           if( oric->vidcap )
            {
-             vidcapcount++;
-             do_popup( oric, vidcapname );
+             oric->vidcapcount++;
+             do_popup( oric, oric->vidcapname );
            }
-           refreshavi = SDL_TRUE;
+           oric->refreshavi = SDL_TRUE;
            break;
 #ifdef __CBCOPY__
         case SDLK_F11:
@@ -1239,7 +1452,7 @@ SDL_bool emu_event( SDL_Event *ev, struct machine *oric, SDL_bool *needrender )
 
         case SDLK_LSHIFT:
         case SDLK_RSHIFT:
-          shifted = SDL_FALSE;
+          oric->shifted = SDL_FALSE;
 
         default:
           ay_keypress( &oric->ay, mapkey( oric, ev->key.keysym.sym ), SDL_FALSE );
@@ -1252,7 +1465,7 @@ SDL_bool emu_event( SDL_Event *ev, struct machine *oric, SDL_bool *needrender )
       {
         case SDLK_LSHIFT:
         case SDLK_RSHIFT:
-          shifted = SDL_TRUE;
+          oric->shifted = SDL_TRUE;
 
         default:
           ay_keypress( &oric->ay, mapkey( oric, ev->key.keysym.sym ), SDL_TRUE );
@@ -1440,10 +1653,200 @@ void load_patches( struct machine *oric, char *fname )
     oric->pch_tt_save_available = SDL_TRUE;
 }
 
+// Cycles until any device next has something to do
+static int machine_nextevent( struct machine *oric )
+{
+  int next, t;
+
+  next = tape_nextevent( oric );
+  if( ( oric->prclock > 0 ) && ( oric->prclock < next ) )
+    next = oric->prclock;
+  if( ( oric->prclose > 0 ) && ( oric->prclose < next ) )
+    next = oric->prclose;
+
+  // The tape and printer are moved on by every via_clock,
+  // so they run twice as fast on the telestrat
+  if( ( oric->type == MACH_TELESTRAT ) && ( next != CLK_NOEVENT ) )
+    next = (next+1)/2;
+
+  t = via_nextevent( &oric->via );
+  if( t < next ) next = t;
+  t = ay_nextevent( &oric->ay );
+  if( t < next ) next = t;
+  if((oric->drivetype == DRV_MICRODISC) || (oric->drivetype == DRV_JASMIN))
+  {
+    t = wd17xx_nextevent( &oric->wddisk );
+    if( t < next ) next = t;
+  }
+  if( oric->type == MACH_TELESTRAT )
+  {
+    t = via_nextevent( &oric->tele_via );
+    if( t < next ) next = t;
+  }
+  if( oric->aciabackend )
+  {
+    t = acia_nextevent( &oric->tele_acia );
+    if( t < next ) next = t;
+  }
+
+  return next;
+}
+
+// Pass the pending cycles on to the devices and work out
+// how long they can be left alone. Anything that looks at
+// or changes device state in the middle of a frame must
+// call this first (and again afterwards, if the change
+// could bring the next device event forward).
+void machine_sync( struct machine *oric )
+{
+  int cycles = oric->clkpending;
+
+  oric->clkpending = 0;
+  if( cycles )
+  {
+    // Before via_clock, so a tape edge at the end of these
+    // cycles is logged with them counted
+    ay_logtime( &oric->ay, cycles );
+    via_clock( &oric->via, cycles );
+    ay_ticktock( &oric->ay, cycles );
+    if((oric->drivetype == DRV_MICRODISC) || (oric->drivetype == DRV_JASMIN)) wd17xx_ticktock( &oric->wddisk, cycles );
+    if( oric->type == MACH_TELESTRAT )
+    {
+      via_clock( &oric->tele_via, cycles );
+    }
+    if( oric->aciabackend )
+      acia_clock( &oric->tele_acia, cycles );
+  }
+
+  oric->clknext = machine_nextevent( oric );
+}
+
+// Move the devices on by the cycles taken by the instruction
+// about to be executed. Called back from m6502_exec.
+// The cycles are only passed on once some device has
+// something to do, or when the I/O page is accessed
+// (see pagedread/pagedwrite), so the devices see exactly
+// the same timing as if they were clocked every instruction.
+void machine_clock( struct m6502 *cpu, int cycles )
+{
+  struct machine *oric = (struct machine *)cpu->userdata;
+
+  // The audio callback wants the AY log time rebased. Count
+  // the cycles run so far against the old base, and this
+  // instruction against the new one.
+  if( oric->ay.do_logcycle_reset )
+    machine_sync( oric );
+
+  oric->clkpending += cycles;
+  if( oric->clkpending >= oric->clknext )
+    machine_sync( oric );
+}
+
+// How long the CPU can run before a device has to be clocked
+static int machine_untilevent( struct m6502 *cpu )
+{
+  struct machine *oric = (struct machine *)cpu->userdata;
+
+  return oric->clknext - oric->clkpending;
+}
+
+// VIA registers that can be read without side effects, and that
+// only change when the VIA is clocked. Idle loops may poll these.
+static SDL_bool machine_quietio( struct m6502 *cpu, Uint16 addr )
+{
+  struct machine *oric = (struct machine *)cpu->userdata;
+
+  if( ( addr & 0xfff0 ) != 0x0300 )
+    return SDL_FALSE;
+
+  if( ( oric->aciabackend ) && ( oric->aciaoffset <= addr ) && ( addr < oric->aciaoffset+4 ) )
+    return SDL_FALSE;
+
+  switch( addr & 0xf )
+  {
+    case VIA_DDRB:
+    case VIA_DDRA:
+    case VIA_T1L_L:
+    case VIA_T1L_H:
+    case VIA_ACR:
+    case VIA_PCR:
+    case VIA_IFR:
+    case VIA_IER:
+      return SDL_TRUE;
+  }
+
+  return SDL_FALSE;
+}
+
+// Which bank is visible at addr, for breakpoint bank qualifiers.
+// On the telestrat it's the cartridge bank, otherwise 0 for the
+// ROM and 1 when ROMDIS is active.
+static int machine_getbank( struct m6502 *cpu, Uint16 addr )
+{
+  struct machine *oric = (struct machine *)cpu->userdata;
+
+  if( addr < 0xc000 )
+    return BPBANK_ANY;
+
+  if( oric->type == MACH_TELESTRAT )
+    return oric->tele_currbank;
+
+  return oric->romdis ? 1 : 0;
+}
+
+// Called from m6502_run for addresses flagged in the hook map
+static void machine_hook( struct m6502 *cpu )
+{
+  struct machine *oric = (struct machine *)cpu->userdata;
+
+  tape_patches( oric );
+  ay_patches( &oric->ay );
+}
+
+static void hookaddr( struct machine *oric, int addr )
+{
+  if( ( addr < 0 ) || ( addr > 0xffff ) ) return;
+  oric->hookmap[addr>>3] |= 1<<(addr&7);
+}
+
+// Flag every address that tape_patches or ay_patches checks for,
+// so m6502_run can skip calling them for everything else.
+// Must be redone whenever the patch addresses change.
+void sethookmap( struct machine *oric )
+{
+  memset( oric->hookmap, 0, sizeof( oric->hookmap ) );
+
+  hookaddr( oric, oric->pch_fd_cload_getname_pc );
+  hookaddr( oric, oric->pch_fd_csave_getname_pc );
+  hookaddr( oric, oric->pch_fd_store_getname_pc );
+  hookaddr( oric, oric->pch_fd_recall_getname_pc );
+  hookaddr( oric, oric->pch_tt_getsync_pc );
+  hookaddr( oric, oric->pch_tt_getsync_end_pc );
+  hookaddr( oric, oric->pch_tt_getsync_loop_pc );
+  hookaddr( oric, oric->pch_tt_readbyte_pc );
+  hookaddr( oric, oric->pch_tt_putbyte_pc );
+  hookaddr( oric, oric->pch_tt_csave_end_pc );
+  hookaddr( oric, oric->pch_tt_store_end_pc );
+  hookaddr( oric, oric->pch_tt_writeleader_pc );
+
+  // Key queue and jasmin auto reset
+  hookaddr( oric, 0xeb78 );
+  hookaddr( oric, 0xe905 );
+
+  oric->cpu.hook = machine_hook;
+  oric->cpu.hookmap = oric->hookmap;
+}
+
 static void setup_for_microdisc( struct machine *oric, void *readptr, void *writeptr )
 {
-  oric->cpu.read = readptr;
-  oric->cpu.write = writeptr;
+  oric->slowread = readptr;
+  oric->slowwrite = writeptr;
+  oric->cpu.read = pagedread;
+  oric->cpu.write = pagedwrite;
+  oric->cpu.fetchpages = oric->mapread;
+  oric->cpu.writepages = oric->mapwrite;
+  oric->cpu.fastread = oric->pgread;
+  oric->cpu.fastwrite = oric->pgwrite;
   oric->romdis = SDL_TRUE;
   microdisc_init( &oric->md, &oric->wddisk, oric );
   oric->disksyms = &sym_microdisc;
@@ -1451,8 +1854,14 @@ static void setup_for_microdisc( struct machine *oric, void *readptr, void *writ
 
 static void setup_for_jasmin( struct machine *oric, void *readptr, void *writeptr )
 {
-  oric->cpu.read = readptr;
-  oric->cpu.write = writeptr;
+  oric->slowread = readptr;
+  oric->slowwrite = writeptr;
+  oric->cpu.read = pagedread;
+  oric->cpu.write = pagedwrite;
+  oric->cpu.fetchpages = oric->mapread;
+  oric->cpu.writepages = oric->mapwrite;
+  oric->cpu.fastread = oric->pgread;
+  oric->cpu.fastwrite = oric->pgwrite;
   oric->romdis = SDL_FALSE;
   jasmin_init( &oric->jasmin, &oric->wddisk, oric );
   oric->disksyms = &sym_jasmin;
@@ -1460,8 +1869,14 @@ static void setup_for_jasmin( struct machine *oric, void *readptr, void *writept
 
 static void setup_for_pravetzdisk( struct machine *oric, void *readptr, void *writeptr )
 {
-  oric->cpu.read = readptr;
-  oric->cpu.write = writeptr;
+  oric->slowread = readptr;
+  oric->slowwrite = writeptr;
+  oric->cpu.read = pagedread;
+  oric->cpu.write = pagedwrite;
+  oric->cpu.fetchpages = oric->mapread;
+  oric->cpu.writepages = oric->mapwrite;
+  oric->cpu.fastread = oric->pgread;
+  oric->cpu.fastwrite = oric->pgwrite;
   oric->romdis = SDL_FALSE;
   pravetz_init( &oric->pravetz, oric );
   oric->disksyms = &sym_pravetz;
@@ -1470,8 +1885,14 @@ static void setup_for_pravetzdisk( struct machine *oric, void *readptr, void *wr
 static void setup_for_no_disk( struct machine *oric, void *readptr, void *writeptr )
 {
   oric->drivetype = DRV_NONE;
-  oric->cpu.read = readptr;
-  oric->cpu.write = writeptr;
+  oric->slowread = readptr;
+  oric->slowwrite = writeptr;
+  oric->cpu.read = pagedread;
+  oric->cpu.write = pagedwrite;
+  oric->cpu.fetchpages = oric->mapread;
+  oric->cpu.writepages = oric->mapwrite;
+  oric->cpu.fastread = oric->pgread;
+  oric->cpu.fastwrite = oric->pgwrite;
   oric->romdis = SDL_FALSE;
   oric->disksyms = NULL;
 }
@@ -1484,6 +1905,15 @@ SDL_bool init_machine( struct machine *oric, int type, SDL_bool nukebreakpoints
 
   oric->type = type;
   m6502_init( &oric->cpu, (void*)oric, nukebreakpoints );
+  oric->cpu.clock = machine_clock;
+  oric->cpu.getbank = machine_getbank;
+  profile_attach( oric );
+  trace_attach( oric );
+  coverage_attach( oric );
+  oric->cpu.untilevent = machine_untilevent;
+  oric->cpu.quietio = machine_quietio;
+  oric->clkpending = 0;
+  oric->clknext = 1;
 
   oric->tapeturbo_syncstack = -1;
 
@@ -1707,12 +2137,13 @@ SDL_bool init_machine( struct machine *oric, int type, SDL_bool nukebreakpoints
   oric->cpu.rastercycles = oric->cyclesperraster;
   oric->frames = 0;
   oric->vid_double = SDL_TRUE;
+  sethookmap( oric );
   setemumode( oric, NULL, EM_RUNNING );
 
   if( oric->autorewind ) tape_rewind( oric );
 
   setmenutoggles( oric );
-  refreshstatus = SDL_TRUE;
+  oric->refreshstatus = SDL_TRUE;
 
   return SDL_TRUE;
 }
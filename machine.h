@@ -20,6 +20,11 @@
 */
 
 #include "keyboard.h"
+#include "stats.h"
+#include "pace.h"
+#include "profile.h"
+#include "trace.h"
+#include "coverage.h"
 
 enum
 {
@@ -111,8 +116,8 @@ struct machine
 
   int vid_fg_col;
   int vid_bg_col;
-  Uint16 *vid_bitptr;
-  Uint16 *vid_inv_bitptr;
+  Uint64 *vid_bitptr;      // 8 byte block patterns for the colours (see ula.c)
+  Uint64 *vid_inv_bitptr;
   int vid_mode;
   int vid_freq;
   int vid_textattrs;
@@ -120,7 +125,15 @@ struct machine
   int vid_chline;
   int frames;
   SDL_bool vid_dirty[224];
-  void (*vid_block_func)( struct machine *, SDL_bool, int, int );
+  Uint8 vid_linemode[224];     // vid_mode each line was drawn in, 0xff to draw it again
+  Uint8 vid_lineend[224];      // vid_mode at the end of each line
+  SDL_bool vid_lineblink[224]; // Line has blinking attributes
+
+  // Set up by the renderer if the ULA can draw changed lines
+  // straight into it, doubled, in the host format (see ula_hostline)
+  Uint8   *vid_host;           // First pixel of line 0, NULL = off
+  int      vid_hostpitch;
+  struct swpal *vid_hostpal;   // Colours, then the scanline colours
 
   int overclockmult, overclockshift;
 
@@ -129,13 +142,36 @@ struct machine
 
   SDL_bool vid_double;
   SDL_bool romdis, romon;
+
+  // Page table for the CPU address space, rebuilt by setmemmap.
+  // A NULL page goes to the slow handlers, which is always the
+  // case for page 3 (I/O) and for writes to ROM. pgread/pgwrite
+  // also leave out pages with memory breakpoints on them, pages
+  // the ULA shows (for writes) and everything while coverage is
+  // on. Those are still in mapread/mapwrite. The 6502 core reads
+  // and writes data through pgread/pgwrite itself (cpu.fastread
+  // and cpu.fastwrite), so an access only reaches pagedread or
+  // pagedwrite if its page is NULL there.
+  Uint8 *pgread[256];
+  Uint8 *pgwrite[256];
+  Uint8 *mapread[256];
+  Uint8 *mapwrite[256];
+  Uint8  vid_watch[256];   // Page is RAM the ULA shows
+  unsigned char (*slowread)(struct m6502 *,Uint16);
+  void (*slowwrite)(struct m6502 *,Uint16,Uint8);
+
+  // Lazy device clocking (see machine_clock)
+  int clkpending, clknext;
   SDL_bool vsynchack;
 
+  // Addresses where tape_patches or ay_patches might act,
+  // one bit each (see sethookmap)
+  Uint8 hookmap[8192];
+
   unsigned short vid_addr;
   unsigned char *vid_ch_data;
   unsigned char *vid_ch_base;
 
-  Uint8  *scrpt;
   Uint8  *scr;
 
   Uint16 vidbases[4];
@@ -168,6 +204,9 @@ struct machine
   int tapecaplastbit;
   int tapecapsavbytes;
   int tapecapsavoffs;
+  char tmptapename[4096];
+  SDL_bool refreshtape, refreshdisks;
+  SDL_bool refreshstatus, refreshavi, refreshkeyboard;
 
   // Filename decoding patch addresses
   int pch_fd_cload_getname_pc;
@@ -233,8 +272,9 @@ struct machine
   Sint32 telejoymode_a, telejoymode_b;
   SDL_COMPAT_KEY kbjoy1[6], kbjoy2[6];
 
-  SDL_bool lightpen;
+  SDL_bool lightpen, lightpendown;
   Uint8  lightpenx, lightpeny;
+  SDL_bool shifted;
   unsigned char (*read_not_lightpen)(struct m6502 *,Uint16);
 
   Uint8  porta_joy, porta_ay;
@@ -243,6 +283,7 @@ struct machine
   SDL_Joystick *sdljoy_a, *sdljoy_b;
 
   struct keyboard_mapping keyboard_mapping;
+  struct kbdstate kbd;
   SDL_bool show_keyboard;
   SDL_bool define_mapping;
   SDL_bool sticky_mod_keys;
@@ -253,9 +294,39 @@ struct machine
   int aciabackendcfgport;
   int aciabackendcfgdomain;
   char aciabackendname[ACIA_BACKEND_NAME_LEN];
+
+  SDL_bool warpspeed, soundon;
+
+  // Running without a window or audio (see headless.c)
+  SDL_bool headless;
+
+  // Hot path counters and timers (see stats.c)
+  struct perfstats stats;
+
+  // Frame timing and jitter (see pace.c)
+  struct framepacer pace;
+
+  // Cycles spent at each PC (see profile.c)
+  struct profiler prof;
+
+  // Instruction trace (see trace.c)
+  struct tracer trace;
+  struct coverage cov;
+
+  // Video capture
+  struct avi_handle *vidcap;
+  char vidcapname[128];
+  int vidcapcount;
+
+  // Snapshot save/load working state (see snapshot.c)
+  unsigned char *snapbuf;
+  int snapoffs;
+  struct blockheader *snaphdrs;
+  int snapnumhdrs;
 };
 
 void setromon( struct machine *oric );
+void setmemmap( struct machine *oric );
 void setemumode( struct machine *oric, struct osdmenuitem *mitem, int mode );
 void video_show( struct machine *oric );
 SDL_bool emu_event( SDL_Event *ev, struct machine *oric, SDL_bool *needrender );
@@ -269,6 +340,9 @@ void swapmach( struct machine *oric, struct osdmenuitem *mitem, int which );
 SDL_bool isram( struct machine *oric, unsigned short addr );
 
 void clear_patches( struct machine *oric );
+void sethookmap( struct machine *oric );
+void machine_clock( struct m6502 *cpu, int cycles );
+void machine_sync( struct machine *oric );
 
 unsigned char lightpen_read( struct m6502 *cpu, unsigned short addr );
 
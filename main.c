@@ -57,15 +57,17 @@
 #include "tape.h"
 #include "snapshot.h"
 #include "keyboard.h"
+#include "headless.h"
+#include "batch.h"
+#include "bench.h"
 
 #define FRAMES_TO_AVERAGE 8
 
 SDL_bool need_sdl_quit = SDL_FALSE;
-SDL_bool fullscreen, hwsurface;
-extern SDL_bool warpspeed, soundon;
-Uint32 lastframetimes[FRAMES_TO_AVERAGE], frametimeave;
+SDL_bool fullscreen, hwsurface, swsmooth;
+double swscale;
+Uint32 lastframetimes[FRAMES_TO_AVERAGE], frametimeave;  // Microseconds
 extern char mon_bpmsg[];
-extern struct avi_handle *vidcap;
 extern char tapepath[], diskpath[], telediskpath[], pravdiskpath[];
 extern char atmosromfile[];
 extern char oric1romfile[];
@@ -74,6 +76,15 @@ extern char jasmnromfile[];
 extern char pravetzromfile[2][1024];
 extern char telebankfiles[8][1024];
 
+static struct headless hl;
+static char *batchfile = NULL;
+static int batchthreads = 0;
+static char *benchlist = NULL;
+static char *statslog = NULL;
+static char *profilename = NULL;
+static char *tracename = NULL;
+static char *coveragename = NULL;
+
 static char keymap_path[4096+32];
 static int  load_keymap = SDL_FALSE;
 
@@ -106,6 +117,8 @@ struct start_opts
   char     start_syms[1024];
   char     start_snapshot[1024];
   char    *start_breakpoint;
+  char    *start_exitpc;
+  char    *start_exitmem;
 };
 
 static char *machtypes[] = { "oric1",
@@ -310,6 +323,46 @@ SDL_bool read_config_int( char *buf, char *token, int *dest, int min, int max )
   return SDL_TRUE;
 }
 
+// A software scaling factor, from 1 to 8, or "fit" (0)
+static SDL_bool parse_swscale( char *str, double *dest )
+{
+  char *end;
+  double f;
+
+  if( strncasecmp( str, "fit", 3 ) == 0 )
+  {
+    *dest = 0.0;
+    return SDL_TRUE;
+  }
+
+  f = strtod( str, &end );
+  if( ( end == str ) || ( f < 1.0 ) || ( f > 8.0 ) ) return SDL_FALSE;
+
+  *dest = f;
+  return SDL_TRUE;
+}
+
+static SDL_bool read_config_swscale( char *buf, char *token, double *dest )
+{
+  Sint32 i, toklen;
+
+  // Get the token length
+  toklen = (int)strlen( token );
+
+  // Is this the token?
+  if( strncasecmp( buf, token, toklen ) != 0 ) return SDL_FALSE;
+  i = toklen;
+
+  // Check for whitespace, equals, whitespace
+  while( isws( buf[i] ) ) i++;
+  if( buf[i] != '=' ) return SDL_TRUE;
+  i++;
+  while( isws( buf[i] ) ) i++;
+
+  parse_swscale( &buf[i], dest );
+  return SDL_TRUE;
+}
+
 SDL_bool read_config_joykey( char *buf, char *token, SDL_COMPAT_KEY *dest )
 {
   Sint32 i, toklen, d;
@@ -389,6 +442,8 @@ static void load_config( struct start_opts *sto, struct machine *oric )
     if( read_config_bool(   &sto->lctmp[i], "debug",        &sto->start_debug ) ) continue;
     if( read_config_bool(   &sto->lctmp[i], "fullscreen",   &fullscreen ) ) continue;
     if( read_config_bool(   &sto->lctmp[i], "hwsurface",    &hwsurface ) ) continue;
+    if( read_config_swscale( &sto->lctmp[i], "swscale",     &swscale ) ) continue;
+    if( read_config_bool(   &sto->lctmp[i], "swsmooth",     &swsmooth ) ) continue;
     if( read_config_bool(   &sto->lctmp[i], "scanlines",    &oric->scanlines ) ) continue;
     if( read_config_bool(   &sto->lctmp[i], "hstretch",     &oric->hstretch ) ) continue;
     if( read_config_bool(   &sto->lctmp[i], "palghosting",  &oric->palghost ) ) continue;
@@ -539,6 +594,40 @@ static void usage( int ret )
           "  --lightpen on|off  = Enable or disable lightpen\n"
           "  --vsynchack on|off = Enable or disable VSync hack\n"
           "  --scanlines on|off = Enable or disable scanline simulation\n"
+          "  --swscale <n|fit>  = Scale the window up by n (1 to 8, can be fractional)\n"
+          "                       or to fit the desktop (software rendering only)\n"
+          "  --swsmooth on|off  = Smooth fractional scaling (32 bit software rendering)\n"
+          "\n"
+          "  --headless         = Run with no window or audio, flat out, until one of\n"
+          "                       the exit conditions below is met. Then write the\n"
+          "                       screen (.ppm and .txt), RAM (.ram) and a snapshot (.sna)\n"
+          "                       and quit. The exit code is 0 for a pc, mem or text\n"
+          "                       exit, 1 for a cycle or frame limit, 2 for a JAM or\n"
+          "                       other breakpoint\n"
+          "  --exit-cycles N    = Stop after N cycles\n"
+          "  --exit-frames N    = Stop after N frames\n"
+          "  --exit-pc <addr>   = Stop when the CPU gets to <addr> (address or symbol)\n"
+          "  --exit-mem <a>,<v> = Stop when address <a> holds the value <v>\n"
+          "  --exit-text <str>  = Stop when <str> appears on the text screen\n"
+          "  --dump <name>      = Base filename for the dumps (default \"oricutron_exit\")\n"
+          "\n"
+          "  --batch <manifest> = Run every job in <manifest> headless, several at once.\n"
+          "                       Each line is an image followed by key=value exit\n"
+          "                       conditions: machine, drive, cycles, frames, pc,\n"
+          "                       mem=<a>,<v>, text and dump. The --exit options set the\n"
+          "                       defaults, and --dump is a prefix for numbered dumps\n"
+          "  --jobs N           = Run N batch jobs at a time (default one per CPU)\n"
+          "  --bench <names>    = Run the built in benchmarks (comma separated, or \"all\")\n"
+          "                       and print the results as CSV. The workloads are\n"
+          "                       basic, hires, ay, tape, microdisc and telestrat\n"
+          "  --stats <file>     = Write the hot path counters and timers to <file> as\n"
+          "                       CSV, one row per 50 frames\n"
+          "  --profile <file>   = Profile the 6502 code and write a report to <file>,\n"
+          "                       every address as CSV to <file>.csv and the call\n"
+          "                       stacks to <file>.folded, at exit\n"
+          "  --trace <file>     = Write every 6502 instruction executed to <file>\n"
+          "  --coverage <file>  = Write the addresses executed, read and written to\n"
+          "                       <file>, and the raw map to <file>.bin, at exit\n"
           "\n"
           "  --serial_address N = Set serial card base address to N\n"
           "                       where N is decimal or hexadecimal within the range of $31c..$3fc\n"
@@ -583,6 +672,42 @@ static void error_printf( char *fmt, ... )
   va_end( ap );
 }
 
+// Exit addresses can be symbols, which need mon_init
+static SDL_bool parse_exits( struct machine *oric, struct start_opts *sto, SDL_bool symbols )
+{
+  int i;
+  unsigned int addr, val;
+
+  if( sto->start_exitpc )
+  {
+    i = 0;
+    if( !mon_getnum( oric, &addr, sto->start_exitpc, &i, SDL_FALSE, SDL_FALSE, SDL_FALSE, symbols ) )
+    {
+      error_printf( "Invalid exit address" );
+      return SDL_FALSE;
+    }
+
+    hl.pc = addr&0xffff;
+  }
+
+  if( sto->start_exitmem )
+  {
+    i = 0;
+    if( ( !mon_getnum( oric, &addr, sto->start_exitmem, &i, SDL_FALSE, SDL_FALSE, SDL_FALSE, symbols ) ) ||
+        ( sto->start_exitmem[i++] != ',' ) ||
+        ( !mon_getnum( oric, &val, sto->start_exitmem, &i, SDL_FALSE, SDL_FALSE, SDL_FALSE, SDL_FALSE ) ) )
+    {
+      error_printf( "Invalid exit address or value" );
+      return SDL_FALSE;
+    }
+
+    hl.memaddr = addr&0xffff;
+    hl.memval  = val&0xff;
+  }
+
+  return SDL_TRUE;
+}
+
 static SDL_bool on_or_off( char *arg, char *option, SDL_bool *storage )
 {
   if( option )
@@ -625,12 +750,16 @@ SDL_bool init( struct machine *oric, int argc, char *argv[] )
   sto->start_syms[0]  = 0;
   sto->start_snapshot[0] = 0;
   sto->start_breakpoint = NULL;
+  sto->start_exitpc   = NULL;
+  sto->start_exitmem  = NULL;
   fullscreen          = SDL_FALSE;
 #ifdef WIN32
   hwsurface           = SDL_TRUE;
 #else
   hwsurface           = SDL_FALSE;
 #endif
+  swscale             = 1.0;
+  swsmooth            = SDL_FALSE;
 
   preinit_ula( oric );
   preinit_machine( oric );
@@ -643,19 +772,38 @@ SDL_bool init( struct machine *oric, int argc, char *argv[] )
 
   kbd_init(oric);
 
+  // Headless has to be known before SDL opens anything
+  headless_defaults( &hl );
+  for( i=1; i<argc; i++ )
+  {
+    if( strcasecmp( argv[i], "--headless" ) == 0 )
+      oric->headless = SDL_TRUE;
+
+    // Batch and bench jobs only write dumps if asked to
+    if( ( strcasecmp( argv[i], "--batch" ) == 0 ) ||
+        ( strcasecmp( argv[i], "--bench" ) == 0 ) )
+    {
+      oric->headless = SDL_TRUE;
+      hl.dumpname[0] = 0;
+    }
+  }
+
   // Go SDL!
-  if( SDL_Init( SDL_INIT_VIDEO | SDL_INIT_AUDIO ) < 0 )
+  if( SDL_Init( oric->headless ? 0 : ( SDL_INIT_VIDEO | SDL_INIT_AUDIO ) ) < 0 )
   {
     error_printf( "SDL init failed" );
     return SDL_FALSE;
   }
   need_sdl_quit = SDL_TRUE;
 
+  if( !oric->headless )
+  {
 #ifndef __APPLE__
-  SDL_COMPAT_WM_SetIcon( SDL_LoadBMP( IMAGEPREFIX"winicon.bmp" ), NULL );
+    SDL_COMPAT_WM_SetIcon( SDL_LoadBMP( IMAGEPREFIX"winicon.bmp" ), NULL );
 #endif
 
-  render_sw_detectvideo( oric );
+    render_sw_detectvideo( oric );
+  }
 
   load_config( sto, oric );
 
@@ -676,6 +824,7 @@ SDL_bool init( struct machine *oric, int argc, char *argv[] )
           if( strcasecmp( tmp, "hwsurface"  ) == 0 ) { hwsurface = SDL_TRUE; break; }
           if( strcasecmp( tmp, "swsurface"  ) == 0 ) { hwsurface = SDL_FALSE; break; }
           if( strcasecmp( tmp, "help"       ) == 0 ) { opt_type = 'h'; break; }
+          if( strcasecmp( tmp, "headless"   ) == 0 ) break;  // Already seen
 
           if( i<(argc-1) )
             opt_arg = argv[i+1];
@@ -760,6 +909,149 @@ SDL_bool init( struct machine *oric, int argc, char *argv[] )
             continue;
           }
 
+          if( strcasecmp( tmp, "batch" ) == 0 )
+          {
+            if( !opt_arg )
+            {
+              error_printf( "Batch manifest expected" );
+              exit( EXIT_FAILURE );
+            }
+            batchfile = opt_arg;
+            continue;
+          }
+
+          if( strcasecmp( tmp, "bench" ) == 0 )
+          {
+            if( !opt_arg )
+            {
+              error_printf( "Benchmark names or \"all\" expected" );
+              exit( EXIT_FAILURE );
+            }
+            benchlist = opt_arg;
+            continue;
+          }
+
+          if( strcasecmp( tmp, "stats" ) == 0 )
+          {
+            if( !opt_arg )
+            {
+              error_printf( "Stats log filename expected" );
+              exit( EXIT_FAILURE );
+            }
+            statslog = opt_arg;
+            continue;
+          }
+
+          if( strcasecmp( tmp, "profile" ) == 0 )
+          {
+            if( !opt_arg )
+            {
+              error_printf( "Profile filename expected" );
+              exit( EXIT_FAILURE );
+            }
+            profilename = opt_arg;
+            continue;
+          }
+
+          if( strcasecmp( tmp, "trace" ) == 0 )
+          {
+            if( !opt_arg )
+            {
+              error_printf( "Trace filename expected" );
+              exit( EXIT_FAILURE );
+            }
+            tracename = opt_arg;
+            continue;
+          }
+
+          if( strcasecmp( tmp, "coverage" ) == 0 )
+          {
+            if( !opt_arg )
+            {
+              error_printf( "Coverage filename expected" );
+              exit( EXIT_FAILURE );
+            }
+            coveragename = opt_arg;
+            continue;
+          }
+
+          if( strcasecmp( tmp, "jobs" ) == 0 )
+          {
+            if( ( !opt_arg ) || ( ( batchthreads = atoi( opt_arg ) ) <= 0 ) )
+            {
+              error_printf( "Number of jobs expected" );
+              exit( EXIT_FAILURE );
+            }
+            continue;
+          }
+
+          if( strcasecmp( tmp, "exit-cycles" ) == 0 )
+          {
+            if( ( !opt_arg ) || ( ( hl.maxcycles = strtoull( opt_arg, NULL, 10 ) ) == 0 ) )
+            {
+              error_printf( "Cycle count expected" );
+              exit( EXIT_FAILURE );
+            }
+            continue;
+          }
+
+          if( strcasecmp( tmp, "exit-frames" ) == 0 )
+          {
+            if( ( !opt_arg ) || ( ( hl.maxframes = atoi( opt_arg ) ) <= 0 ) )
+            {
+              error_printf( "Frame count expected" );
+              exit( EXIT_FAILURE );
+            }
+            continue;
+          }
+
+          // Addresses can be symbols, so these wait for mon_init
+          if( strcasecmp( tmp, "exit-pc" ) == 0 )
+          {
+            if( !opt_arg )
+            {
+              error_printf( "Exit address or symbol expected" );
+              exit( EXIT_FAILURE );
+            }
+            sto->start_exitpc = opt_arg;
+            continue;
+          }
+
+          if( strcasecmp( tmp, "exit-mem" ) == 0 )
+          {
+            if( !opt_arg )
+            {
+              error_printf( "Exit address and value expected" );
+              exit( EXIT_FAILURE );
+            }
+            sto->start_exitmem = opt_arg;
+            continue;
+          }
+
+          if( strcasecmp( tmp, "exit-text" ) == 0 )
+          {
+            if( !opt_arg )
+            {
+              error_printf( "Exit text expected" );
+              exit( EXIT_FAILURE );
+            }
+            strncpy( hl.text, opt_arg, HL_TEXTLEN );
+            hl.text[HL_TEXTLEN] = 0;
+            continue;
+          }
+
+          if( strcasecmp( tmp, "dump" ) == 0 )
+          {
+            if( !opt_arg )
+            {
+              error_printf( "Dump filename expected" );
+              exit( EXIT_FAILURE );
+            }
+            strncpy( hl.dumpname, opt_arg, sizeof( hl.dumpname ) );
+            hl.dumpname[sizeof( hl.dumpname )-1] = 0;
+            continue;
+          }
+
           if( strcasecmp( tmp, "vsynchack" ) == 0 )
           {
             if( !on_or_off( argv[i-1], opt_arg, &oric->vsynchack ) ) exit( EXIT_FAILURE );
@@ -771,6 +1063,22 @@ SDL_bool init( struct machine *oric, int argc, char *argv[] )
             if( !on_or_off( argv[i-1], opt_arg, &oric->scanlines ) ) exit( EXIT_FAILURE );
             continue;
           }
+
+          if( strcasecmp( tmp, "swscale" ) == 0 )
+          {
+            if( ( !opt_arg ) || ( !parse_swscale( opt_arg, &swscale ) ) )
+            {
+              error_printf( "Scale from 1 to 8, or 'fit', expected" );
+              exit( EXIT_FAILURE );
+            }
+            continue;
+          }
+
+          if( strcasecmp( tmp, "swsmooth" ) == 0 )
+          {
+            if( !on_or_off( argv[i-1], opt_arg, &swsmooth ) ) exit( EXIT_FAILURE );
+            continue;
+          }
           break;
 
         default:
@@ -1081,13 +1389,44 @@ SDL_bool init( struct machine *oric, int argc, char *argv[] )
   if( ( sto->start_disk[0] ) && ( sto->start_disktype == DRV_NONE ) )
     sto->start_disktype = DRV_MICRODISC;
 
+  if( oric->headless )
+  {
+    if( ( !batchfile ) && ( !benchlist ) && ( !headless_hascondition( &hl ) ) && ( !sto->start_exitpc ) && ( !sto->start_exitmem ) )
+    {
+      error_printf( "Headless mode needs at least one exit condition" );
+      free( sto );
+      return SDL_FALSE;
+    }
+
+    sto->start_rendermode = RENDERMODE_NULL;
+    sto->start_debug = SDL_FALSE;
+    fullscreen = SDL_FALSE;
+    oric->warpspeed = SDL_TRUE;
+  }
+
   for( i=0; i<8; i++ ) lastframetimes[i] = 0;
   frametimeave = 0;
 
   setoverclock( oric, NULL, 0 );
   if( !init_gui( oric, sto->start_rendermode ) ) { free( sto ); return SDL_FALSE; }
-  if( !init_filerequester( oric ) ) { free( sto ); return SDL_FALSE; }
-  if( !init_msgbox( oric ) ) { free( sto ); return SDL_FALSE; }
+  if( !oric->headless )
+  {
+    if( !init_filerequester( oric ) ) { free( sto ); return SDL_FALSE; }
+    if( !init_msgbox( oric ) ) { free( sto ); return SDL_FALSE; }
+  }
+
+  // In batch and bench mode this machine is only a template for
+  // the jobs, so it stops short of being set up. Symbols need a machine.
+  if( ( batchfile ) || ( benchlist ) )
+  {
+    oric->type = sto->start_machine;
+    oric->drivetype = sto->start_disktype;
+    oric->aciabackend = oric->aciabackendcfg = ACIA_TYPE_NONE;
+    if( !parse_exits( oric, sto, SDL_FALSE ) ) { free( sto ); return SDL_FALSE; }
+    free( sto );
+    return SDL_TRUE;
+  }
+
   oric->drivetype = sto->start_disktype;
   if( !init_ula( oric ) ) { free( sto ); return SDL_FALSE; }
   if( !init_joy( oric ) ) { free( sto ); return SDL_FALSE; }
@@ -1099,7 +1438,7 @@ SDL_bool init( struct machine *oric, int argc, char *argv[] )
     switch (oric->drivetype)
     {
       case DRV_PRAVETZ:
-        queuekeys( "CALL#320\x0d" );
+        queuekeys( &oric->ay, "CALL#320\x0d" );
         break;
 
       case DRV_JASMIN:
@@ -1110,7 +1449,7 @@ SDL_bool init( struct machine *oric, int argc, char *argv[] )
   if( sto->start_tape[0] )
   {
     if( tape_load_tap( oric, sto->start_tape ) )
-      queuekeys( "CLOAD\"\"\x0d" );
+      queuekeys( &oric->ay, "CLOAD\"\"\x0d" );
   }
 
   mon_init( oric );
@@ -1128,13 +1467,30 @@ SDL_bool init( struct machine *oric, int argc, char *argv[] )
       return SDL_FALSE;
     }
 
-    oric->cpu.breakpoints[0] = addr;
-    oric->cpu.anybp = SDL_TRUE;
+    m6502_addbp( &oric->cpu, addr&0xffff, BPBANK_ANY );
+  }
+
+  if( !parse_exits( oric, sto, SDL_TRUE ) )
+  {
+    free( sto );
+    return SDL_FALSE;
   }
 
   if( sto->start_snapshot[0] )
     load_snapshot( oric, sto->start_snapshot );
 
+  if( ( statslog ) && ( !stats_startlog( oric, statslog, 50 ) ) )
+    error_printf( "Unable to write '%s'", statslog );
+
+  if( ( profilename ) && ( !profile_start( oric ) ) )
+    error_printf( "Out of memory for the profiler" );
+
+  if( ( tracename ) && ( !trace_stream( oric, tracename ) ) )
+    error_printf( "Unable to trace to '%s'", tracename );
+
+  if( ( coveragename ) && ( !coverage_start( oric ) ) )
+    error_printf( "Out of memory for the coverage map" );
+
   if( sto->start_debug )
     setemumode( oric, NULL, EM_DEBUG );
 
@@ -1144,18 +1500,42 @@ SDL_bool init( struct machine *oric, int argc, char *argv[] )
 
 void shut( struct machine *oric )
 {
-  if( vidcap ) avi_close( &vidcap );
-#if defined(DEBUG_CPU_TRACE) && DEBUG_CPU_TRACE > 0
-  dump_cputrace(oric);
-#endif
   if( oric )
   {
+    if( oric->vidcap ) avi_close( &oric->vidcap );
+    stats_stoplog( oric );
+    if( ( profilename ) && ( oric->prof.cycles ) )
+    {
+      char fname[4096+8];
+
+      snprintf( fname, sizeof( fname ), "%s.csv", profilename );
+      if( ( !profile_report( oric, profilename ) ) || ( !profile_flat( oric, fname ) ) )
+        error_printf( "Unable to write the profile to '%s'", profilename );
+      snprintf( fname, sizeof( fname ), "%s.folded", profilename );
+      if( !profile_folded( oric, fname ) )
+        error_printf( "Unable to write '%s'", fname );
+    }
+    if( ( coveragename ) && ( oric->cov.map ) )
+    {
+      char fname[4096+8];
+
+      snprintf( fname, sizeof( fname ), "%s.bin", coveragename );
+      if( ( !coverage_save( oric, coveragename ) ) || ( !coverage_savemap( oric, fname ) ) )
+        error_printf( "Unable to write the coverage to '%s'", coveragename );
+    }
+    profile_stop( oric );
+    trace_stop( oric );
+    coverage_stop( oric );
     shut_machine( oric );
+    m6502_free( &oric->cpu );
     shut_joy( oric );
     shut_ula( oric );
     mon_shut( oric );
-    shut_filerequester( oric );
-    shut_msgbox( oric );
+    if( !oric->headless )
+    {
+      shut_filerequester( oric );
+      shut_msgbox( oric );
+    }
     shut_gui( oric );
   }
   if( need_sdl_quit ) SDL_COMPAT_Quit();
@@ -1194,6 +1574,8 @@ void frameloop_overclock( struct machine *oric, SDL_bool *framedone, SDL_bool *n
       instcycles >>= oric->overclockshift;
 
       /* Move the emulation on */
+      ay_patches( &oric->ay );
+      ay_logtime( &oric->ay, instcycles );
       via_clock( &oric->via, instcycles );
       ay_ticktock( &oric->ay, instcycles );
       if((oric->drivetype == DRV_MICRODISC) || (oric->drivetype == DRV_JASMIN)) wd17xx_ticktock( &oric->wddisk, instcycles );
@@ -1229,38 +1611,29 @@ void frameloop_overclock( struct machine *oric, SDL_bool *framedone, SDL_bool *n
 
 void frameloop_normal( struct machine *oric, SDL_bool *framedone, SDL_bool *needrender )
 {
+  // Things like tape and disk changes may have happened since last time
+  machine_sync( oric );
+  m6502_idlereset( &oric->cpu );
+
   while( ( !(*framedone) ) && ( !(*needrender) ) )
   {
-    while( oric->cpu.rastercycles > 0 )
+    // Runs until the end of the raster line. The tape and ay
+    // patches are called back through machine_hook, and the
+    // devices are clocked through machine_clock.
+    switch( m6502_run( &oric->cpu, SDL_TRUE, mon_bpmsg ) )
     {
-      if( m6502_set_icycles( &oric->cpu, SDL_TRUE, mon_bpmsg ) )
-      {
+      case M6502_RUN_BREAK:
         // Hit breakpoint
         setemumode( oric, NULL, EM_DEBUG );
         *needrender = SDL_TRUE;
         break;
-      }
 
-      tape_patches( oric );
-      via_clock( &oric->via, oric->cpu.icycles );
-      ay_ticktock( &oric->ay, oric->cpu.icycles );
-      if((oric->drivetype == DRV_MICRODISC) || (oric->drivetype == DRV_JASMIN)) wd17xx_ticktock( &oric->wddisk, oric->cpu.icycles );
-      if( oric->type == MACH_TELESTRAT )
-      {
-        via_clock( &oric->tele_via, oric->cpu.icycles );
-      }
-      if( oric->aciabackend )
-        acia_clock( &oric->tele_acia, oric->cpu.icycles );
-
-      oric->cpu.rastercycles -= oric->cpu.icycles;
-      if( m6502_inst( &oric->cpu ) )
-      {
+      case M6502_RUN_JAM:
         // Hit JAM instruction
         mon_printf_above( "Opcode %02X executed at %04X", oric->cpu.calcop, oric->cpu.lastpc );
         setemumode( oric, NULL, EM_DEBUG );
         *needrender = SDL_TRUE;
         break;
-      }
     }
 
     if( oric->cpu.rastercycles <= 0 )
@@ -1269,6 +1642,9 @@ void frameloop_normal( struct machine *oric, SDL_bool *framedone, SDL_bool *need
       oric->cpu.rastercycles += oric->cyclesperraster;
     }
   }
+
+  // Leave the devices up to date for the monitor, GUI etc.
+  machine_sync( oric );
 }
 
 /* Tasks to do once per emulated frame */
@@ -1276,6 +1652,9 @@ void once_per_frame( struct machine *oric )
 {
   int i;
 
+  stats_endframe( oric );
+  trace_sync( oric );
+
   if( oric->diskautosave )
   {
     for( i=0; i<4; i++ )
@@ -1322,16 +1701,54 @@ int main( int argc, char *argv[] )
     //printf("Current Path: %s\n", path);
 #endif
 
-  if( ( isinit = init( &oric, argc, argv ) ) )
+  if( ( isinit = init( &oric, argc, argv ) ) && ( batchfile ) )
+  {
+    int ret;
+
+    ret = batch_run( &oric, &hl, batchfile, batchthreads ? batchthreads : SDL_COMPAT_GetCPUCount() );
+    shut_gui( &oric );
+    if( need_sdl_quit ) SDL_COMPAT_Quit();
+    return ret;
+  }
+  else if( ( isinit ) && ( benchlist ) )
+  {
+    int ret;
+
+    ret = bench_run( &oric, benchlist );
+    shut_gui( &oric );
+    if( need_sdl_quit ) SDL_COMPAT_Quit();
+    return ret;
+  }
+  else if( ( isinit ) && ( oric.headless ) )
+  {
+    int reason;
+
+    reason = headless_run( &oric, &hl );
+    printf( "exit=%s cycles=%llu frames=%d pc=$%04X hash=%08X\n", headless_reason( reason ),
+      (unsigned long long)hl.cycles, hl.frames, oric.cpu.calcpc, headless_screenhash( &oric ) );
+    if( reason == HLEXIT_BREAK ) printf( "%s\n", hl.bpmsg );
+    headless_dump( &oric, &hl );
+    shut( &oric );
+
+    switch( reason )
+    {
+      case HLEXIT_PC:
+      case HLEXIT_MEM:
+      case HLEXIT_TEXT:
+        return EXIT_SUCCESS;
+
+      case HLEXIT_CYCLES:
+      case HLEXIT_FRAMES:
+        return EXIT_FAILURE;
+    }
+    return 2;
+  }
+  else if( isinit )
   {
-    Uint64 nextframe_us;
-    Uint32 nextframe_ms, now=0, then;
     SDL_bool done, needrender, framedone;
     Sint32 i;
 
-    now = SDL_GetTicks();
-    nextframe_ms = now;
-    nextframe_us = ((Uint64)nextframe_ms)*1000;
+    pace_reset( &oric.pace );
 
     done = SDL_FALSE;
     needrender = SDL_TRUE;
@@ -1352,19 +1769,20 @@ int main( int argc, char *argv[] )
 
       if( oric.emu_mode == EM_RUNNING )
       {
+        Uint64 t;
+
+        t = stats_start( &oric.stats );
         if( oric.overclockmult==1 )
           frameloop_normal( &oric, &framedone, &needrender );
         else
           frameloop_overclock( &oric, &framedone, &needrender );
+        stats_stop( &oric.stats, STIME_EMU, t );
 
         ay_unlockaudio( &oric.ay );
 
         if( framedone )
         {
-          nextframe_us += oric.vid_freq ? 20000LL : 16667LL;
-          nextframe_ms = (Uint32)(nextframe_us/1000LL);
-
-          if (warpspeed)
+          if (oric.warpspeed)
           {
             if ((oric.frames&3)==0)
               needrender = SDL_TRUE;
@@ -1385,35 +1803,14 @@ int main( int argc, char *argv[] )
         {
           once_per_frame( &oric );
 
-          then = now;
-          now = SDL_GetTicks();
-
           frametimeave = 0;
           for( i=(FRAMES_TO_AVERAGE-1); i>0; i-- )
           {
             lastframetimes[i] = lastframetimes[i-1];
             frametimeave += lastframetimes[i];
           }
-          lastframetimes[0] = now-then;
+          lastframetimes[0] = pace_frame( &oric.pace, oric.vid_freq ? 50 : 60, !oric.warpspeed );
           frametimeave = (frametimeave+lastframetimes[0])/FRAMES_TO_AVERAGE;
-
-          if (warpspeed)
-          {
-            nextframe_ms = now;
-            nextframe_us = ((Uint64)nextframe_ms)*1000;
-          }
-          else
-          {
-            if (now > nextframe_ms)
-            {
-              nextframe_ms = now;
-              nextframe_us = ((Uint64)nextframe_ms)*1000;
-            }
-            else
-            {
-              SDL_Delay(nextframe_ms-now);
-            }
-          }
           framedone = SDL_FALSE;
         }
 
@@ -1429,6 +1826,8 @@ int main( int argc, char *argv[] )
       }
 
       do {
+        render_sw_mapmouse( &event );
+
         switch( event.type )
         {
           case SDL_COMPAT_ACTIVEEVENT:
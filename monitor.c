@@ -76,7 +76,6 @@ static struct click leftclick[2];
 extern struct textzone *tz[];
 extern char vsptmp[];
 extern char snappath[], filetmp[];
-extern SDL_bool refreshstatus;
 
 static char distmp[128];
 static unsigned short disaddrs[10];
@@ -653,30 +652,20 @@ static int bp_at( struct machine *oric, unsigned short addr, int *xbp, int *mbp
   if( xbp ) *xbp = -1;
   if( mbp ) *mbp = -1;
 
-  oric->cpu.anybp = SDL_FALSE;
-  for( i=0; i<16; i++ )
+  i = m6502_findbp( &oric->cpu, addr );
+  if( i != -1 )
   {
-    if( oric->cpu.breakpoints[i] != -1 )
-    {
-      oric->cpu.anybp = SDL_TRUE;
-      if( addr == oric->cpu.breakpoints[i] )
-      {
-        bpmask |= 8;
-        if( xbp ) *xbp = i;
-        break;
-      }
-    }
+    bpmask |= 8;
+    if( xbp ) *xbp = i;
   }
 
-  oric->cpu.anymbp = SDL_FALSE;
-  for( i=0; i<16; i++ )
+  if( oric->cpu.mbppages[addr>>8] )
   {
-    if( oric->cpu.membreakpoints[i].flags )
+    for( i=0; i<oric->cpu.nummbps; i++ )
     {
-      oric->cpu.anymbp = SDL_TRUE;
-      if( oric->cpu.membreakpoints[i].addr == addr )
+      if( ( addr >= oric->cpu.mbps[i].addr ) && ( addr <= oric->cpu.mbps[i].end ) )
       {
-        bpmask |= oric->cpu.membreakpoints[i].flags;
+        bpmask |= oric->cpu.mbps[i].flags;
         if( mbp ) *mbp = i;
         break;
       }
@@ -689,6 +678,10 @@ static int bp_at( struct machine *oric, unsigned short addr, int *xbp, int *mbp
 // Don't mess with registers that change because you read them!
 unsigned char mon_read( struct machine *oric, unsigned short addr )
 {
+  // Plain memory directly, so looking doesn't show up in the coverage
+  if( oric->mapread[addr>>8] )
+    return oric->mapread[addr>>8][addr&0xff];
+
   // microdisc registers could screw things up
   if( oric->drivetype == DRV_MICRODISC )
   {
@@ -2541,6 +2534,121 @@ SDL_bool mon_new_symbols( struct symboltable *stab, struct machine *oric, char *
   return SDL_TRUE;
 }
 
+static void mon_show_bp( struct machine *oric, int id )
+{
+  if( oric->cpu.bps[id].bank == BPBANK_ANY )
+    mon_printf( "%02d: $%04X", id, oric->cpu.bps[id].addr );
+  else
+    mon_printf( "%02d: $%04X bank %d", id, oric->cpu.bps[id].addr, oric->cpu.bps[id].bank );
+}
+
+static void mon_show_mbp( struct machine *oric, int id )
+{
+  struct membreakpoint *mbp = &oric->cpu.mbps[id];
+
+  if( mbp->end != mbp->addr )
+    mon_printf( "m%02d: $%04X-$%04X %s%s%s", id, mbp->addr, mbp->end,
+      (mbp->flags&MBPF_READ) ? "r" : "",
+      (mbp->flags&MBPF_WRITE) ? "w" : "",
+      (mbp->flags&MBPF_CHANGE) ? "c" : "" );
+  else
+    mon_printf( "m%02d: $%04X %s%s%s", id, mbp->addr,
+      (mbp->flags&MBPF_READ) ? "r" : "",
+      (mbp->flags&MBPF_WRITE) ? "w" : "",
+      (mbp->flags&MBPF_CHANGE) ? "c" : "" );
+}
+
+// Set a breakpoint at every address in a file. Each line can be
+// an address followed by an optional bank, or a line from a
+// symbol file that "sl" understands.
+static void mon_bps_from_file( struct machine *oric, char *fname )
+{
+  FILE *f;
+  int i, j, count, bank;
+  unsigned int v;
+  char linetmp[256];
+
+  f = fopen( fname, "r" );
+  if( !f )
+  {
+    mon_printf( "Unable to open '%s'", fname );
+    return;
+  }
+
+  count = 0;
+  while( fgets( linetmp, 256, f ) )
+  {
+    bank = BPBANK_ANY;
+    if( sscanf( linetmp, "al %06X", &v ) != 1 )
+    {
+      for( i=0, v=0; i<4; i++ )
+      {
+        j = hexit( linetmp[i] );
+        if( j == -1 ) break;
+        v = (v<<4)|j;
+      }
+
+      if( ( i < 4 ) || ( issymchar( linetmp[4] ) ) )
+      {
+        // Not a symbol file line. Try an address (or symbol name).
+        i = 0;
+        while( isws( linetmp[i] ) ) i++;
+        if( ( linetmp[i] == 0 ) || ( linetmp[i] == '\n' ) || ( linetmp[i] == ';' ) ) continue;
+        if( !mon_getnum( oric, &v, linetmp, &i, SDL_TRUE, SDL_FALSE, SDL_FALSE, SDL_TRUE ) ) continue;
+      }
+      else
+      {
+        i = 4;
+      }
+
+      // Optional bank after the address
+      while( isws( linetmp[i] ) ) i++;
+      if( ( linetmp[i] >= '0' ) && ( linetmp[i] <= '7' ) && ( !issymchar( linetmp[i+1] ) ) )
+        bank = linetmp[i]-'0';
+    }
+
+    if( m6502_addbp( &oric->cpu, v & 0xffff, bank ) == -1 )
+    {
+      mon_str( "Out of memory" );
+      break;
+    }
+    count++;
+  }
+
+  fclose( f );
+  mon_printf( "%d breakpoints set from '%s'", count, fname );
+}
+
+// Pacing is always measured, stats on or not
+static void mon_show_pace( struct machine *oric )
+{
+  struct framepacer *fp = &oric->pace;
+
+  mon_printf( "Jitter %u/%u/%u us (last/average/max)",
+    fp->lastjit, fp->jitframes ? (unsigned int)( fp->jitsum / fp->jitframes ) : 0, fp->maxjit );
+  mon_printf( "  %u frames, %u resyncs, spin %u us",
+    fp->jitframes, fp->resyncs, fp->spinus );
+}
+
+// The hot path figures for the last frame, and averaged since the reset
+static void mon_show_stats( struct machine *oric )
+{
+  struct perfstats *st = &oric->stats;
+  int i;
+
+  mon_printf( "Stats %s, %u frames%s", st->on ? "on" : "off", st->frames, st->log ? ", logging" : "" );
+  mon_show_pace( oric );
+  if( !st->frames ) return;
+
+  mon_str( "               last frame    average" );
+  for( i=0; i<STAT_NUMCOUNTS; i++ )
+    mon_printf( "  %-12s %10u %10llu", stats_name( i, SDL_FALSE ), st->lastcount[i],
+      (unsigned long long)( ( st->markcount[i] - st->basecount[i] ) / st->frames ) );
+  for( i=0; i<STAT_NUMTIMES; i++ )
+    mon_printf( "  %-12s %10u %10llu", stats_name( i, SDL_TRUE ), st->lastus[i],
+      (unsigned long long)( ( st->markus[i] - st->baseus[i] ) / st->frames ) );
+}
+
 SDL_bool mon_cmd( char *cmd, struct machine *oric, SDL_bool *needrender )
 {
   int i, j, k, l;
@@ -2715,49 +2823,18 @@ SDL_bool mon_cmd( char *cmd, struct machine *oric, SDL_bool *needrender )
         case 'l':
           if( cmd[i+1] == 'm' )
           {
-            oric->cpu.anymbp = SDL_FALSE;
-            for( j=0; j<16; j++ )
-            {
-              if( oric->cpu.membreakpoints[j].flags )
-              {
-                mon_printf( "%02d: $%04X %c%c%c",
-                  j,
-                  oric->cpu.membreakpoints[j].addr,
-                  (oric->cpu.membreakpoints[j].flags&MBPF_READ) ? 'r' : ' ',
-                  (oric->cpu.membreakpoints[j].flags&MBPF_WRITE) ? 'w' : ' ',
-                  (oric->cpu.membreakpoints[j].flags&MBPF_CHANGE) ? 'c' : ' ' );
-                oric->cpu.anymbp = SDL_TRUE;
-              }
-            }
+            for( j=0; j<oric->cpu.nummbps; j++ )
+              mon_show_mbp( oric, j );
             break;
           }
 
-          oric->cpu.anybp = SDL_FALSE;
-          for( j=0; j<16; j++ )
-          {
-            if( oric->cpu.breakpoints[j] != -1 )
-            {
-              mon_printf( "%02d: $%04X", j, oric->cpu.breakpoints[j] );
-              oric->cpu.anybp = SDL_TRUE;
-            }
-          }
+          for( j=0; j<oric->cpu.numbps; j++ )
+            mon_show_bp( oric, j );
           break;
 
         case 's':
           if( cmd[i+1] == 'm' )
           {
-            for( j=0; j<16; j++ )
-            {
-              if( oric->cpu.membreakpoints[j].flags == 0 )
-                break;
-            }
-
-            if( j == 16 )
-            {
-              mon_str( "Max 16 breakpoints" );
-              break;
-            }
-
             i += 2;
             if( !mon_getnum( oric, &v, cmd, &i, SDL_TRUE, SDL_TRUE, SDL_TRUE, SDL_TRUE ) )
             {
@@ -2765,54 +2842,67 @@ SDL_bool mon_cmd( char *cmd, struct machine *oric, SDL_bool *needrender )
               break;
             }
 
-            oric->cpu.membreakpoints[j].addr = v & 0xffff;
-            oric->cpu.membreakpoints[j].lastval = mon_read( oric, v&0xffff );
-            oric->cpu.membreakpoints[j].flags = 0;
-
+            // Optional end address
+            w = v;
             while( isws( cmd[i] ) ) i++;
+            if( ( cmd[i] == '$' ) || ( cmd[i] == '%' ) || ( isnum( cmd[i] ) ) )
+            {
+              if( ( !mon_getnum( oric, &w, cmd, &i, SDL_FALSE, SDL_FALSE, SDL_FALSE, SDL_FALSE ) ) || ( (w&0xffff) < (v&0xffff) ) )
+              {
+                mon_str( "Invalid end address" );
+                break;
+              }
+              while( isws( cmd[i] ) ) i++;
+            }
 
+            k = 0;
             for( ;; )
             {
               switch( cmd[i] )
               {
                 case 'r':
-                  oric->cpu.membreakpoints[j].flags |= MBPF_READ;
+                  k |= MBPF_READ;
                   i++;
                   continue;
 
                 case 'w':
-                  oric->cpu.membreakpoints[j].flags |= MBPF_WRITE;
+                  k |= MBPF_WRITE;
                   i++;
                   continue;
 
                 case 'c':
-                  oric->cpu.membreakpoints[j].flags |= MBPF_CHANGE;
+                  k |= MBPF_CHANGE;
                   i++;
                   continue;
               }
               break;
             }
 
-            if( !oric->cpu.membreakpoints[j].flags )
-              oric->cpu.membreakpoints[j].flags = MBPF_READ|MBPF_WRITE;
-            oric->cpu.anymbp = SDL_TRUE;
+            if( !k )
+              k = MBPF_READ|MBPF_WRITE;
 
-            mon_printf( "m%02d: $%04X %s%s%s", j, oric->cpu.membreakpoints[j].addr,
-              (oric->cpu.membreakpoints[j].flags&MBPF_READ) ? "r" : "",
-              (oric->cpu.membreakpoints[j].flags&MBPF_WRITE) ? "w" : "",
-              (oric->cpu.membreakpoints[j].flags&MBPF_CHANGE) ? "c" : "" );
+            j = m6502_addmbp( &oric->cpu, v & 0xffff, w & 0xffff, k );
+            if( j == -1 )
+            {
+              mon_str( "Out of memory" );
+              break;
+            }
+            setmemmap( oric );
+            mon_show_mbp( oric, j );
             break;
           }
 
-          for( j=0; j<16; j++ )
+          if( cmd[i+1] == 'f' )
           {
-            if( oric->cpu.breakpoints[j] == -1 )
+            if( !isws( cmd[i+2] ) )
+            {
+              mon_str( "???" );
               break;
-          }
+            }
 
-          if( j == 16 )
-          {
-            mon_str( "Max 16 breakpoints" );
+            i+=3;
+            while( isws( cmd[i] ) ) i++;
+            mon_bps_from_file( oric, &cmd[i] );
             break;
           }
 
@@ -2823,9 +2913,26 @@ SDL_bool mon_cmd( char *cmd, struct machine *oric, SDL_bool *needrender )
             break;
           }
 
-          oric->cpu.breakpoints[j] = v & 0xffff;
-          oric->cpu.anybp = SDL_TRUE;
-          mon_printf( "%02d: $%04X", j, oric->cpu.breakpoints[j] );
+          // Optional bank
+          k = BPBANK_ANY;
+          while( isws( cmd[i] ) ) i++;
+          if( cmd[i] )
+          {
+            if( ( !mon_getnum( oric, &w, cmd, &i, SDL_FALSE, SDL_FALSE, SDL_FALSE, SDL_FALSE ) ) || ( w > 7 ) )
+            {
+              mon_str( "Invalid bank" );
+              break;
+            }
+            k = w;
+          }
+
+          j = m6502_addbp( &oric->cpu, v & 0xffff, k );
+          if( j == -1 )
+          {
+            mon_str( "Out of memory" );
+            break;
+          }
+          mon_show_bp( oric, j );
           break;
 
         case 'c':
@@ -2843,7 +2950,7 @@ SDL_bool mon_cmd( char *cmd, struct machine *oric, SDL_bool *needrender )
             break;
           }
 
-          if( v > 15 )
+          if( v >= ( j ? oric->cpu.nummbps : oric->cpu.numbps ) )
           {
             mon_str( "Invalid breakpoint ID" );
             break;
@@ -2851,43 +2958,23 @@ SDL_bool mon_cmd( char *cmd, struct machine *oric, SDL_bool *needrender )
 
           if( j )
           {
-            oric->cpu.membreakpoints[v].flags = 0;
-            oric->cpu.anymbp = SDL_FALSE;
-            for( j=0; j<16; j++ )
-            {
-              if( oric->cpu.membreakpoints[j].flags != 0 )
-              {
-                oric->cpu.anymbp = SDL_TRUE;
-                break;
-              }
-            }
+            m6502_delmbp( &oric->cpu, v );
+            setmemmap( oric );
             break;
           }
 
-          oric->cpu.breakpoints[v] = -1;
-          oric->cpu.anybp = SDL_FALSE;
-          for( j=0; j<16; j++ )
-          {
-            if( oric->cpu.breakpoints[j] != -1 )
-            {
-              oric->cpu.anybp = SDL_TRUE;
-              break;
-            }
-          }
+          m6502_delbp( &oric->cpu, v );
           break;
 
         case 'z':
           if( cmd[i+1] == 'm' )
           {
-            for( i=0; i<16; i++ )
-              oric->cpu.membreakpoints[i].flags = 0;
-            oric->cpu.anymbp = SDL_FALSE;
+            m6502_clearmbps( &oric->cpu );
+            setmemmap( oric );
             break;
           }
 
-          for( i=0; i<16; i++ )
-            oric->cpu.breakpoints[i] = -1;
-          oric->cpu.anybp = SDL_FALSE;
+          m6502_clearbps( &oric->cpu );
           break;
 
         default:
@@ -3171,6 +3258,307 @@ SDL_bool mon_cmd( char *cmd, struct machine *oric, SDL_bool *needrender )
       }
       break;
 
+    case 'i': // Hot path stats
+      lastcmd = 0;
+      i++;
+      switch( cmd[i] )
+      {
+        case 0:
+          mon_show_stats( oric );
+          break;
+
+        case 'n':
+          stats_enable( oric, SDL_TRUE );
+          mon_str( "Stats on" );
+          break;
+
+        case 'f':
+          stats_stoplog( oric );
+          stats_enable( oric, SDL_FALSE );
+          mon_str( "Stats off" );
+          break;
+
+        case 'r':
+          stats_reset( oric );
+          mon_str( "Stats reset" );
+          break;
+
+        case 'l':
+          i++;
+          while( isws( cmd[i] ) ) i++;
+          if( !cmd[i] )
+          {
+            stats_stoplog( oric );
+            mon_str( "Stats log closed" );
+            break;
+          }
+
+          if( !mon_getnum( oric, &v, cmd, &i, SDL_FALSE, SDL_FALSE, SDL_FALSE, SDL_FALSE ) )
+          {
+            mon_str( "Frame count expected" );
+            break;
+          }
+
+          while( isws( cmd[i] ) ) i++;
+          if( !cmd[i] )
+          {
+            mon_str( "Filename expected" );
+            break;
+          }
+
+          if( !stats_startlog( oric, &cmd[i], v ) )
+          {
+            mon_printf( "Unable to write '%s'", &cmd[i] );
+            break;
+          }
+          mon_printf( "Logging stats every %u frames", v );
+          break;
+
+        default:
+          mon_str( "???" );
+          break;
+      }
+      break;
+
+    case 'p': // Profiler
+      lastcmd = 0;
+      i++;
+      j = cmd[i];
+      switch( j )
+      {
+        case 0:
+          profile_show( oric, 16 );
+          break;
+
+        case 'n':
+          if( !profile_start( oric ) )
+          {
+            mon_str( "Out of memory" );
+            break;
+          }
+          mon_str( "Profiler on" );
+          break;
+
+        case 'f':
+          profile_stop( oric );
+          mon_str( "Profiler off" );
+          break;
+
+        case 'r':
+          profile_reset( oric );
+          mon_str( "Profile reset" );
+          break;
+
+        case 'c':
+          profile_showcalls( oric, 16 );
+          break;
+
+        case 'g':
+        case 'w':
+        case 'x':
+          i++;
+          while( isws( cmd[i] ) ) i++;
+          if( !cmd[i] )
+          {
+            mon_str( "Filename expected" );
+            break;
+          }
+
+          if( !oric->prof.cycles )
+          {
+            mon_str( "Profiler off" );
+            break;
+          }
+
+          switch( j )
+          {
+            case 'g': k = profile_folded( oric, &cmd[i] ); break;
+            case 'w': k = profile_report( oric, &cmd[i] ); break;
+            default:  k = profile_flat( oric, &cmd[i] ); break;
+          }
+
+          if( !k )
+          {
+            mon_printf( "Unable to write '%s'", &cmd[i] );
+            break;
+          }
+          mon_printf( "Written '%s'", &cmd[i] );
+          break;
+
+        default:
+          mon_str( "???" );
+          break;
+      }
+      break;
+
+    case 't': // Trace
+      lastcmd = 0;
+      i++;
+      j = cmd[i];
+      switch( j )
+      {
+        case 0:
+          trace_show( oric );
+          break;
+
+        case 'n':
+          i++;
+          v = oric->trace.buf ? oric->trace.size : TRACE_DEFSIZE;
+          if( ( mon_getnum( oric, &w, cmd, &i, SDL_FALSE, SDL_FALSE, SDL_FALSE, SDL_FALSE ) ) && ( w ) )
+            v = w;
+
+          if( oric->trace.thread )
+          {
+            mon_str( "Close the trace file first" );
+            break;
+          }
+
+          if( !trace_start( oric, v ) )
+          {
+            mon_str( "Out of memory" );
+            break;
+          }
+          mon_printf( "Tracing the last %u instructions", oric->trace.size );
+          break;
+
+        case 'f':
+          trace_stop( oric );
+          mon_str( "Trace off" );
+          break;
+
+        case 'l':
+          i++;
+          v = 16;
+          if( ( mon_getnum( oric, &w, cmd, &i, SDL_FALSE, SDL_FALSE, SDL_FALSE, SDL_FALSE ) ) && ( w ) )
+            v = w;
+          trace_list( oric, v );
+          break;
+
+        case 's':
+          i++;
+          if( !mon_getnum( oric, &v, cmd, &i, SDL_TRUE, SDL_FALSE, SDL_FALSE, SDL_TRUE ) )
+          {
+            mon_str( "Address expected" );
+            break;
+          }
+          trace_search( oric, v & 0xffff, 16 );
+          break;
+
+        case 'c':
+          if( !oric->trace.thread )
+          {
+            mon_str( "No trace file open" );
+            break;
+          }
+          trace_endstream( oric );
+          mon_printf( "Written %llu records", (unsigned long long)oric->trace.streamed );
+          break;
+
+        case 'o':
+        case 'w':
+          i++;
+          while( isws( cmd[i] ) ) i++;
+          if( !cmd[i] )
+          {
+            mon_str( "Filename expected" );
+            break;
+          }
+
+          if( j == 'o' )
+          {
+            if( !trace_stream( oric, &cmd[i] ) )
+            {
+              mon_printf( "Unable to trace to '%s'", &cmd[i] );
+              break;
+            }
+            mon_printf( "Tracing to '%s'", &cmd[i] );
+            break;
+          }
+
+          if( !oric->trace.buf )
+          {
+            mon_str( "Trace off" );
+            break;
+          }
+
+          if( !trace_dump( oric, &cmd[i] ) )
+          {
+            mon_printf( "Unable to write '%s'", &cmd[i] );
+            break;
+          }
+          mon_printf( "Written '%s'", &cmd[i] );
+          break;
+
+        default:
+          mon_str( "???" );
+          break;
+      }
+      break;
+
+    case 'c': // Coverage
+      lastcmd = 0;
+      i++;
+      j = cmd[i];
+      switch( j )
+      {
+        case 0:
+          coverage_show( oric );
+          break;
+
+        case 'n':
+          if( !coverage_start( oric ) )
+          {
+            mon_str( "Out of memory" );
+            break;
+          }
+          mon_str( "Coverage on" );
+          break;
+
+        case 'f':
+          coverage_stop( oric );
+          mon_str( "Coverage off" );
+          break;
+
+        case 'r':
+          coverage_reset( oric );
+          mon_str( "Coverage reset" );
+          break;
+
+        case 'w':
+        case 'x':
+          i++;
+          while( isws( cmd[i] ) ) i++;
+          if( !cmd[i] )
+          {
+            mon_str( "Filename expected" );
+            break;
+          }
+
+          if( !oric->cov.map )
+          {
+            mon_str( "Coverage off" );
+            break;
+          }
+
+          if( j == 'w' )
+            k = coverage_save( oric, &cmd[i] );
+          else
+            k = coverage_savemap( oric, &cmd[i] );
+
+          if( !k )
+          {
+            mon_printf( "Unable to write '%s'", &cmd[i] );
+            break;
+          }
+          mon_printf( "Written '%s'", &cmd[i] );
+          break;
+
+        default:
+          mon_str( "???" );
+          break;
+      }
+      break;
+
     case 'n':
       lastcmd = 0;
       i++;
@@ -3228,8 +3616,9 @@ SDL_bool mon_cmd( char *cmd, struct machine *oric, SDL_bool *needrender )
           mon_str( "  bcm <bp id>           - Clear mem breakpoint" );
           mon_str( "  bl                    - List breakpoints" );
           mon_str( "  blm                   - List mem breakpoints" );
-          mon_str( "  bs <addr>             - Set breakpoint" );
-          mon_str( "  bsm <addr> [rwc]      - Set mem breakpoint" );
+          mon_str( "  bs <addr> [bank]      - Set breakpoint" );
+          mon_str( "  bsf <file>            - Set bps from file" );
+          mon_str( "  bsm <addr> [end] [rwc]- Set mem breakpoint" );
           mon_str( "  bz                    - Zap breakpoints" );
           mon_str( "  bzm                   - Zap mem breakpoints" );
           mon_str( "  d <addr>              - Disassemble" );
@@ -3239,6 +3628,8 @@ SDL_bool mon_cmd( char *cmd, struct machine *oric, SDL_bool *needrender )
 
         case 1:
           mon_str( "  df <addr> <end> <file>- Disassemble to file" );
+          mon_str( "  i, in, if, ir         - Stats, on, off, reset" );
+          mon_str( "  il <frames> <file>    - Log stats to CSV file" );
           mon_str( "  m <addr>              - Dump memory" );
           mon_str( "  mm <addr> <value>     - Modify memory" );
           mon_str( "  mw <addr>             - Memory watch at addr" );
@@ -3254,6 +3645,24 @@ SDL_bool mon_cmd( char *cmd, struct machine *oric, SDL_bool *needrender )
           mon_str( "  sl <file>             - Load user symbols" );
           mon_str( "  sx <file>             - Export user symbols" );
           mon_str( "  sz                    - Zap user symbols" );
+          mon_str( "---- MORE" );
+          helpcount++;
+          break;
+
+        case 2:
+          mon_str( "  c, cn, cf, cr         - Coverage, on, off, reset" );
+          mon_str( "  cw <file>             - Write coverage ranges" );
+          mon_str( "  cx <file>             - Write raw coverage map" );
+          mon_str( "  p, pn, pf, pr         - Profile, on, off, reset" );
+          mon_str( "  pc                    - Show profile by calls" );
+          mon_str( "  pg <file>             - Write call stacks" );
+          mon_str( "  pw <file>             - Write profile report" );
+          mon_str( "  px <file>             - Export profile as CSV" );
+          mon_str( "  t, tn [size], tf      - Trace, on, off" );
+          mon_str( "  tl [n]                - List last n instructions" );
+          mon_str( "  ts <addr>             - Search trace for addr" );
+          mon_str( "  tw <file>             - Write trace as text" );
+          mon_str( "  to <file>, tc         - Stream trace to file, close" );
           mon_str( "  wm <addr> <len> <file>- Write mem to disk" );
           helpcount = 0;
           lastcmd = 0;
@@ -3918,6 +4327,8 @@ static unsigned int steppy_step( struct machine *oric )
 {
   m6502_set_icycles( &oric->cpu, SDL_FALSE, mon_bpmsg );
   tape_patches( oric );
+  ay_patches( &oric->ay );
+  ay_logtime( &oric->ay, oric->cpu.icycles );
   via_clock( &oric->via, oric->cpu.icycles );
   ay_ticktock( &oric->ay, oric->cpu.icycles );
   if((oric->drivetype == DRV_MICRODISC) || (oric->drivetype == DRV_JASMIN)) wd17xx_ticktock( &oric->wddisk, oric->cpu.icycles );
@@ -4019,7 +4430,7 @@ SDL_bool mon_event( SDL_Event *ev, struct machine *oric, SDL_bool *needrender )
           break;
 
         case SDLK_F1:
-          refreshstatus = SDL_TRUE;
+          oric->refreshstatus = SDL_TRUE;
           *needrender = SDL_TRUE;
           mon_store_state( oric );
           ula_set_dirty( oric );
@@ -4030,6 +4441,8 @@ SDL_bool mon_event( SDL_Event *ev, struct machine *oric, SDL_bool *needrender )
           // In case we're on a breakpoint
           m6502_set_icycles( &oric->cpu, SDL_FALSE, mon_bpmsg );
           tape_patches( oric );
+          ay_patches( &oric->ay );
+          ay_logtime( &oric->ay, oric->cpu.icycles );
           via_clock( &oric->via, oric->cpu.icycles );
           ay_ticktock( &oric->ay, oric->cpu.icycles );
           if((oric->drivetype == DRV_MICRODISC) || (oric->drivetype == DRV_JASMIN)) wd17xx_ticktock( &oric->wddisk, oric->cpu.icycles );
@@ -4165,75 +4578,45 @@ SDL_bool mon_event( SDL_Event *ev, struct machine *oric, SDL_bool *needrender )
   return done;
 }
 
-
-#if defined(DEBUG_CPU_TRACE) && DEBUG_CPU_TRACE > 0
-struct cpu_trace_entry cputrace[DEBUG_CPU_TRACE], *list_start = NULL, *list_end, *next = NULL;
-
-void mon_traceinst(struct m6502 *cpu)
-{
-  struct machine *oric = (struct machine *)cpu->userdata;
-
-  if (!list_start)
-  {
-    int i;
-    list_start = &cputrace[0];
-    list_end = &cputrace[DEBUG_CPU_TRACE-1];
-    for (i=0; i<DEBUG_CPU_TRACE; i++)
-    {
-      cputrace[i].prev = (i==0) ? NULL : &cputrace[i-1];
-      cputrace[i].next = (i==(DEBUG_CPU_TRACE-1)) ? NULL : &cputrace[i+1];
-    }
-    next = list_start;
-  }
-
-  /* Quicker than shuffling an array... */
-  if (next == NULL)
-  {
-    next = list_start;
-    list_start = list_start->next;
-    list_end->next = next;
-    next->prev = list_end;
-    next->next = NULL;
-    list_start->prev = NULL;
-    list_end = next;
-  }
-
-  next->pc    = cpu->calcpc;
-  next->a     = cpu->a;
-  next->x     = cpu->x;
-  next->y     = cpu->y;
-  next->sp    = cpu->sp;
-  next->flags = MAKEFLAGS;
-  next->inst[0] = mon_read(oric, cpu->calcpc);
-  next->inst[1] = mon_read(oric, cpu->calcpc+1);
-  next->inst[2] = mon_read(oric, cpu->calcpc+2);
-  next->romdis = oric->romdis;
-  if( ( oric->drivetype == DRV_JASMIN ) && ( oric->jasmin.olay ) )
-    next->romdis = SDL_FALSE;
-  next = next->next;
-}
-
-char *cputrace_print( struct machine *oric, struct cpu_trace_entry *cte )
+/*
+** Disassemble an instruction from the trace, with the symbols of
+** the bank it ran in. brief leaves out the symbol column and most
+** of the registers, to fit the monitor console.
+*/
+char *mon_traceprint( struct machine *oric, struct m6502_tracerec *cte, SDL_bool brief )
 {
+  static char tracetmp[256];
   unsigned short iaddr, addr;
   unsigned char op, a1, a2;
-  int i;
+  int i, currbank;
   char *tmpsname, *disptr;
   char sname[SNAME_LEN+1];
   struct msym *csym;
+  SDL_bool romdis;
 
-  disptr = distmp;
+  disptr = tracetmp;
+
+  // Look the symbols up as if the bank was switched in
+  currbank = oric->tele_currbank;
+  romdis = SDL_FALSE;
+  if( cte->bank != TRACE_NOBANK )
+  {
+    if( oric->type == MACH_TELESTRAT )
+      oric->tele_currbank = cte->bank & 7;
+    else
+      romdis = ( cte->bank != 0 );
+  }
 
   tmpsname = "";
-  csym = mon_find_sym_by_addr( oric, cte->pc, &cte->romdis );
+  csym = brief ? NULL : mon_find_sym_by_addr( oric, cte->pc, &romdis );
   if( csym )
   {
     tmpsname = csym->name;
 
     if( strlen( tmpsname ) > SNAME_LEN )
     {
-      sprintf( distmp, "%s\n", tmpsname );
-      disptr = &distmp[strlen(distmp)];
+      sprintf( tracetmp, "%s\n", tmpsname );
+      disptr = &tracetmp[strlen(tracetmp)];
       tmpsname = "";
     }
   }
@@ -4244,9 +4627,9 @@ char *cputrace_print( struct machine *oric, struct cpu_trace_entry *cte )
   sname[i] = 0;
 
   iaddr = cte->pc;
-  op = cte->inst[0];
-  a1 = cte->inst[1];
-  a2 = cte->inst[2];
+  op = cte->op[0];
+  a1 = cte->op[1];
+  a2 = cte->op[2];
   switch( distab[op].amode )
   {
     case AM_IMP:
@@ -4260,7 +4643,7 @@ char *cputrace_print( struct machine *oric, struct cpu_trace_entry *cte )
     case AM_ZP:
     case AM_ZPX:
     case AM_ZPY:
-      csym = mon_find_sym_by_addr( oric, a1, &cte->romdis );
+      csym = mon_find_sym_by_addr( oric, a1, &romdis );
       if( csym )
         sprintf( disptr, "%s   %04X  %02X %02X     %s %s", sname, iaddr, op, a1, distab[op].name, csym->name );
       else
@@ -4272,7 +4655,7 @@ char *cputrace_print( struct machine *oric, struct cpu_trace_entry *cte )
     case AM_ABS:
     case AM_ABX:
     case AM_ABY:
-      csym = mon_find_sym_by_addr( oric, (a2<<8)|a1, &cte->romdis );
+      csym = mon_find_sym_by_addr( oric, (a2<<8)|a1, &romdis );
       if( csym )
         sprintf( disptr, "%s   %04X  %02X %02X %02X  %s %s", sname, iaddr, op, a1, a2, distab[op].name, csym->name );
       else
@@ -4282,7 +4665,7 @@ char *cputrace_print( struct machine *oric, struct cpu_trace_entry *cte )
       break;
 
     case AM_ZIX:
-      csym = mon_find_sym_by_addr( oric, a1, &cte->romdis );
+      csym = mon_find_sym_by_addr( oric, a1, &romdis );
       if( csym )
         sprintf( disptr, "%s   %04X  %02X %02X     %s (%s,X)", sname, iaddr, op, a1, distab[op].name, csym->name );
       else
@@ -4290,7 +4673,7 @@ char *cputrace_print( struct machine *oric, struct cpu_trace_entry *cte )
       break;
 
     case AM_ZIY:
-      csym = mon_find_sym_by_addr( oric, a1, &cte->romdis );
+      csym = mon_find_sym_by_addr( oric, a1, &romdis );
       if( csym )
         sprintf( disptr, "%s   %04X  %02X %02X     %s (%s),Y", sname, iaddr, op, a1, distab[op].name, csym->name );
       else
@@ -4299,7 +4682,7 @@ char *cputrace_print( struct machine *oric, struct cpu_trace_entry *cte )
 
     case AM_REL:
       addr = ((cte->pc+2)+((signed char)a1))&0xffff;
-      csym = mon_find_sym_by_addr( oric, addr, &cte->romdis );
+      csym = mon_find_sym_by_addr( oric, addr, &romdis );
       if( csym )
         sprintf( disptr, "%s   %04X  %02X %02X     %s %s", sname, iaddr, op, a1, distab[op].name, csym->name );
       else
@@ -4307,7 +4690,7 @@ char *cputrace_print( struct machine *oric, struct cpu_trace_entry *cte )
       break;
 
     case AM_IND:
-      csym = mon_find_sym_by_addr( oric, (a2<<8)|a1, &cte->romdis );
+      csym = mon_find_sym_by_addr( oric, (a2<<8)|a1, &romdis );
       if( csym )
         sprintf( disptr, "%s   %04X  %02X %02X %02X  %s (%s)", sname, iaddr, op, a1, a2, distab[op].name, csym->name );
       else
@@ -4319,35 +4702,41 @@ char *cputrace_print( struct machine *oric, struct cpu_trace_entry *cte )
       break;
   }
 
+  oric->tele_currbank = currbank;
+
+  if( brief )
+  {
+    // Lose the empty symbol column
+    if( strlen( disptr ) > SNAME_LEN+3 )
+      memmove( disptr, &disptr[SNAME_LEN+3], strlen( &disptr[SNAME_LEN+3] )+1 );
+
+    for( i=strlen(disptr); i<30; i++ )
+      disptr[i] = 32;
+    sprintf( &disptr[30], " A=%02X X=%02X Y=%02X", cte->a, cte->x, cte->y );
+    return tracetmp;
+  }
+
   for( i=strlen(disptr); i<60; i++ )
     disptr[i] = 32;
   disptr[i] = 0;
 
-  sprintf(&disptr[60], "%c%c-%c%c%c%c%c A=%02X X=%02X Y=%02X SP=%04X ROMDIS=%d",
-    (cte->flags&0x80) ? 'N' : '-',
-    (cte->flags&0x40) ? 'V' : '-',
-    (cte->flags&0x10) ? 'B' : '-',
-    (cte->flags&0x08) ? 'D' : '-',
-    (cte->flags&0x04) ? 'I' : '-',
-    (cte->flags&0x02) ? 'Z' : '-',
-    (cte->flags&0x01) ? 'C' : '-',
+  sprintf(&disptr[60], "%c%c-%c%c%c%c%c A=%02X X=%02X Y=%02X SP=%04X CYC=%08X%s%s",
+    (cte->p&0x80) ? 'N' : '-',
+    (cte->p&0x40) ? 'V' : '-',
+    (cte->p&0x10) ? 'B' : '-',
+    (cte->p&0x08) ? 'D' : '-',
+    (cte->p&0x04) ? 'I' : '-',
+    (cte->p&0x02) ? 'Z' : '-',
+    (cte->p&0x01) ? 'C' : '-',
     cte->a,
     cte->x,
     cte->y,
     cte->sp+0x100,
-    cte->romdis);
+    cte->cycles,
+    (cte->intr==1) ? " IRQ" : ((cte->intr==2) ? " NMI" : ""),
+    (cte->bank==TRACE_NOBANK) ? "" : ((oric->type==MACH_TELESTRAT) ? " BANK=" : " ROMDIS="));
+  if( cte->bank != TRACE_NOBANK )
+    sprintf( &disptr[strlen(disptr)], "%d", cte->bank );
 
-  return distmp;
+  return tracetmp;
 }
-
-void dump_cputrace(struct machine *oric)
-{
-  struct cpu_trace_entry *iter = list_start;
-
-  while (iter != next)
-  {
-    printf("%s\n", cputrace_print(oric, iter));
-    iter = iter->next;
-  }
-}
-#endif
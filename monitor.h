@@ -78,25 +78,17 @@ void mon_update( struct machine *oric );
 SDL_bool mon_event( SDL_Event *ev, struct machine *oric, SDL_bool *needrender );
 void dbg_printf( char *fmt, ... );
 void mon_printf_above( char *fmt, ... );
+void mon_printf( char *fmt, ... );
+void mon_str( char *str );
 void mon_enter( struct machine *oric );
 void mon_shut( struct machine *oric );
 void mon_init_symtab( struct symboltable *stab );
 void mon_freesyms( struct symboltable *stab );
+struct msym *mon_find_sym_by_addr( struct machine *oric, unsigned short addr, SDL_bool *override_romdis );
 SDL_bool mon_new_symbols( struct symboltable *stab, struct machine *oric, char *fname, unsigned short flags, SDL_bool above, SDL_bool verbose );
 SDL_bool mon_symsfromsnapshot( struct symboltable *stab, unsigned char *buffer, unsigned int len);
 void mon_state_reset( struct machine *oric );
 SDL_bool mon_getnum( struct machine *oric, unsigned int *num, char *buf, int *off, SDL_bool addrregs, SDL_bool nregs, SDL_bool viaregs, SDL_bool symbols );
 SDL_bool mon_do_cmd( char *cmd, struct machine *oric, SDL_bool *needrender );
 
-#if defined(DEBUG_CPU_TRACE) && DEBUG_CPU_TRACE > 0
-struct cpu_trace_entry
-{
-  struct cpu_trace_entry *next, *prev;
-  Uint16 pc;
-  Uint8  a, x, y, sp, flags;
-  Uint8  inst[3];
-  SDL_bool romdis;
-};
-void mon_traceinst(struct m6502 *cpu);
-void dump_cputrace(struct machine *oric);
-#endif
+char *mon_traceprint( struct machine *oric, struct m6502_tracerec *cte, SDL_bool brief );
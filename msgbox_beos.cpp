@@ -38,6 +38,7 @@ extern "C" {
 #include "6551.h"
 #include "machine.h"
 #include "msgbox.h"
+#include "headless.h"
 }
 
 SDL_bool init_msgbox( struct machine *oric )
@@ -51,6 +52,8 @@ void shut_msgbox( struct machine *oric )
 
 SDL_bool msgbox( struct machine *oric, int type, char *msg )
 {
+  if( oric->headless ) return headless_msgbox( oric, type, msg );
+
   switch( type )
   {
     case MSGBOX_YES_NO:
@@ -38,6 +38,7 @@
 #include "6551.h"
 #include "machine.h"
 #include "msgbox.h"
+#include "headless.h"
 
 extern SDL_bool fullscreen;
 void togglefullscreen( struct machine *oric, struct osdmenuitem *mitem, int dummy );
@@ -61,6 +62,8 @@ SDL_bool msgbox( struct machine *oric, int type, char *msg )
   gint res;
   SDL_bool was_fullscreen = fullscreen;
 
+  if( oric->headless ) return headless_msgbox( oric, type, msg );
+
   if (fullscreen)
     togglefullscreen(oric, NULL, 0);
 
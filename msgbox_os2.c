@@ -31,6 +31,7 @@
 #include "6551.h"
 #include "machine.h"
 #include "msgbox.h"
+#include "headless.h"
 
 SDL_bool init_msgbox( struct machine *oric )
 {
@@ -53,6 +54,8 @@ SDL_bool msgbox( struct machine *oric, int type, char *msg )
     btns,
     };
 
+  if( oric->headless ) return headless_msgbox( oric, type, msg );
+
   switch( type )
   {
     case MSGBOX_YES_NO:
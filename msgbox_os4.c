@@ -42,6 +42,7 @@
 #include "6551.h"
 #include "machine.h"
 #include "msgbox.h"
+#include "headless.h"
 
 struct Library *IntuitionBase = NULL;
 struct Library *RequesterBase = NULL;
@@ -96,6 +97,8 @@ SDL_bool msgbox( struct machine *oric, int type, char *msg )
   int32 result, imgtype=REQIMAGE_INFO;
   STRPTR btns = "huh?!";
 
+  if( oric->headless ) return headless_msgbox( oric, type, msg );
+
   switch( type )
   {
     case MSGBOX_YES_NO:
@@ -35,7 +35,9 @@
 #include "monitor.h"
 #include "6551.h"
 #include "machine.h"
+#include "render_sw.h"
 #include "msgbox.h"
+#include "headless.h"
 
 struct msgboxbut
 {
@@ -120,6 +122,8 @@ SDL_bool msgbox( struct machine *oric, int type, char *msg )
   SDL_Event event;
   SDL_bool wasunicode;
 
+  if( oric->headless ) return headless_msgbox( oric, type, msg );
+
   wasunicode = SDL_COMPAT_EnableUNICODE( SDL_TRUE );
   SDL_COMPAT_EnableKeyRepeat( SDL_DEFAULT_REPEAT_DELAY, SDL_DEFAULT_REPEAT_INTERVAL );
 
@@ -177,6 +181,7 @@ SDL_bool msgbox( struct machine *oric, int type, char *msg )
       SDL_COMPAT_EnableKeyRepeat( wasunicode ? SDL_DEFAULT_REPEAT_DELAY : 0, wasunicode ? SDL_DEFAULT_REPEAT_INTERVAL : 0 );
       return SDL_FALSE;
     }
+    render_sw_mapmouse( &event );
 
     switch( event.type )
     {
@@ -0,0 +1,143 @@
+/*
+**  Oricutron
+**  Copyright (C) 2009-2014 Peter Gordon
+**
+**  This program is free software; you can redistribute it and/or
+**  modify it under the terms of the GNU General Public License
+**  as published by the Free Software Foundation, version 2
+**  of the License.
+**
+**  This program is distributed in the hope that it will be useful,
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**  GNU General Public License for more details.
+**
+**  You should have received a copy of the GNU General Public License
+**  along with this program; if not, write to the Free Software
+**  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+**
+**  Frame pacing
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+
+#include "system.h"
+#include "pace.h"
+
+#define PACE_MINSPIN 200     // Spin at least this long (us)
+#define PACE_MAXSPIN 2000    // ...and at most this long
+#define PACE_RESYNC  2       // Frames behind before giving up on catching up
+
+// Restart the timeline from now
+void pace_reset( struct framepacer *fp )
+{
+  fp->start  = SDL_COMPAT_GetTicksUS();
+  fp->frames = 0;
+  fp->last   = fp->start;
+  if( !fp->spinus ) fp->spinus = PACE_MINSPIN*2;
+}
+
+void pace_clearstats( struct framepacer *fp )
+{
+  fp->jitframes = 0;
+  fp->jitsum    = 0;
+  fp->lastjit   = 0;
+  fp->maxjit    = 0;
+  fp->resyncs   = 0;
+}
+
+static Uint64 pace_deadline( struct framepacer *fp )
+{
+  return fp->start + ( ((Uint64)fp->frames) * 1000000 ) / fp->hz;
+}
+
+/*
+** Wait until the deadline. SDL_Delay only sleeps in whole
+** milliseconds and the scheduler can add a good deal to that,
+** so sleep until spinus before the deadline and spin the rest.
+*/
+static Uint64 pace_wait( struct framepacer *fp, Uint64 deadline )
+{
+  Uint64 now, wake;
+  Uint32 ms, over;
+
+  now = SDL_COMPAT_GetTicksUS();
+  if( deadline > now + fp->spinus )
+  {
+    ms = (Uint32)( ( deadline - now - fp->spinus ) / 1000 );
+    if( ms )
+    {
+      wake = now + ((Uint64)ms)*1000;
+      SDL_Delay( ms );
+      now = SDL_COMPAT_GetTicksUS();
+
+      // Follow a worse oversleep straight away, but
+      // only come down slowly from it
+      over = ( now > wake ) ? (Uint32)( now - wake ) : 0;
+      if( over > PACE_MAXSPIN ) over = PACE_MAXSPIN;
+      if( over > fp->oversleep )
+        fp->oversleep = over;
+      else
+        fp->oversleep = ( fp->oversleep*31 + over ) / 32;
+      fp->spinus = fp->oversleep + PACE_MINSPIN;
+      if( fp->spinus > PACE_MAXSPIN ) fp->spinus = PACE_MAXSPIN;
+    }
+  }
+
+  while( now < deadline )
+    now = SDL_COMPAT_GetTicksUS();
+  return now;
+}
+
+/*
+** Call at the end of each frame. Waits for the frame's place on
+** the timeline, unless wait is off (warp speed), and returns the
+** time since the last frame. A frame that is a little late is
+** caught up on the following ones, but one that is more than
+** PACE_RESYNC frames behind (or back from a pause) restarts the
+** timeline.
+*/
+Uint32 pace_frame( struct framepacer *fp, int hz, SDL_bool wait )
+{
+  Uint64 now, deadline;
+  Uint32 interval, ideal, jit;
+
+  if( hz < 1 ) hz = 1;
+  if( hz != fp->hz )
+  {
+    // Carry on from where the old rate had got to
+    if( fp->hz ) fp->start = pace_deadline( fp );
+    fp->frames = 0;
+    fp->hz = hz;
+  }
+
+  ideal = 1000000 / hz;
+  fp->frames++;
+  deadline = pace_deadline( fp );
+  now = SDL_COMPAT_GetTicksUS();
+
+  if( ( !wait ) || ( now > deadline + ideal*PACE_RESYNC ) )
+  {
+    if( wait ) fp->resyncs++;
+    fp->start  = now;
+    fp->frames = 0;
+    interval = (Uint32)( now - fp->last );
+    fp->last = now;
+    return interval;
+  }
+
+  if( now < deadline )
+    now = pace_wait( fp, deadline );
+
+  interval = (Uint32)( now - fp->last );
+  fp->last = now;
+
+  jit = ( interval > ideal ) ? interval - ideal : ideal - interval;
+  fp->lastjit = jit;
+  if( jit > fp->maxjit ) fp->maxjit = jit;
+  fp->jitsum += jit;
+  fp->jitframes++;
+
+  return interval;
+}
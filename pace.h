@@ -0,0 +1,51 @@
+/*
+**  Oricutron
+**  Copyright (C) 2009-2014 Peter Gordon
+**
+**  This program is free software; you can redistribute it and/or
+**  modify it under the terms of the GNU General Public License
+**  as published by the Free Software Foundation, version 2
+**  of the License.
+**
+**  This program is distributed in the hope that it will be useful,
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**  GNU General Public License for more details.
+**
+**  You should have received a copy of the GNU General Public License
+**  along with this program; if not, write to the Free Software
+**  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+**
+**  Frame pacing
+*/
+#ifndef PACE_H
+#define PACE_H
+
+// Frames are released against an ideal timeline (start plus
+// frames*1000000/hz), so the odd microsecond of rounding never
+// builds up. Times are in microseconds from SDL_COMPAT_GetTicksUS.
+struct framepacer
+{
+  Uint64   start;        // Start of the timeline
+  Uint32   frames;       // Frames since the start
+  int      hz;           // Frame rate of the timeline
+  Uint64   last;         // When the last frame was released
+
+  // Sleeps stop this far short of the deadline, and the rest is
+  // spun out. It follows how late the sleeps come back.
+  Uint32   spinus;
+  Uint32   oversleep;    // Recent worst oversleep
+
+  // How far each frame interval was from the ideal one, for every
+  // frame kept to the timeline (so not in warp speed or on a resync)
+  Uint32   jitframes;
+  Uint64   jitsum;
+  Uint32   lastjit, maxjit;
+  Uint32   resyncs;      // Times the timeline was restarted
+};
+
+void pace_reset( struct framepacer *fp );
+void pace_clearstats( struct framepacer *fp );
+Uint32 pace_frame( struct framepacer *fp, int hz, SDL_bool wait );
+
+#endif
@@ -0,0 +1,767 @@
+/*
+**  Oricutron
+**  Copyright (C) 2009-2014 Peter Gordon
+**
+**  This program is free software; you can redistribute it and/or
+**  modify it under the terms of the GNU General Public License
+**  as published by the Free Software Foundation, version 2
+**  of the License.
+**
+**  This program is distributed in the hope that it will be useful,
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**  GNU General Public License for more details.
+**
+**  You should have received a copy of the GNU General Public License
+**  along with this program; if not, write to the Free Software
+**  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+**
+**  6502 profiler
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "system.h"
+#include "6502.h"
+#include "via.h"
+#include "8912.h"
+#include "gui.h"
+#include "disk.h"
+#include "monitor.h"
+#include "6551.h"
+#include "machine.h"
+
+// Code more than this far past a symbol is put down to its page instead
+#define PROF_MAXSYMOFFS 0x100
+
+// A run of addresses put down to one symbol (or one page)
+struct profroutine
+{
+  int          bank;       // -1 for RAM
+  Uint16       addr;       // Symbol address, or start of the page
+  struct msym *sym;        // NULL if none was near enough
+  Uint64       cycles;
+};
+
+struct profaddr
+{
+  int    slot;
+  Uint64 cycles;
+};
+
+// All the calls to one routine
+struct profcall
+{
+  int          slot;
+  struct msym *sym;
+  Uint32       calls;
+  Uint64       incl;       // Cycles in it and everything it called
+  Uint64       excl;       // Cycles in it alone
+};
+
+static int profile_slot( struct m6502 *cpu, Uint16 pc )
+{
+  int bank;
+
+  if( pc < 0xc000 ) return pc;
+
+  bank = cpu->getbank ? cpu->getbank( cpu, pc ) : 0;
+  if( bank < 0 ) bank = 0;
+  return PROF_RAMSIZE + (bank&(PROF_BANKS-1))*0x4000 + (pc-0xc000);
+}
+
+// Enter the routine at slot, called with the stack pointer at sp
+static void profile_call( struct profiler *p, int slot, Uint8 sp )
+{
+  struct profnode *n;
+  int i;
+
+  if( p->depth == PROF_MAXDEPTH ) return;
+
+  // Called from here before?
+  for( i=p->nodes[p->current].child; i!=-1; i=p->nodes[i].next )
+  {
+    if( p->nodes[i].slot == slot ) break;
+  }
+
+  if( i == -1 )
+  {
+    if( p->numnodes == p->nodespace )
+    {
+      n = NULL;
+      if( p->nodespace < PROF_MAXNODES )
+        n = realloc( p->nodes, sizeof( struct profnode ) * p->nodespace * 2 );
+      if( n )
+      {
+        p->nodes = n;
+        p->nodespace *= 2;
+      }
+    }
+
+    // Out of nodes? Then it counts as part of the caller.
+    i = p->current;
+    if( p->numnodes < p->nodespace )
+    {
+      i = p->numnodes++;
+      n = &p->nodes[i];
+      n->slot   = slot;
+      n->parent = p->current;
+      n->child  = -1;
+      n->next   = p->nodes[p->current].child;
+      n->calls  = 0;
+      n->cycles = 0;
+      p->nodes[p->current].child = i;
+    }
+  }
+
+  p->stack[p->depth]   = p->current;
+  p->stacksp[p->depth] = sp;
+  p->depth++;
+  p->current = i;
+  p->nodes[i].calls++;
+}
+
+// Return to where the stack pointer was sp
+static void profile_return( struct profiler *p, int sp )
+{
+  while( ( p->depth > 0 ) && ( p->stacksp[p->depth-1] <= sp ) )
+  {
+    p->depth--;
+    p->current = p->stack[p->depth];
+  }
+}
+
+/*
+** Called by the CPU core for each instruction as it is executed
+** (inst is TRUE), and for idle loop passes that were skipped
+** (which are counted at the loop head).
+*/
+static void profile_count( struct m6502 *cpu, Uint16 pc, int cycles, SDL_bool inst )
+{
+  struct machine *oric = (struct machine *)cpu->userdata;
+  struct profiler *p = &oric->prof;
+  Uint8 sp = cpu->sp;
+
+  if( inst )
+  {
+    // The last instruction was a JSR or BRK, and pc is where it went.
+    // (Unless an interrupt came first, but cpu->pc is still right.)
+    if( p->pending )
+    {
+      profile_call( p, profile_slot( cpu, cpu->pc ), p->pendingsp );
+      p->pending = SDL_FALSE;
+    }
+
+    // An interrupt pushes PC and P, then runs the handler at pc
+    if( cpu->calcint > 0 )
+    {
+      profile_call( p, profile_slot( cpu, pc ), sp );
+      sp -= 3;
+    }
+  }
+
+  p->cycles[profile_slot( cpu, pc )] += cycles;
+  p->nodes[p->current].cycles += cycles;
+  p->total += cycles;
+
+  if( !inst ) return;
+
+  switch( cpu->calcop )
+  {
+    case 0x20: // JSR
+    case 0x00: // BRK
+      p->pending   = SDL_TRUE;
+      p->pendingsp = sp;
+      break;
+
+    case 0x60: // RTS
+      profile_return( p, sp+2 );
+      break;
+
+    case 0x40: // RTI
+      profile_return( p, sp+3 );
+      break;
+  }
+}
+
+// Hook the profiler back into the CPU after init_machine
+void profile_attach( struct machine *oric )
+{
+  oric->cpu.profile = oric->prof.cycles ? profile_count : NULL;
+}
+
+SDL_bool profile_start( struct machine *oric )
+{
+  if( !oric->prof.cycles )
+  {
+    oric->prof.cycles = malloc( sizeof( Uint64 ) * PROF_SIZE );
+    oric->prof.nodes  = malloc( sizeof( struct profnode ) * 1024 );
+    if( ( !oric->prof.cycles ) || ( !oric->prof.nodes ) )
+    {
+      profile_stop( oric );
+      return SDL_FALSE;
+    }
+    oric->prof.nodespace = 1024;
+    profile_reset( oric );
+  }
+
+  profile_attach( oric );
+  return SDL_TRUE;
+}
+
+void profile_stop( struct machine *oric )
+{
+  if( oric->prof.cycles ) free( oric->prof.cycles );
+  if( oric->prof.nodes ) free( oric->prof.nodes );
+  oric->prof.cycles = NULL;
+  oric->prof.nodes = NULL;
+  oric->prof.total = 0;
+  profile_attach( oric );
+}
+
+void profile_reset( struct machine *oric )
+{
+  struct profiler *p = &oric->prof;
+
+  if( !p->cycles ) return;
+
+  memset( p->cycles, 0, sizeof( Uint64 ) * PROF_SIZE );
+  p->total = 0;
+
+  // Start again from the top, wherever the CPU is
+  p->nodes[0].slot   = -1;
+  p->nodes[0].parent = -1;
+  p->nodes[0].child  = -1;
+  p->nodes[0].next   = -1;
+  p->nodes[0].calls  = 0;
+  p->nodes[0].cycles = 0;
+  p->numnodes = 1;
+  p->current  = 0;
+  p->depth    = 0;
+  p->pending  = SDL_FALSE;
+}
+
+static int profile_slotbank( int slot )
+{
+  return ( slot < PROF_RAMSIZE ) ? -1 : (slot-PROF_RAMSIZE)>>14;
+}
+
+static Uint16 profile_slotaddr( int slot )
+{
+  return ( slot < PROF_RAMSIZE ) ? slot : 0xc000 + ((slot-PROF_RAMSIZE)&0x3fff);
+}
+
+static char *profile_bankname( struct machine *oric, int bank )
+{
+  static char *telebanks[] = { "bank0", "bank1", "bank2", "bank3", "bank4", "bank5", "bank6", "bank7" };
+
+  if( bank < 0 ) return "ram";
+  if( oric->type == MACH_TELESTRAT ) return telebanks[bank&7];
+  return bank ? "romdis" : "rom";
+}
+
+// Look up the symbols at len addresses from start in a bank,
+// the way the monitor would if that bank was switched in
+static void profile_symmap( struct machine *oric, int bank, int start, int len, struct msym **map )
+{
+  int i, currbank;
+  SDL_bool romdis;
+
+  currbank = oric->tele_currbank;
+  if( ( bank >= 0 ) && ( oric->type == MACH_TELESTRAT ) )
+    oric->tele_currbank = bank;
+  romdis = ( bank > 0 );
+
+  for( i=0; i<len; i++ )
+    map[i] = mon_find_sym_by_addr( oric, start+i, ( bank < 0 ) ? NULL : &romdis );
+
+  oric->tele_currbank = currbank;
+}
+
+/*
+** Put every address with cycles against it down to the nearest
+** symbol at or before it in the same bank. slotroutine gets the
+** index into routines for each slot (-1 if no cycles).
+** Returns the number of routines, or -1 if out of memory.
+*/
+static int profile_resolve( struct machine *oric, struct profroutine **routines, int **slotroutine )
+{
+  struct profroutine *list = NULL, *tmp;
+  struct msym **map, *sym;
+  int num = 0, space = 0;
+  int bank, slot, start, len, i, symaddr;
+  Uint16 addr;
+  int *sr;
+
+  sr  = malloc( sizeof( int ) * PROF_SIZE );
+  map = malloc( sizeof( struct msym * ) * PROF_RAMSIZE );
+  if( ( !sr ) || ( !map ) )
+  {
+    if( sr ) free( sr );
+    if( map ) free( map );
+    return -1;
+  }
+
+  for( bank=-1; bank<PROF_BANKS; bank++ )
+  {
+    start = ( bank < 0 ) ? 0 : PROF_RAMSIZE + bank*0x4000;
+    len   = ( bank < 0 ) ? PROF_RAMSIZE : 0x4000;
+
+    for( i=0; i<len; i++ )
+    {
+      sr[start+i] = -1;
+      if( oric->prof.cycles[start+i] ) break;
+    }
+    if( i == len ) continue;
+
+    profile_symmap( oric, bank, profile_slotaddr( start ), len, map );
+
+    sym = NULL;
+    symaddr = 0;
+    for( i=0; i<len; i++ )
+    {
+      slot = start+i;
+      addr = profile_slotaddr( slot );
+      sr[slot] = -1;
+
+      if( map[i] )
+      {
+        sym = map[i];
+        symaddr = addr;
+      }
+
+      if( !oric->prof.cycles[slot] ) continue;
+
+      if( ( sym ) && ( ( addr - symaddr ) >= PROF_MAXSYMOFFS ) )
+        sym = NULL;
+
+      if( ( num == 0 ) ||
+          ( list[num-1].bank != bank ) ||
+          ( list[num-1].sym != sym ) ||
+          ( ( !sym ) && ( list[num-1].addr != (addr&0xff00) ) ) )
+      {
+        if( num == space )
+        {
+          tmp = realloc( list, sizeof( struct profroutine ) * ( space+256 ) );
+          if( !tmp )
+          {
+            if( list ) free( list );
+            free( sr );
+            free( map );
+            return -1;
+          }
+          list = tmp;
+          space += 256;
+        }
+
+        list[num].bank   = bank;
+        list[num].addr   = sym ? sym->addr : (addr&0xff00);
+        list[num].sym    = sym;
+        list[num].cycles = 0;
+        num++;
+      }
+
+      list[num-1].cycles += oric->prof.cycles[slot];
+      sr[slot] = num-1;
+    }
+  }
+
+  free( map );
+  *routines = list;
+  *slotroutine = sr;
+  return num;
+}
+
+static void profile_routinename( struct profroutine *r, char *buf, int len )
+{
+  if( r->sym )
+    snprintf( buf, len, "%s", r->sym->name );
+  else
+    snprintf( buf, len, "$%04X", r->addr );
+}
+
+static int profile_cmproutine( const void *a, const void *b )
+{
+  Uint64 ca = ((struct profroutine *)a)->cycles;
+  Uint64 cb = ((struct profroutine *)b)->cycles;
+
+  return ( ca < cb ) ? 1 : ( ( ca > cb ) ? -1 : 0 );
+}
+
+static int profile_cmpaddr( const void *a, const void *b )
+{
+  Uint64 ca = ((struct profaddr *)a)->cycles;
+  Uint64 cb = ((struct profaddr *)b)->cycles;
+
+  return ( ca < cb ) ? 1 : ( ( ca > cb ) ? -1 : 0 );
+}
+
+static double profile_percent( struct machine *oric, Uint64 cycles )
+{
+  return oric->prof.total ? ( (double)cycles * 100.0 ) / (double)oric->prof.total : 0.0;
+}
+
+// The hottest routines, in the monitor
+void profile_show( struct machine *oric, int count )
+{
+  struct profroutine *routines;
+  int *slotroutine;
+  char name[64];
+  int num, i;
+
+  if( !oric->prof.cycles )
+  {
+    mon_str( "Profiler off" );
+    return;
+  }
+
+  num = profile_resolve( oric, &routines, &slotroutine );
+  if( num < 0 )
+  {
+    mon_str( "Out of memory" );
+    return;
+  }
+  free( slotroutine );
+
+  mon_printf( "Profile: %llu cycles", (unsigned long long)oric->prof.total );
+  qsort( routines, num, sizeof( struct profroutine ), profile_cmproutine );
+  for( i=0; ( i<num ) && ( i<count ); i++ )
+  {
+    profile_routinename( &routines[i], name, sizeof( name ) );
+    mon_printf( "%6.2f%% %-6s $%04X %.24s", profile_percent( oric, routines[i].cycles ),
+      profile_bankname( oric, routines[i].bank ), routines[i].addr, name );
+  }
+  if( routines ) free( routines );
+}
+
+static void profile_writecalls( struct machine *oric, FILE *f );
+
+/*
+** Write the hot spots: every routine sorted by the cycles spent
+** in it, the calls sorted by the cycles spent in and under them,
+** then the hottest addresses.
+*/
+SDL_bool profile_report( struct machine *oric, char *fname )
+{
+  struct profroutine *routines, *r;
+  struct profaddr *addrs;
+  int *slotroutine;
+  char name[128];
+  int num, numaddrs, i;
+  FILE *f;
+
+  if( !oric->prof.cycles ) return SDL_FALSE;
+
+  num = profile_resolve( oric, &routines, &slotroutine );
+  if( num < 0 ) return SDL_FALSE;
+
+  addrs = malloc( sizeof( struct profaddr ) * PROF_SIZE );
+  f = addrs ? fopen( fname, "w" ) : NULL;
+  if( !f )
+  {
+    if( addrs ) free( addrs );
+    if( routines ) free( routines );
+    free( slotroutine );
+    return SDL_FALSE;
+  }
+
+  for( i=0, numaddrs=0; i<PROF_SIZE; i++ )
+  {
+    if( !oric->prof.cycles[i] ) continue;
+    addrs[numaddrs].slot   = i;
+    addrs[numaddrs].cycles = oric->prof.cycles[i];
+    numaddrs++;
+  }
+  qsort( addrs, numaddrs, sizeof( struct profaddr ), profile_cmpaddr );
+
+  fprintf( f, "Oricutron profile: %llu cycles\n\n", (unsigned long long)oric->prof.total );
+
+  // Sort a copy, so slotroutine still points at the right entries
+  r = malloc( sizeof( struct profroutine ) * ( num ? num : 1 ) );
+  if( r )
+  {
+    if( num ) memcpy( r, routines, sizeof( struct profroutine ) * num );
+    qsort( r, num, sizeof( struct profroutine ), profile_cmproutine );
+
+    fprintf( f, "Routines:\n\n         cycles        %%  bank     addr   routine\n" );
+    for( i=0; i<num; i++ )
+    {
+      profile_routinename( &r[i], name, sizeof( name ) );
+      fprintf( f, "%15llu  %6.2f%%  %-7s  $%04X  %s\n", (unsigned long long)r[i].cycles,
+        profile_percent( oric, r[i].cycles ), profile_bankname( oric, r[i].bank ), r[i].addr, name );
+    }
+    free( r );
+  }
+
+  profile_writecalls( oric, f );
+
+  fprintf( f, "\nAddresses:\n\n         cycles        %%  bank     addr   routine\n" );
+  for( i=0; i<numaddrs; i++ )
+  {
+    Uint16 addr = profile_slotaddr( addrs[i].slot );
+
+    r = &routines[slotroutine[addrs[i].slot]];
+    profile_routinename( r, name, sizeof( name ) );
+    fprintf( f, "%15llu  %6.2f%%  %-7s  $%04X  %s+%d\n", (unsigned long long)addrs[i].cycles,
+      profile_percent( oric, addrs[i].cycles ), profile_bankname( oric, profile_slotbank( addrs[i].slot ) ),
+      addr, name, addr - r->addr );
+  }
+
+  fclose( f );
+  free( addrs );
+  if( routines ) free( routines );
+  free( slotroutine );
+  return SDL_TRUE;
+}
+
+// Every address with cycles against it, in address order, as CSV
+SDL_bool profile_flat( struct machine *oric, char *fname )
+{
+  struct profroutine *routines, *r;
+  int *slotroutine;
+  char name[128];
+  int num, i;
+  Uint16 addr;
+  FILE *f;
+
+  if( !oric->prof.cycles ) return SDL_FALSE;
+
+  num = profile_resolve( oric, &routines, &slotroutine );
+  if( num < 0 ) return SDL_FALSE;
+
+  f = fopen( fname, "w" );
+  if( !f )
+  {
+    if( routines ) free( routines );
+    free( slotroutine );
+    return SDL_FALSE;
+  }
+
+  fprintf( f, "bank,addr,cycles,routine,offset\n" );
+  for( i=0; i<PROF_SIZE; i++ )
+  {
+    if( !oric->prof.cycles[i] ) continue;
+
+    addr = profile_slotaddr( i );
+    r = &routines[slotroutine[i]];
+    profile_routinename( r, name, sizeof( name ) );
+    fprintf( f, "%s,$%04X,%llu,%s,%d\n", profile_bankname( oric, profile_slotbank( i ) ),
+      addr, (unsigned long long)oric->prof.cycles[i], name, addr - r->addr );
+  }
+
+  fclose( f );
+  if( routines ) free( routines );
+  free( slotroutine );
+  return SDL_TRUE;
+}
+
+// Name a routine in the call tree by its entry point
+static void profile_callname( struct machine *oric, int slot, struct msym *sym, char *buf, int len )
+{
+  int bank = profile_slotbank( slot );
+
+  if( slot < 0 )
+    snprintf( buf, len, "[top]" );
+  else if( sym )
+    snprintf( buf, len, "%s", sym->name );
+  else if( bank < 0 )
+    snprintf( buf, len, "$%04X", profile_slotaddr( slot ) );
+  else
+    snprintf( buf, len, "$%04X@%s", profile_slotaddr( slot ), profile_bankname( oric, bank ) );
+}
+
+// The symbol at the entry point of each node
+static struct msym **profile_nodesyms( struct machine *oric )
+{
+  struct profiler *p = &oric->prof;
+  struct msym **syms;
+  int i;
+
+  syms = malloc( sizeof( struct msym * ) * p->numnodes );
+  if( !syms ) return NULL;
+
+  syms[0] = NULL;
+  for( i=1; i<p->numnodes; i++ )
+    profile_symmap( oric, profile_slotbank( p->nodes[i].slot ), profile_slotaddr( p->nodes[i].slot ), 1, &syms[i] );
+  return syms;
+}
+
+static int profile_cmpcall( const void *a, const void *b )
+{
+  Uint64 ca = ((struct profcall *)a)->incl;
+  Uint64 cb = ((struct profcall *)b)->incl;
+
+  return ( ca < cb ) ? 1 : ( ( ca > cb ) ? -1 : 0 );
+}
+
+/*
+** Add up the call tree for each routine, sorted by inclusive cycles.
+** A routine that recurses only counts its outermost call towards
+** the inclusive cycles. Returns the number of routines, or -1 if
+** out of memory.
+*/
+static int profile_calls( struct machine *oric, struct profcall **calls )
+{
+  struct profiler *p = &oric->prof;
+  struct profcall *list;
+  struct msym **syms;
+  Uint64 *incl;
+  int *map;
+  int num, i, j;
+
+  incl = malloc( sizeof( Uint64 ) * p->numnodes );
+  map  = malloc( sizeof( int ) * PROF_SIZE );
+  list = malloc( sizeof( struct profcall ) * p->numnodes );
+  syms = profile_nodesyms( oric );
+  if( ( !incl ) || ( !map ) || ( !list ) || ( !syms ) )
+  {
+    if( incl ) free( incl );
+    if( map ) free( map );
+    if( list ) free( list );
+    if( syms ) free( syms );
+    return -1;
+  }
+
+  // Children always come after their parents
+  for( i=0; i<p->numnodes; i++ )
+    incl[i] = p->nodes[i].cycles;
+  for( i=p->numnodes-1; i>0; i-- )
+    incl[p->nodes[i].parent] += incl[i];
+
+  for( i=0; i<PROF_SIZE; i++ )
+    map[i] = -1;
+
+  for( i=1, num=0; i<p->numnodes; i++ )
+  {
+    int slot = p->nodes[i].slot;
+
+    if( map[slot] == -1 )
+    {
+      map[slot] = num;
+      list[num].slot  = slot;
+      list[num].sym   = syms[i];
+      list[num].calls = 0;
+      list[num].incl  = 0;
+      list[num].excl  = 0;
+      num++;
+    }
+
+    list[map[slot]].calls += p->nodes[i].calls;
+    list[map[slot]].excl  += p->nodes[i].cycles;
+
+    for( j=p->nodes[i].parent; j>0; j=p->nodes[j].parent )
+    {
+      if( p->nodes[j].slot == slot ) break;
+    }
+    if( j <= 0 )
+      list[map[slot]].incl += incl[i];
+  }
+
+  free( incl );
+  free( map );
+  free( syms );
+
+  qsort( list, num, sizeof( struct profcall ), profile_cmpcall );
+  *calls = list;
+  return num;
+}
+
+// The routines with the most cycles in and under them, in the monitor
+void profile_showcalls( struct machine *oric, int count )
+{
+  struct profcall *calls;
+  char name[64];
+  int num, i;
+
+  if( !oric->prof.cycles )
+  {
+    mon_str( "Profiler off" );
+    return;
+  }
+
+  num = profile_calls( oric, &calls );
+  if( num < 0 )
+  {
+    mon_str( "Out of memory" );
+    return;
+  }
+
+  mon_str( "  incl%   excl%   calls routine" );
+  for( i=0; ( i<num ) && ( i<count ); i++ )
+  {
+    profile_callname( oric, calls[i].slot, calls[i].sym, name, sizeof( name ) );
+    mon_printf( "%6.2f%% %6.2f%% %7u %.24s", profile_percent( oric, calls[i].incl ),
+      profile_percent( oric, calls[i].excl ), calls[i].calls, name );
+  }
+  free( calls );
+}
+
+static void profile_writecalls( struct machine *oric, FILE *f )
+{
+  struct profcall *calls;
+  char name[128];
+  int num, i;
+
+  num = profile_calls( oric, &calls );
+  if( num < 0 ) return;
+
+  fprintf( f, "\nCalls:\n\n      inclusive        %%       exclusive        %%      calls  routine\n" );
+  for( i=0; i<num; i++ )
+  {
+    profile_callname( oric, calls[i].slot, calls[i].sym, name, sizeof( name ) );
+    fprintf( f, "%15llu  %6.2f%%  %15llu  %6.2f%%  %9u  %s\n",
+      (unsigned long long)calls[i].incl, profile_percent( oric, calls[i].incl ),
+      (unsigned long long)calls[i].excl, profile_percent( oric, calls[i].excl ),
+      calls[i].calls, name );
+  }
+  free( calls );
+}
+
+/*
+** Write the call tree as collapsed stacks, one line per path
+** with the cycles spent at the end of it, e.g.
+**   [top];MAIN;DRAWSPRITE 123456
+** which is what flamegraph.pl and friends take.
+*/
+SDL_bool profile_folded( struct machine *oric, char *fname )
+{
+  struct profiler *p = &oric->prof;
+  struct msym **syms;
+  int path[PROF_MAXDEPTH+1];
+  char name[128];
+  int i, j, n;
+  FILE *f;
+
+  if( !p->cycles ) return SDL_FALSE;
+
+  syms = profile_nodesyms( oric );
+  if( !syms ) return SDL_FALSE;
+
+  f = fopen( fname, "w" );
+  if( !f )
+  {
+    free( syms );
+    return SDL_FALSE;
+  }
+
+  for( i=0; i<p->numnodes; i++ )
+  {
+    if( !p->nodes[i].cycles ) continue;
+
+    for( n=0, j=i; ( j!=-1 ) && ( n<=PROF_MAXDEPTH ); j=p->nodes[j].parent )
+      path[n++] = j;
+
+    while( n-- > 0 )
+    {
+      profile_callname( oric, p->nodes[path[n]].slot, syms[path[n]], name, sizeof( name ) );
+      fprintf( f, "%s%c", name, n ? ';' : ' ' );
+    }
+    fprintf( f, "%llu\n", (unsigned long long)p->nodes[i].cycles );
+  }
+
+  fclose( f );
+  free( syms );
+  return SDL_TRUE;
+}
@@ -0,0 +1,72 @@
+/*
+**  Oricutron
+**  Copyright (C) 2009-2014 Peter Gordon
+**
+**  This program is free software; you can redistribute it and/or
+**  modify it under the terms of the GNU General Public License
+**  as published by the Free Software Foundation, version 2
+**  of the License.
+**
+**  This program is distributed in the hope that it will be useful,
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**  GNU General Public License for more details.
+**
+**  You should have received a copy of the GNU General Public License
+**  along with this program; if not, write to the Free Software
+**  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+**
+**  6502 profiler
+*/
+#ifndef PROFILE_H
+#define PROFILE_H
+
+// Cycles are kept for each PC. Below $C000 there is only RAM,
+// above it there is a set for each ROM bank: the Telestrat banks,
+// or the ROM (0) and whatever ROMDIS uncovers (1) on the others.
+#define PROF_RAMSIZE 0xc000
+#define PROF_BANKS   8
+#define PROF_SIZE    (PROF_RAMSIZE+PROF_BANKS*0x4000)
+
+// The call tree. Each node is a routine (by its entry point)
+// called by way of the path from the root to it.
+#define PROF_MAXNODES 0x40000
+#define PROF_MAXDEPTH 128
+
+struct profnode
+{
+  int    slot;                 // Entry point, as an index into cycles
+  int    parent, child, next;  // -1 for none
+  Uint32 calls;
+  Uint64 cycles;               // Spent in the routine itself on this path
+};
+
+struct profiler
+{
+  Uint64 *cycles;       // PROF_SIZE entries, NULL when off
+  Uint64  total;
+
+  // Calls are followed through JSR, BRK and interrupts, and back out
+  // through RTS and RTI. Each frame keeps the stack pointer from before
+  // the call, so frames the program dropped are popped along the way.
+  struct profnode *nodes;
+  int      numnodes, nodespace;
+  int      current;                  // Node the CPU is in (0 = root)
+  int      depth;
+  int      stack[PROF_MAXDEPTH];     // Caller's node for each frame
+  Uint8    stacksp[PROF_MAXDEPTH];
+  SDL_bool pending;                  // JSR or BRK, enter at the next instruction
+  Uint8    pendingsp;
+};
+
+void profile_attach( struct machine *oric );
+SDL_bool profile_start( struct machine *oric );
+void profile_stop( struct machine *oric );
+void profile_reset( struct machine *oric );
+void profile_show( struct machine *oric, int count );
+void profile_showcalls( struct machine *oric, int count );
+SDL_bool profile_report( struct machine *oric, char *fname );
+SDL_bool profile_flat( struct machine *oric, char *fname );
+SDL_bool profile_folded( struct machine *oric, char *fname );
+
+#endif
@@ -63,7 +63,19 @@
 
 #define NUM_TEXTURES  (TEX_GIMG_LAST+1)
 
-extern SDL_bool refreshstatus;
+#ifndef APIENTRY
+#define APIENTRY
+#endif
+#ifndef GL_TEXTURE0
+#define GL_TEXTURE0 0x84C0
+#define GL_TEXTURE1 0x84C1
+#endif
+#ifndef GL_FRAGMENT_SHADER
+#define GL_FRAGMENT_SHADER 0x8B30
+#define GL_COMPILE_STATUS  0x8B81
+#define GL_LINK_STATUS     0x8B82
+#endif
+
 
 struct texture
 {
@@ -81,6 +93,52 @@ static Uint32 gpal[NUM_GUI_COLS];
 
 static float clrcol[3];
 
+// With GL 2.0 the video texture holds the colour indices straight
+// from oric->scr, and a fragment shader looks them up in a palette
+// texture and does the linear filtering. Otherwise it is expanded
+// to RGBA here.
+static GLuint vidprog = 0, vidshader = 0, paltex = 0;
+static SDL_bool dodelpal = SDL_FALSE;
+
+static GLuint (APIENTRY *gl_CreateShader)( GLenum );
+static void   (APIENTRY *gl_ShaderSource)( GLuint, GLsizei, const char **, const GLint * );
+static void   (APIENTRY *gl_CompileShader)( GLuint );
+static void   (APIENTRY *gl_GetShaderiv)( GLuint, GLenum, GLint * );
+static void   (APIENTRY *gl_DeleteShader)( GLuint );
+static GLuint (APIENTRY *gl_CreateProgram)( void );
+static void   (APIENTRY *gl_AttachShader)( GLuint, GLuint );
+static void   (APIENTRY *gl_LinkProgram)( GLuint );
+static void   (APIENTRY *gl_GetProgramiv)( GLuint, GLenum, GLint * );
+static void   (APIENTRY *gl_DeleteProgram)( GLuint );
+static void   (APIENTRY *gl_UseProgram)( GLuint );
+static GLint  (APIENTRY *gl_GetUniformLocation)( GLuint, const char * );
+static void   (APIENTRY *gl_Uniform1i)( GLint, GLint );
+static void   (APIENTRY *gl_ActiveTexture)( GLenum );
+
+// Texels past the right and bottom edges repeat the edge, the
+// same as the extra column and row of the RGBA texture. Those
+// past the left and top are the GL_CLAMP border (transparent
+// black), so the edges blend the same as the RGBA texture.
+static const char *vidshadersrc =
+  "uniform sampler2D scr;\n"
+  "uniform sampler2D pal;\n"
+  "vec4 texel( vec2 t )\n"
+  "{\n"
+  "  if( ( t.x < 0.0 ) || ( t.y < 0.0 ) ) return vec4( 0.0 );\n"
+  "  t = min( t, vec2( 239.0, 223.0 ) );\n"
+  "  float c = texture2D( scr, ( t + 0.5 ) / 256.0 ).r;\n"
+  "  return texture2D( pal, vec2( ( c * 255.0 + 0.5 ) / 8.0, 0.5 ) );\n"
+  "}\n"
+  "void main()\n"
+  "{\n"
+  "  vec2 t = gl_TexCoord[0].xy * 256.0 - 0.5;\n"
+  "  vec2 b = floor( t );\n"
+  "  vec2 f = t - b;\n"
+  "  vec4 c = mix( mix( texel( b ), texel( b + vec2( 1.0, 0.0 ) ), f.x ),\n"
+  "                mix( texel( b + vec2( 0.0, 1.0 ) ), texel( b + vec2( 1.0, 1.0 ) ), f.x ), f.y );\n"
+  "  gl_FragColor = c * gl_Color;\n"
+  "}\n";
+
 extern unsigned char sgpal[];
 extern SDL_bool fullscreen;
 extern struct textzone *tz[NUM_TZ];
@@ -152,68 +210,72 @@ static void update_textzone_texture( struct machine *oric, int i )
   tz[i]->modified = SDL_FALSE;
 }
 
+// Expand a line of colour indices into the RGBA texture, repeating the
+// last pixel to prevent linear interpolation to garbage at the right
+// edge (GL_CLAMP takes care of the left and top)
+static void expand_video_line( Uint8 *sptr, Uint8 *dptr )
+{
+  int x, c = 0;
+
+  for( x=0; x<240; x++ )
+  {
+    c = *(sptr++) * 3;
+    *(dptr++) = oricpalette[c];
+    *(dptr++) = oricpalette[c+1];
+    *(dptr++) = oricpalette[c+2];
+    *(dptr++) = 0xff;
+  }
+
+  *(dptr++) = oricpalette[c];
+  *(dptr++) = oricpalette[c+1];
+  *(dptr++) = oricpalette[c+2];
+  *(dptr++) = 0xff;
+}
+
+// Upload only the runs of lines that changed
 static void update_video_texture( struct machine *oric )
 {
-  int x, y, o, c;
-  Uint8 *sptr;
+  struct texture *ptx = &tx[TEX_VIDEO];
+  int y, n;
 
-  o = 0;
-  sptr = oric->scr;
+  glBindTexture( GL_TEXTURE_2D, tex[TEX_VIDEO] );
 
-  for( y=0; y<224; y++ )
+  for( y=0; y<224; y+=n )
   {
-    if (!oric->vid_dirty[y])
+    if( !oric->vid_dirty[y] )
     {
-      sptr += 240;
-      o += tx[TEX_VIDEO].w*4;
+      n = 1;
       continue;
     }
 
-    for( x=0; x<240; x++ )
+    for( n=0; ( y+n < 224 ) && ( oric->vid_dirty[y+n] ); n++ )
     {
-      c = *(sptr++) * 3;
-      tx[TEX_VIDEO].buf[o++] = oricpalette[c++];
-      tx[TEX_VIDEO].buf[o++] = oricpalette[c++];
-      tx[TEX_VIDEO].buf[o++] = oricpalette[c++];
-      tx[TEX_VIDEO].buf[o++] = 0xff;
+      if( !vidprog )
+        expand_video_line( &oric->scr[(y+n)*240], &ptx->buf[(y+n)*ptx->w*4] );
+      oric->vid_dirty[y+n] = SDL_FALSE;
     }
-    
-    // Repeat the right and bottom borders to prevent linear interpolation to
-    // garbage at the edges (GL_CLAMP takes care of the left and top)
-    tx[TEX_VIDEO].buf[o++] = oricpalette[c-3];
-    tx[TEX_VIDEO].buf[o++] = oricpalette[c-2];
-    tx[TEX_VIDEO].buf[o++] = oricpalette[c-1];
-    tx[TEX_VIDEO].buf[o++] = 0xff;
-
-    o += (tx[TEX_VIDEO].w-241) * 4;
-    oric->vid_dirty[y] = SDL_FALSE;
-  }
 
-  sptr -= 240;
-  for( x=0; x<240; x++ )
-  {
-    c = *(sptr++) * 3;
-    tx[TEX_VIDEO].buf[o++] = oricpalette[c++];
-    tx[TEX_VIDEO].buf[o++] = oricpalette[c++];
-    tx[TEX_VIDEO].buf[o++] = oricpalette[c++];
-    tx[TEX_VIDEO].buf[o++] = 0xff;
-  }
-    
-  // Repeat the right and bottom borders to prevent linear interpolation to
-  // garbage at the edges (GL_CLAMP takes care of the left and top)
-  tx[TEX_VIDEO].buf[o++] = oricpalette[c-3];
-  tx[TEX_VIDEO].buf[o++] = oricpalette[c-2];
-  tx[TEX_VIDEO].buf[o++] = oricpalette[c-1];
-  tx[TEX_VIDEO].buf[o++] = 0xff;
+    if( vidprog )
+    {
+      glTexSubImage2D( GL_TEXTURE_2D, 0, 0, y, 240, n, GL_LUMINANCE, GL_UNSIGNED_BYTE, &oric->scr[y*240] );
+      continue;
+    }
 
-  glBindTexture( GL_TEXTURE_2D, tex[TEX_VIDEO] );
-  glTexImage2D( GL_TEXTURE_2D, 0, GL_RGBA, tx[TEX_VIDEO].w, tx[TEX_VIDEO].h, 0, GL_RGBA, GL_UNSIGNED_BYTE, tx[TEX_VIDEO].buf );
+    // Repeat the bottom line too, for the same reason
+    if( y+n == 224 )
+    {
+      expand_video_line( &oric->scr[223*240], &ptx->buf[224*ptx->w*4] );
+      glTexSubImage2D( GL_TEXTURE_2D, 0, 0, y, ptx->w, n+1, GL_RGBA, GL_UNSIGNED_BYTE, &ptx->buf[y*ptx->w*4] );
+    } else {
+      glTexSubImage2D( GL_TEXTURE_2D, 0, 0, y, ptx->w, n, GL_RGBA, GL_UNSIGNED_BYTE, &ptx->buf[y*ptx->w*4] );
+    }
+  }
 }
 
 void render_begin_gl( struct machine *oric )
 {
   int i;
-  refreshstatus = SDL_TRUE;
+  oric->refreshstatus = SDL_TRUE;
 
   update_video_texture( oric );
   for( i=0; i<NUM_TZ; i++ )
@@ -388,6 +450,7 @@ void render_video_gl( struct machine *oric, SDL_bool doublesize )
   int y;
 
   glBindTexture( GL_TEXTURE_2D, tex[TEX_VIDEO] );
+  if( vidprog ) gl_UseProgram( vidprog );
 
   if( doublesize )
   {
@@ -420,6 +483,7 @@ void render_video_gl( struct machine *oric, SDL_bool doublesize )
       glColor4ub( 255, 255, 255, 255 );
     }
 
+    if( vidprog ) gl_UseProgram( 0 );
     if( !oric->scanlines ) return;
 
     glBindTexture( GL_TEXTURE_2D, tex[TEX_SCANLINES] );
@@ -441,6 +505,7 @@ void render_video_gl( struct machine *oric, SDL_bool doublesize )
     glTexCoord2f( 240.0f/256.0f, 224.0f/256.0f ); glVertex3f( 240.0f, 228.0f, 0.0f );
     glTexCoord2f(          0.0f, 224.0f/256.0f ); glVertex3f(   0.0f, 228.0f, 0.0f );
   glEnd();
+  if( vidprog ) gl_UseProgram( 0 );
 }
 
 void preinit_render_gl( struct machine *oric )
@@ -449,6 +514,8 @@ void preinit_render_gl( struct machine *oric )
 
   screen = NULL;
   dodeltex = SDL_FALSE;
+  dodelpal = SDL_FALSE;
+  vidprog = vidshader = 0;
 
   for( i=0; i<NUM_TEXTURES; i++ )
   {
@@ -498,6 +565,109 @@ static SDL_bool go_go_gadget_texture( int i, int w, int h, int blendtype, SDL_bo
   return SDL_TRUE;
 }
 
+#define GETPROC( fn, name ) if( !( *(void **)&fn = SDL_GL_GetProcAddress( name ) ) ) return SDL_FALSE
+
+static SDL_bool get_shader_procs( void )
+{
+  GETPROC( gl_CreateShader,       "glCreateShader" );
+  GETPROC( gl_ShaderSource,       "glShaderSource" );
+  GETPROC( gl_CompileShader,      "glCompileShader" );
+  GETPROC( gl_GetShaderiv,        "glGetShaderiv" );
+  GETPROC( gl_DeleteShader,       "glDeleteShader" );
+  GETPROC( gl_CreateProgram,      "glCreateProgram" );
+  GETPROC( gl_AttachShader,       "glAttachShader" );
+  GETPROC( gl_LinkProgram,        "glLinkProgram" );
+  GETPROC( gl_GetProgramiv,       "glGetProgramiv" );
+  GETPROC( gl_DeleteProgram,      "glDeleteProgram" );
+  GETPROC( gl_UseProgram,         "glUseProgram" );
+  GETPROC( gl_GetUniformLocation, "glGetUniformLocation" );
+  GETPROC( gl_Uniform1i,          "glUniform1i" );
+  GETPROC( gl_ActiveTexture,      "glActiveTexture" );
+  return SDL_TRUE;
+}
+
+static void shut_video_shader( void )
+{
+  if( vidprog ) gl_DeleteProgram( vidprog );
+  if( vidshader ) gl_DeleteShader( vidshader );
+  vidprog = vidshader = 0;
+
+  if( dodelpal ) glDeleteTextures( 1, &paltex );
+  dodelpal = SDL_FALSE;
+}
+
+// Set up the palette lookup shader, if GL 2.0 is there (it is with Mesa, even in software)
+static SDL_bool init_video_shader( void )
+{
+  const char *version = (const char *)glGetString( GL_VERSION );
+  Uint8 pal[8*4];
+  GLint ok;
+  int i;
+
+  if( ( !version ) || ( atoi( version ) < 2 ) ) return SDL_FALSE;
+  if( !get_shader_procs() ) return SDL_FALSE;
+
+  vidshader = gl_CreateShader( GL_FRAGMENT_SHADER );
+  if( !vidshader ) return SDL_FALSE;
+  gl_ShaderSource( vidshader, 1, &vidshadersrc, NULL );
+  gl_CompileShader( vidshader );
+  gl_GetShaderiv( vidshader, GL_COMPILE_STATUS, &ok );
+  if( !ok )
+  {
+    shut_video_shader();
+    return SDL_FALSE;
+  }
+
+  vidprog = gl_CreateProgram();
+  if( !vidprog )
+  {
+    shut_video_shader();
+    return SDL_FALSE;
+  }
+  gl_AttachShader( vidprog, vidshader );
+  gl_LinkProgram( vidprog );
+  gl_GetProgramiv( vidprog, GL_LINK_STATUS, &ok );
+  if( !ok )
+  {
+    shut_video_shader();
+    return SDL_FALSE;
+  }
+
+  // The palette goes in texture unit 1
+  for( i=0; i<8; i++ )
+  {
+    pal[i*4  ] = oricpalette[i*3];
+    pal[i*4+1] = oricpalette[i*3+1];
+    pal[i*4+2] = oricpalette[i*3+2];
+    pal[i*4+3] = 0xff;
+  }
+  glGenTextures( 1, &paltex );
+  dodelpal = SDL_TRUE;
+  gl_ActiveTexture( GL_TEXTURE1 );
+  glBindTexture( GL_TEXTURE_2D, paltex );
+  glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP );
+  glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP );
+  glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST );
+  glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST );
+  glTexImage2D( GL_TEXTURE_2D, 0, GL_RGBA, 8, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, pal );
+  gl_ActiveTexture( GL_TEXTURE0 );
+
+  // One byte per texel, filtered by the shader. The lines are 240
+  // bytes, so the default unpack alignment of 4 is fine for them.
+  glBindTexture( GL_TEXTURE_2D, tex[TEX_VIDEO] );
+  glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST );
+  glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST );
+  memset( tx[TEX_VIDEO].buf, 0, tx[TEX_VIDEO].w*tx[TEX_VIDEO].h );
+  glTexImage2D( GL_TEXTURE_2D, 0, GL_LUMINANCE, tx[TEX_VIDEO].w, tx[TEX_VIDEO].h, 0, GL_LUMINANCE, GL_UNSIGNED_BYTE, tx[TEX_VIDEO].buf );
+
+  gl_UseProgram( vidprog );
+  gl_Uniform1i( gl_GetUniformLocation( vidprog, "scr" ), 0 );
+  gl_Uniform1i( gl_GetUniformLocation( vidprog, "pal" ), 1 );
+  gl_UseProgram( 0 );
+
+  return SDL_TRUE;
+}
+
 SDL_bool init_render_gl( struct machine *oric )
 {
   int depth, i, x, y;
@@ -556,6 +726,8 @@ SDL_bool init_render_gl( struct machine *oric )
   glBindTexture( GL_TEXTURE_2D, tex[TEX_SCANLINES] );
   glTexImage2D( GL_TEXTURE_2D, 0, GL_RGBA, tx[TEX_SCANLINES].w, tx[TEX_SCANLINES].h, 0, GL_RGBA, GL_UNSIGNED_BYTE, tx[TEX_SCANLINES].buf );
 
+  init_video_shader();
+
   for( i=0; i<NUM_GIMG; i++ )
   {
     if( !go_go_gadget_texture( i+TEX_GIMG, rounduppow2( gimgs[i].w ), rounduppow2( gimgs[i].h ), GL_NEAREST, SDL_FALSE ) ) return SDL_FALSE;
@@ -601,6 +773,8 @@ void shut_render_gl( struct machine *oric )
 {
   int i;
 
+  shut_video_shader();
+
   if( dodeltex )
   {
     glDeleteTextures( NUM_TEXTURES, tex );
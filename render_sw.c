@@ -21,6 +21,7 @@
 
 #include <stdlib.h>
 #include <string.h>
+#include <math.h>
 
 #include "system.h"
 #include "6502.h"
@@ -32,6 +33,7 @@
 #include "6551.h"
 #include "machine.h"
 #include "render_sw.h"
+#include "render_swline.h"
 #include "ula.h"
 
 static struct SDL_Surface *screen;
@@ -40,15 +42,27 @@ static Uint32 gpal[NUM_GUI_COLS];
 static Uint32 pixel_size, offset_top;
 static Uint32 pal[8*2]; // Palette
 static Uint32 dpal[8*2];
+static struct swpal spal[2], sdpal[2]; // pal and dpal, then the scanline colours
 static Uint8 *mgimg[NUM_GIMG];
 
-extern SDL_bool fullscreen, hwsurface;
+// Scaling (see render_sw_setmode). Everything is drawn into screen as
+// usual, which is then scaled into display, the real video surface.
+static struct SDL_Surface *display;
+static SDL_bool scaling = SDL_FALSE;
+static int desk_w = 0, desk_h = 0;
+static int scl_x, scl_y, scl_w, scl_h; // Where the picture goes in display
+static Uint16 *scl_col, *scl_row;      // Source column/row of each display column/row
+static Uint16 *scl_colw, *scl_roww;    // Weight of the next source column/row (0-256)
+static Uint32 *scl_line[2];            // Source rows scaled across, for blending
+static int scl_lineof[2];
+
+extern SDL_bool fullscreen, hwsurface, swsmooth;
+extern double swscale;
 static SDL_bool needclr;
 extern struct textzone *tz[NUM_TZ];
 extern unsigned char sgpal[];
 extern Uint8 oricpalette[];
 extern struct guiimg gimgs[NUM_GIMG];
-extern SDL_bool refreshstatus;
 
 // Our "lovely" hand-coded font
 extern unsigned char thefont[];
@@ -101,6 +115,8 @@ DEFINE_printchar_X_bpp(32)
 
 // --- end of printchar template function -------------------------------------
 
+static void render_sw_scale( void );
+
 void render_begin_sw( struct machine *oric )
 {
   int x, y;
@@ -137,7 +153,7 @@ void render_begin_sw( struct machine *oric )
   
   if( oric->newstatusstr )
   {
-    refreshstatus = SDL_TRUE;
+    oric->refreshstatus = SDL_TRUE;
     oric->newstatusstr = SDL_FALSE;
   }
 }
@@ -174,7 +190,16 @@ void render_end_sw( struct machine *oric )
   if( SDL_MUSTLOCK( screen ) )
     SDL_UnlockSurface( screen );
 
-  SDL_COMPAT_Flip( screen );
+  if( scaling )
+  {
+    if( SDL_MUSTLOCK( display ) )
+      SDL_LockSurface( display );
+    render_sw_scale();
+    if( SDL_MUSTLOCK( display ) )
+      SDL_UnlockSurface( display );
+  }
+
+  SDL_COMPAT_Flip( display );
 }
 
 void render_textzone_alloc_sw( struct machine *oric, int i )
@@ -255,16 +280,53 @@ void render_gimgpart_sw( int img_id, Sint32 xp, Sint32 yp, Sint32 ox, Sint32 oy,
 
 }
 
+// Draw a line at double width, with the colours in spal/sdpal[which]
+static void render_double_line( Uint8 *dst, Uint8 *src_pixel, int which )
+{
+  // In 16bpp, dpal has each colour twice
+  if( pixel_size == 2 )
+    swline_expand32( (Uint32*)dst, src_pixel, &sdpal[which], 240 );
+  else
+    swline_expand32x2( (Uint32*)dst, src_pixel, &spal[which], 240 );
+}
+
+// Draw the dirty lines of a frame into the surface at double size
+static void render_double_sw( Uint8 *src_pixel, SDL_bool *dirty, SDL_bool scanlines )
+{
+  int y;
+  Sint32 dst_pitch_x2;
+  Uint8 *dst_even_scanline, *dst_odd_scanline;
+
+  dst_pitch_x2 = 2 * screen->pitch;
+
+  dst_even_scanline = ((Uint8*)screen->pixels) + offset_top;
+
+  dst_odd_scanline = dst_even_scanline;
+  dst_odd_scanline += screen->pitch;
+
+  for( y=0; y<224; y++, src_pixel+=240, dst_even_scanline+=dst_pitch_x2, dst_odd_scanline+=dst_pitch_x2 )
+  {
+    if( !dirty[y] ) continue;
+
+    render_double_line( dst_even_scanline, src_pixel, 0 );
+
+    // The odd line is a copy of the even one, unless it has the
+    // scanline colours, or is in video memory (slow to read back)
+    if( ( scanlines ) || ( hwsurface ) )
+      render_double_line( dst_odd_scanline, src_pixel, scanlines ? 1 : 0 );
+    else
+      memcpy( dst_odd_scanline, dst_even_scanline, 480*pixel_size );
+
+    dirty[y] = SDL_FALSE;
+  }
+}
+
 // Copy the video output buffer to the SDL surface, assuming 16bpp video mode
 void render_video_sw_16bpp( struct machine *oric, SDL_bool doublesize )
 {
-  int x, y;
+  int y;
   Uint8 *src_pixel;
-  Sint32 dst_pitch_x2;
-  Uint32 c;
-  Uint8 *dst_scanline, *dst_even_scanline, *dst_odd_scanline;
-  Uint16 *dst_pixel;
-  Uint32 *dst_even_pixel, *dst_odd_pixel;
+  Uint8 *dst_scanline;
 
   if( !oric->scr )
     return;
@@ -277,56 +339,7 @@ void render_video_sw_16bpp( struct machine *oric, SDL_bool doublesize )
       needclr = SDL_FALSE;
     }
 
-    src_pixel = oric->scr;
-
-    dst_pitch_x2 = 2 * screen->pitch;
-
-    dst_even_scanline = ((Uint8*)screen->pixels) + offset_top;
-
-    dst_odd_scanline = dst_even_scanline;
-    dst_odd_scanline += screen->pitch;
-
-    if( oric->scanlines )
-    {
-      for( y=0; y<224; y++, dst_even_scanline+=dst_pitch_x2, dst_odd_scanline+=dst_pitch_x2 )
-      {
-        if (!oric->vid_dirty[y])
-        {
-          src_pixel += 240;
-          continue;
-        }
-        dst_even_pixel = (Uint32*)dst_even_scanline;
-        dst_odd_pixel  = (Uint32*)dst_odd_scanline;
-
-        for( x=240; x!=0; --x )
-        {
-          c = *(src_pixel++);
-          *(dst_even_pixel++) = dpal[c];
-          *(dst_odd_pixel++)  = dpal[c+8];
-        }
-        oric->vid_dirty[y] = SDL_FALSE;
-
-      }
-    } else {
-      for( y=0; y<224; y++, dst_even_scanline+=dst_pitch_x2, dst_odd_scanline+=dst_pitch_x2 )
-      {
-        if (!oric->vid_dirty[y])
-        {
-          src_pixel += 240;
-          continue;
-        }
-        dst_even_pixel = (Uint32*)dst_even_scanline;
-        dst_odd_pixel  = (Uint32*)dst_odd_scanline;
-
-        for( x=240; x!=0; --x ) 
-        {
-            c = dpal[*(src_pixel++)];
-            *(dst_even_pixel++) = c;
-            *(dst_odd_pixel++)  = c;
-        }
-        oric->vid_dirty[y] = SDL_FALSE;
-      }
-    }
+    render_double_sw( oric->scr, oric->vid_dirty, oric->scanlines );
     return;
   }
 
@@ -340,24 +353,16 @@ void render_video_sw_16bpp( struct machine *oric, SDL_bool doublesize )
     memset( dst_scanline, 0, 240*pixel_size );
     dst_scanline += screen->pitch;
   }
-  for( ; y<228; y++, dst_scanline+=screen->pitch )
-  {
-    dst_pixel = (Uint16*)dst_scanline;
-
-    for( x=240; x!=0; --x )
-      *(dst_pixel++) = (Uint16)pal[*(src_pixel++)];
-  }
+  for( ; y<228; y++, src_pixel+=240, dst_scanline+=screen->pitch )
+    swline_expand16( (Uint16*)dst_scanline, src_pixel, &spal[0], 240 );
 }
 
 // Copy the video output buffer to the SDL surface, assuming 32bpp video mode
 void render_video_sw_32bpp( struct machine *oric, SDL_bool doublesize )
 {
-  int x, y;
+  int y;
   Uint8 *src_pixel;
-  Sint32 dst_pitch_x2;
-  Uint32 c, c2;
-  Uint8 *dst_scanline, *dst_even_scanline, *dst_odd_scanline;
-  Uint32 *dst_pixel, *dst_even_pixel, *dst_odd_pixel;
+  Uint8 *dst_scanline;
 
   if( !oric->scr )
     return;
@@ -370,67 +375,20 @@ void render_video_sw_32bpp( struct machine *oric, SDL_bool doublesize )
       needclr = SDL_FALSE;
     }
 
-    src_pixel = oric->scr;
-
-    dst_pitch_x2 = 2 * screen->pitch;
-
-    dst_even_scanline = ((Uint8*)screen->pixels) + offset_top;
-
-    dst_odd_scanline = dst_even_scanline;
-    dst_odd_scanline += screen->pitch;
+    render_double_sw( oric->scr, oric->vid_dirty, oric->scanlines );
 
-    if( oric->scanlines )
+    // From now on the ULA can draw the lines that change straight
+    // into the surface, as long as it stays put between frames
+    if( ( !hwsurface ) && ( !SDL_MUSTLOCK( screen ) ) )
     {
-      for( y=0; y<224; y++, dst_even_scanline+=dst_pitch_x2, dst_odd_scanline+=dst_pitch_x2 )
-      {
-        if (!oric->vid_dirty[y])
-        {
-          src_pixel += 240;
-          continue;
-        }
-        dst_even_pixel = (Uint32*)dst_even_scanline;
-        dst_odd_pixel  = (Uint32*)dst_odd_scanline;
-
-        for( x=240; x!=0; --x )
-        {
-          c2 = pal[(*src_pixel)+8];
-          c = pal[*(src_pixel++)];
-
-          *(dst_even_pixel++) = c;
-          *(dst_even_pixel++) = c;
-          *(dst_odd_pixel++)  = c2;
-          *(dst_odd_pixel++)  = c2;
-        }
-
-        oric->vid_dirty[y] = SDL_FALSE;
-
-      }
-    } else {
-      for( y=0; y<224; y++, dst_even_scanline+=dst_pitch_x2, dst_odd_scanline+=dst_pitch_x2 )
-      {
-        if (!oric->vid_dirty[y])
-        {
-          src_pixel += 240;
-          continue;
-        }
-        dst_even_pixel = (Uint32*)dst_even_scanline;
-        dst_odd_pixel  = (Uint32*)dst_odd_scanline;
-
-        for( x=240; x!=0; --x ) 
-          {
-            c = pal[*(src_pixel++)];
-
-            *(dst_even_pixel++) = c;
-            *(dst_even_pixel++) = c;
-            *(dst_odd_pixel++)  = c;
-            *(dst_odd_pixel++)  = c;
-         }
-        oric->vid_dirty[y] = SDL_FALSE;
-      }
+      oric->vid_host      = ((Uint8*)screen->pixels) + offset_top;
+      oric->vid_hostpitch = screen->pitch;
+      oric->vid_hostpal   = spal;
     }
     return;
   }
 
+  oric->vid_host = NULL;
   needclr = SDL_TRUE;
 
   src_pixel = oric->scr;
@@ -442,19 +400,229 @@ void render_video_sw_32bpp( struct machine *oric, SDL_bool doublesize )
     dst_scanline += screen->pitch;
   }
 
-  for( ; y<228; y++, dst_scanline+=screen->pitch )
+  for( ; y<228; y++, src_pixel+=240, dst_scanline+=screen->pitch )
+    swline_expand32( (Uint32*)dst_scanline, src_pixel, &spal[0], 240 );
+}
+
+// Mix b into a by w/256, a byte at a time
+static Uint32 render_sw_blend( Uint32 a, Uint32 b, Uint32 w )
+{
+  Uint32 lo, hi;
+
+  lo = ( ( ( a & 0x00ff00ff ) * ( 256 - w ) + ( b & 0x00ff00ff ) * w ) >> 8 ) & 0x00ff00ff;
+  hi = ( ( ( a >> 8 ) & 0x00ff00ff ) * ( 256 - w ) + ( ( b >> 8 ) & 0x00ff00ff ) * w ) & 0xff00ff00;
+  return lo | hi;
+}
+
+// Scale a row of screen across into dst
+static void render_sw_hscale( Uint8 *dst, Uint8 *src )
+{
+  Uint32 *src32 = (Uint32 *)src, *dst32 = (Uint32 *)dst;
+  Uint16 *src16 = (Uint16 *)src, *dst16 = (Uint16 *)dst;
+  int x;
+
+  if( pixel_size == 2 )
   {
-    dst_pixel = (Uint32*)dst_scanline;
+    for( x=0; x<scl_w; x++ )
+      dst16[x] = src16[scl_col[x]];
+    return;
+  }
 
-    for( x=240; x!=0; --x )
-      *(dst_pixel++) = pal[*(src_pixel++)];
+  for( x=0; x<scl_w; x++ )
+  {
+    if( scl_colw[x] )
+      dst32[x] = render_sw_blend( src32[scl_col[x]], src32[scl_col[x]+1], scl_colw[x] );
+    else
+      dst32[x] = src32[scl_col[x]];
   }
 }
 
+// Row r of screen scaled across, kept for the next display row too
+static Uint32 *render_sw_scaledrow( int r )
+{
+  int i = r & 1;
+
+  if( scl_lineof[i] != r )
+  {
+    render_sw_hscale( (Uint8 *)scl_line[i], ((Uint8 *)screen->pixels) + r * screen->pitch );
+    scl_lineof[i] = r;
+  }
+  return scl_line[i];
+}
+
+// Scale screen into display. Each display row is a source row scaled
+// across, a copy of the display row above it if that came from the
+// same place, or with swsmooth, a blend of two source rows.
+static void render_sw_scale( void )
+{
+  int x, y;
+  Uint8 *dst;
+  Uint32 *dst32, *a, *b;
+
+  scl_lineof[0] = scl_lineof[1] = -1;
+
+  dst = ((Uint8 *)display->pixels) + scl_y * display->pitch + scl_x * pixel_size;
+  for( y=0; y<scl_h; y++, dst+=display->pitch )
+  {
+    // Not if it means reading back video memory, though
+    if( ( y > 0 ) && ( !hwsurface ) &&
+        ( scl_row[y] == scl_row[y-1] ) && ( scl_roww[y] == scl_roww[y-1] ) )
+    {
+      memcpy( dst, dst - display->pitch, scl_w * pixel_size );
+      continue;
+    }
+
+    if( !scl_roww[y] )
+    {
+      render_sw_hscale( dst, ((Uint8 *)screen->pixels) + scl_row[y] * screen->pitch );
+      continue;
+    }
+
+    a = render_sw_scaledrow( scl_row[y] );
+    b = render_sw_scaledrow( scl_row[y]+1 );
+    dst32 = (Uint32 *)dst;
+    for( x=0; x<scl_w; x++ )
+      dst32[x] = render_sw_blend( a[x], b[x], scl_roww[y] );
+  }
+}
+
+// For each of n display columns (or rows), the source column and the
+// weight of the one after it, for srcn source columns.
+// Without swsmooth it is just the nearest source pixel. With it, the
+// source pixels are mixed by how much of the display pixel each one
+// covers, which is at most two of them when f >= 1 (32bpp only).
+static void render_sw_scalemap( Uint16 *map, Uint16 *weight, int n, int srcn )
+{
+  double f = (double)n / srcn, e;
+  int i, a;
+
+  for( i=0; i<n; i++ )
+  {
+    if( ( swsmooth ) && ( pixel_size == 4 ) )
+    {
+      a = (int)( i / f );
+      e = ( i + 1 ) / f;
+      weight[i] = ( e > a+1 ) ? (Uint16)( ( e - (a+1) ) * f * 256.0 + 0.5 ) : 0;
+      if( weight[i] > 256 ) weight[i] = 256;
+    } else {
+      a = (int)( ( i + 0.5 ) / f );
+      weight[i] = 0;
+    }
+
+    if( a >= srcn-1 )
+    {
+      a = srcn-1;
+      weight[i] = 0;
+    }
+    map[i] = a;
+  }
+}
+
+// Mouse positions come in display coordinates, but everything that
+// looks at them wants screen ones
+void render_sw_mapmouse( SDL_Event *ev )
+{
+  int x, y;
+
+  if( !scaling ) return;
+
+  switch( ev->type )
+  {
+    case SDL_MOUSEMOTION:
+      x = ( ev->motion.x - scl_x ) * screen->w / scl_w;
+      y = ( ev->motion.y - scl_y ) * screen->h / scl_h;
+      ev->motion.x = ( x < 0 ) ? 0 : ( ( x >= screen->w ) ? screen->w-1 : x );
+      ev->motion.y = ( y < 0 ) ? 0 : ( ( y >= screen->h ) ? screen->h-1 : y );
+      break;
+
+    case SDL_MOUSEBUTTONDOWN:
+    case SDL_MOUSEBUTTONUP:
+      x = ( ev->button.x - scl_x ) * screen->w / scl_w;
+      y = ( ev->button.y - scl_y ) * screen->h / scl_h;
+      ev->button.x = ( x < 0 ) ? 0 : ( ( x >= screen->w ) ? screen->w-1 : x );
+      ev->button.y = ( y < 0 ) ? 0 : ( ( y >= screen->h ) ? screen->h-1 : y );
+      break;
+  }
+}
+
+/*
+** Set up the video display for a w x h screen. If swscale isn't 1,
+** screen is a surface of its own, scaled up into a bigger display.
+** A swscale of 0 fits it to the desktop: all of it in fullscreen
+** (with black bars to keep the shape), or in a window the biggest
+** whole number factor that fits.
+*/
+static SDL_bool render_sw_setmode( struct machine *oric, int w, int h, Sint32 surfacemode )
+{
+  double f = swscale;
+  int dw, dh;
+
+  scaling = SDL_FALSE;
+
+  if( f == 0.0 )
+  {
+    f = 1.0;
+    if( ( desk_w > 0 ) && ( desk_h > 0 ) )
+    {
+      f = (double)desk_w / w;
+      if( (double)desk_h / h < f ) f = (double)desk_h / h;
+      if( !fullscreen ) f = floor( f );
+    }
+    if( f < 1.0 ) f = 1.0;
+  }
+
+  dw = scl_w = (int)( w * f + 0.5 );
+  dh = scl_h = (int)( h * f + 0.5 );
+  if( ( swscale == 0.0 ) && ( fullscreen ) && ( desk_w >= scl_w ) && ( desk_h >= scl_h ) )
+  {
+    dw = desk_w;
+    dh = desk_h;
+  }
+
+  if( ( dw == w ) && ( dh == h ) )
+  {
+    display = screen = SDL_COMPAT_SetVideoMode( w, h, oric->sw_depth, surfacemode );
+    return ( screen != NULL );
+  }
+
+  display = SDL_COMPAT_SetVideoMode( dw, dh, oric->sw_depth, surfacemode );
+  if( !display ) return SDL_FALSE;
+
+  screen = SDL_CreateRGBSurface( SDL_SWSURFACE, w, h, oric->sw_depth,
+                                 display->format->Rmask, display->format->Gmask,
+                                 display->format->Bmask, display->format->Amask );
+  if( !screen ) return SDL_FALSE;
+
+  scl_line[0] = malloc( scl_w * 2 * sizeof( Uint32 ) + ( scl_w + scl_h ) * 2 * sizeof( Uint16 ) );
+  if( !scl_line[0] )
+  {
+    SDL_FreeSurface( screen );
+    screen = NULL;
+    return SDL_FALSE;
+  }
+  scl_line[1] = scl_line[0] + scl_w;
+  scl_col  = (Uint16 *)( scl_line[1] + scl_w );
+  scl_colw = scl_col + scl_w;
+  scl_row  = scl_colw + scl_w;
+  scl_roww = scl_row + scl_h;
+
+  render_sw_scalemap( scl_col, scl_colw, scl_w, w );
+  render_sw_scalemap( scl_row, scl_roww, scl_h, h );
+  scl_x = ( dw - scl_w ) / 2;
+  scl_y = ( dh - scl_h ) / 2;
+
+  SDL_FillRect( display, NULL, 0 );
+  scaling = SDL_TRUE;
+  return SDL_TRUE;
+}
+
 void render_sw_detectvideo( struct machine *oric )
 {
   int BitsPerPixel = SDL_COMPAT_GetBitsPerPixel();
 
+  // Before any video mode is set, so this is the desktop
+  SDL_COMPAT_GetDesktopSize( &desk_w, &desk_h );
+
   // Guess the suitable video mode, either 16bpp or 32bpp
   oric->sw_depth = 16;
 
@@ -478,7 +646,8 @@ void preinit_render_sw( struct machine *oric )
   Sint32 i;
 
   // Screen surface is not set yet
-  screen = NULL;
+  screen = display = NULL;
+  scaling = SDL_FALSE;
 
   // Images are not set yet
   for( i=0; i<NUM_GIMG; i++ )
@@ -488,22 +657,26 @@ void preinit_render_sw( struct machine *oric )
 SDL_bool render_togglefullscreen_sw( struct machine *oric )
 {
 #if defined(__amigaos4__) || defined(__linux__) || defined(__MORPHOS__)
-  // Use SDL_WM_ToggleFullScreen on systems where it is supported
-  if( SDL_COMPAT_WM_ToggleFullScreen( screen ) )
+  // Use SDL_WM_ToggleFullScreen on systems where it is supported,
+  // unless the picture is scaled, as the size might change too
+  if( swscale == 1.0 )
   {
-    fullscreen = !fullscreen;
-    return SDL_TRUE;
+    if( SDL_COMPAT_WM_ToggleFullScreen( display ) )
+    {
+      fullscreen = !fullscreen;
+      return SDL_TRUE;
+    }
+
+    return SDL_FALSE;
   }
+#endif
 
-  return SDL_FALSE;
-#else
   oric->shut_render( oric );
   fullscreen = !fullscreen;
   if( oric->init_render( oric ) ) return SDL_TRUE;
   set_render_mode( oric, RENDERMODE_NULL );
   oric->emu_mode = EM_PLEASEQUIT; 
   return SDL_FALSE;
-#endif
 }
 
 // --- guiimg_to_img_X_bpp template function ----------------------------------
@@ -550,13 +723,7 @@ SDL_bool init_render_sw( struct machine *oric )
   if( hwsurface ) { surfacemode &= ~SDL_SWSURFACE; surfacemode |= SDL_COMPAT_HWSURFACE; }
 
   // Try to setup the video display
-  if (oric->show_keyboard) {
-      screen = SDL_COMPAT_SetVideoMode( 640, 480+240, oric->sw_depth, surfacemode );
-  } else {
-      screen = SDL_COMPAT_SetVideoMode( 640, 480, oric->sw_depth, surfacemode );
-  }
-    
-  if( !screen )
+  if( !render_sw_setmode( oric, 640, oric->show_keyboard ? 480+240 : 480, surfacemode ) )
   {
     printf( "SDL video failed\n" );
     return SDL_FALSE;
@@ -598,14 +765,22 @@ SDL_bool init_render_sw( struct machine *oric )
   for( i=0; i<8*2; i++ )
     dpal[i] = (pal[i]<<16)|pal[i];
 
+  // And the tables for drawing whole lines at once
+  swline_init();
+  swline_setpal( &spal[0],  &pal[0] );
+  swline_setpal( &spal[1],  &pal[8] );
+  swline_setpal( &sdpal[0], &dpal[0] );
+  swline_setpal( &sdpal[1], &dpal[8] );
+
   // For the first frame rendered, we need to clean the screen
   needclr = SDL_TRUE;
-  refreshstatus = SDL_TRUE;
+  oric->refreshstatus = SDL_TRUE;
 
   // Calculate the offset to render the screen
   offset_top = (240 - 226) * screen->pitch;
   offset_top += pixel_size * 80;
 
+  oric->vid_host = NULL;
   ula_set_dirty( oric );
 
   // Job done
@@ -616,6 +791,16 @@ void shut_render_sw( struct machine *oric )
 {
   Sint32 i;
 
+  oric->vid_host = NULL;
+
+  if( scaling )
+  {
+    SDL_FreeSurface( screen );
+    free( scl_line[0] );
+    screen = display;
+    scaling = SDL_FALSE;
+  }
+
   for( i=0; i<NUM_GIMG; i++  )
   {
     if( mgimg[i] ) free( mgimg[i] );
@@ -35,3 +35,4 @@ SDL_bool init_render_sw( struct machine *oric );
 void shut_render_sw( struct machine *oric );
 
 void render_sw_detectvideo( struct machine *oric );
+void render_sw_mapmouse( SDL_Event *ev );
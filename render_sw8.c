@@ -49,7 +49,6 @@ extern struct textzone *tz[NUM_TZ];
 extern unsigned char sgpal[];
 extern Uint8 oricpalette[];
 extern struct guiimg gimgs[NUM_GIMG];
-extern SDL_bool refreshstatus;
 static Uint8 *mgimg[NUM_GIMG];
 static int next_gimgcol;
 static SDL_Color colours[256];
@@ -112,7 +111,7 @@ void render_begin_sw8( struct machine *oric )
   
   if( oric->newstatusstr )
   {
-    refreshstatus = SDL_TRUE;
+    oric->refreshstatus = SDL_TRUE;
     oric->newstatusstr = SDL_FALSE;
   }
 }
@@ -460,7 +459,7 @@ SDL_bool init_render_sw8( struct machine *oric )
 
   // For the first frame rendered, we need to clean the screen
   needclr = SDL_TRUE;
-  refreshstatus = SDL_TRUE;
+  oric->refreshstatus = SDL_TRUE;
 
   // Calculate the offset to render the screen
   offset_top = (240 - 226) * screen->pitch + 80;
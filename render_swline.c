@@ -0,0 +1,296 @@
+/*
+**  Oricutron
+**  Copyright (C) 2009-2014 Peter Gordon
+**
+**  This program is free software; you can redistribute it and/or
+**  modify it under the terms of the GNU General Public License
+**  as published by the Free Software Foundation, version 2
+**  of the License.
+**
+**  This program is distributed in the hope that it will be useful,
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**  GNU General Public License for more details.
+**
+**  You should have received a copy of the GNU General Public License
+**  along with this program; if not, write to the Free Software
+**  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+**
+**  Expanding lines of colour indices into pixels, for the software renderer
+*/
+
+#include <string.h>
+
+#include "system.h"
+#include "render_swline.h"
+
+// With GCC or clang on x86, there are SSSE3 and AVX2 versions too,
+// picked at run time. They look up each byte of the pixels in a 16
+// entry table with pshufb, so 16 (or 32) pixels are done at once.
+#if defined(__GNUC__) && ( defined(__x86_64__) || defined(__i386__) )
+#define SWLINE_X86
+#include <immintrin.h>
+#define SSSE3 __attribute__((target("ssse3")))
+#define AVX2  __attribute__((target("avx2")))
+#endif
+
+static void expand32_c( Uint32 *dst, const Uint8 *src, const struct swpal *sp, int n )
+{
+  for( ; n>0; n-- )
+    *(dst++) = sp->pal[*(src++)];
+}
+
+static void expand32x2_c( Uint32 *dst, const Uint8 *src, const struct swpal *sp, int n )
+{
+  Uint32 c;
+
+  for( ; n>0; n-- )
+  {
+    c = sp->pal[*(src++)];
+    *(dst++) = c;
+    *(dst++) = c;
+  }
+}
+
+static void expand16_c( Uint16 *dst, const Uint8 *src, const struct swpal *sp, int n )
+{
+  for( ; n>0; n-- )
+    *(dst++) = (Uint16)sp->pal[*(src++)];
+}
+
+void (*swline_expand32)( Uint32 *, const Uint8 *, const struct swpal *, int ) = expand32_c;
+void (*swline_expand32x2)( Uint32 *, const Uint8 *, const struct swpal *, int ) = expand32x2_c;
+void (*swline_expand16)( Uint16 *, const Uint8 *, const struct swpal *, int ) = expand16_c;
+
+#ifdef SWLINE_X86
+
+// 16 pixels of each kind. These are also inlined into the AVX2
+// versions for what is left over after the 32 pixel steps.
+
+SSSE3 static inline void step32_ssse3( Uint32 *dst, const Uint8 *src, const struct swpal *sp )
+{
+  __m128i v, lo01, hi01, lo23, hi23;
+  __m128i t0 = _mm_loadu_si128( (const __m128i *)sp->planes[0] );
+  __m128i t1 = _mm_loadu_si128( (const __m128i *)sp->planes[1] );
+  __m128i t2 = _mm_loadu_si128( (const __m128i *)sp->planes[2] );
+  __m128i t3 = _mm_loadu_si128( (const __m128i *)sp->planes[3] );
+
+  v = _mm_loadu_si128( (const __m128i *)src );
+  lo01 = _mm_unpacklo_epi8( _mm_shuffle_epi8( t0, v ), _mm_shuffle_epi8( t1, v ) );
+  hi01 = _mm_unpackhi_epi8( _mm_shuffle_epi8( t0, v ), _mm_shuffle_epi8( t1, v ) );
+  lo23 = _mm_unpacklo_epi8( _mm_shuffle_epi8( t2, v ), _mm_shuffle_epi8( t3, v ) );
+  hi23 = _mm_unpackhi_epi8( _mm_shuffle_epi8( t2, v ), _mm_shuffle_epi8( t3, v ) );
+  _mm_storeu_si128( (__m128i *)&dst[ 0], _mm_unpacklo_epi16( lo01, lo23 ) );
+  _mm_storeu_si128( (__m128i *)&dst[ 4], _mm_unpackhi_epi16( lo01, lo23 ) );
+  _mm_storeu_si128( (__m128i *)&dst[ 8], _mm_unpacklo_epi16( hi01, hi23 ) );
+  _mm_storeu_si128( (__m128i *)&dst[12], _mm_unpackhi_epi16( hi01, hi23 ) );
+}
+
+SSSE3 static inline void step32x2_ssse3( Uint32 *dst, const Uint8 *src, const struct swpal *sp )
+{
+  __m128i v, lo01, hi01, lo23, hi23, p;
+  __m128i t0 = _mm_loadu_si128( (const __m128i *)sp->planes[0] );
+  __m128i t1 = _mm_loadu_si128( (const __m128i *)sp->planes[1] );
+  __m128i t2 = _mm_loadu_si128( (const __m128i *)sp->planes[2] );
+  __m128i t3 = _mm_loadu_si128( (const __m128i *)sp->planes[3] );
+
+  v = _mm_loadu_si128( (const __m128i *)src );
+  lo01 = _mm_unpacklo_epi8( _mm_shuffle_epi8( t0, v ), _mm_shuffle_epi8( t1, v ) );
+  hi01 = _mm_unpackhi_epi8( _mm_shuffle_epi8( t0, v ), _mm_shuffle_epi8( t1, v ) );
+  lo23 = _mm_unpacklo_epi8( _mm_shuffle_epi8( t2, v ), _mm_shuffle_epi8( t3, v ) );
+  hi23 = _mm_unpackhi_epi8( _mm_shuffle_epi8( t2, v ), _mm_shuffle_epi8( t3, v ) );
+
+  p = _mm_unpacklo_epi16( lo01, lo23 );
+  _mm_storeu_si128( (__m128i *)&dst[ 0], _mm_unpacklo_epi32( p, p ) );
+  _mm_storeu_si128( (__m128i *)&dst[ 4], _mm_unpackhi_epi32( p, p ) );
+  p = _mm_unpackhi_epi16( lo01, lo23 );
+  _mm_storeu_si128( (__m128i *)&dst[ 8], _mm_unpacklo_epi32( p, p ) );
+  _mm_storeu_si128( (__m128i *)&dst[12], _mm_unpackhi_epi32( p, p ) );
+  p = _mm_unpacklo_epi16( hi01, hi23 );
+  _mm_storeu_si128( (__m128i *)&dst[16], _mm_unpacklo_epi32( p, p ) );
+  _mm_storeu_si128( (__m128i *)&dst[20], _mm_unpackhi_epi32( p, p ) );
+  p = _mm_unpackhi_epi16( hi01, hi23 );
+  _mm_storeu_si128( (__m128i *)&dst[24], _mm_unpacklo_epi32( p, p ) );
+  _mm_storeu_si128( (__m128i *)&dst[28], _mm_unpackhi_epi32( p, p ) );
+}
+
+SSSE3 static inline void step16_ssse3( Uint16 *dst, const Uint8 *src, const struct swpal *sp )
+{
+  __m128i v, b0, b1;
+  __m128i t0 = _mm_loadu_si128( (const __m128i *)sp->planes[0] );
+  __m128i t1 = _mm_loadu_si128( (const __m128i *)sp->planes[1] );
+
+  v  = _mm_loadu_si128( (const __m128i *)src );
+  b0 = _mm_shuffle_epi8( t0, v );
+  b1 = _mm_shuffle_epi8( t1, v );
+  _mm_storeu_si128( (__m128i *)&dst[0], _mm_unpacklo_epi8( b0, b1 ) );
+  _mm_storeu_si128( (__m128i *)&dst[8], _mm_unpackhi_epi8( b0, b1 ) );
+}
+
+SSSE3 static void expand32_ssse3( Uint32 *dst, const Uint8 *src, const struct swpal *sp, int n )
+{
+  int x;
+
+  for( x=0; x+16<=n; x+=16 )
+    step32_ssse3( &dst[x], &src[x], sp );
+  expand32_c( &dst[x], &src[x], sp, n-x );
+}
+
+SSSE3 static void expand32x2_ssse3( Uint32 *dst, const Uint8 *src, const struct swpal *sp, int n )
+{
+  int x;
+
+  for( x=0; x+16<=n; x+=16 )
+    step32x2_ssse3( &dst[x*2], &src[x], sp );
+  expand32x2_c( &dst[x*2], &src[x], sp, n-x );
+}
+
+SSSE3 static void expand16_ssse3( Uint16 *dst, const Uint8 *src, const struct swpal *sp, int n )
+{
+  int x;
+
+  for( x=0; x+16<=n; x+=16 )
+    step16_ssse3( &dst[x], &src[x], sp );
+  expand16_c( &dst[x], &src[x], sp, n-x );
+}
+
+// The AVX2 unpacks work within each 128 bit half, so the first half
+// ends up holding pixels from the first 16 indices and the second
+// half from the next 16. _mm256_permute2x128_si256 puts them back
+// in order.
+
+AVX2 static void expand32_avx2( Uint32 *dst, const Uint8 *src, const struct swpal *sp, int n )
+{
+  __m256i t0, t1, t2, t3, v, lo01, hi01, lo23, hi23, q0, q1, q2, q3;
+  int x;
+
+  t0 = _mm256_broadcastsi128_si256( _mm_loadu_si128( (const __m128i *)sp->planes[0] ) );
+  t1 = _mm256_broadcastsi128_si256( _mm_loadu_si128( (const __m128i *)sp->planes[1] ) );
+  t2 = _mm256_broadcastsi128_si256( _mm_loadu_si128( (const __m128i *)sp->planes[2] ) );
+  t3 = _mm256_broadcastsi128_si256( _mm_loadu_si128( (const __m128i *)sp->planes[3] ) );
+
+  for( x=0; x+32<=n; x+=32 )
+  {
+    v = _mm256_loadu_si256( (const __m256i *)&src[x] );
+    lo01 = _mm256_unpacklo_epi8( _mm256_shuffle_epi8( t0, v ), _mm256_shuffle_epi8( t1, v ) );
+    hi01 = _mm256_unpackhi_epi8( _mm256_shuffle_epi8( t0, v ), _mm256_shuffle_epi8( t1, v ) );
+    lo23 = _mm256_unpacklo_epi8( _mm256_shuffle_epi8( t2, v ), _mm256_shuffle_epi8( t3, v ) );
+    hi23 = _mm256_unpackhi_epi8( _mm256_shuffle_epi8( t2, v ), _mm256_shuffle_epi8( t3, v ) );
+    q0 = _mm256_unpacklo_epi16( lo01, lo23 );  // 0-3   | 16-19
+    q1 = _mm256_unpackhi_epi16( lo01, lo23 );  // 4-7   | 20-23
+    q2 = _mm256_unpacklo_epi16( hi01, hi23 );  // 8-11  | 24-27
+    q3 = _mm256_unpackhi_epi16( hi01, hi23 );  // 12-15 | 28-31
+    _mm256_storeu_si256( (__m256i *)&dst[x   ], _mm256_permute2x128_si256( q0, q1, 0x20 ) );
+    _mm256_storeu_si256( (__m256i *)&dst[x+ 8], _mm256_permute2x128_si256( q2, q3, 0x20 ) );
+    _mm256_storeu_si256( (__m256i *)&dst[x+16], _mm256_permute2x128_si256( q0, q1, 0x31 ) );
+    _mm256_storeu_si256( (__m256i *)&dst[x+24], _mm256_permute2x128_si256( q2, q3, 0x31 ) );
+  }
+
+  for( ; x+16<=n; x+=16 )
+    step32_ssse3( &dst[x], &src[x], sp );
+  expand32_c( &dst[x], &src[x], sp, n-x );
+}
+
+AVX2 static void expand32x2_avx2( Uint32 *dst, const Uint8 *src, const struct swpal *sp, int n )
+{
+  __m256i t0, t1, t2, t3, v, lo01, hi01, lo23, hi23, q[4], d, e;
+  int x, i;
+
+  t0 = _mm256_broadcastsi128_si256( _mm_loadu_si128( (const __m128i *)sp->planes[0] ) );
+  t1 = _mm256_broadcastsi128_si256( _mm_loadu_si128( (const __m128i *)sp->planes[1] ) );
+  t2 = _mm256_broadcastsi128_si256( _mm_loadu_si128( (const __m128i *)sp->planes[2] ) );
+  t3 = _mm256_broadcastsi128_si256( _mm_loadu_si128( (const __m128i *)sp->planes[3] ) );
+
+  for( x=0; x+32<=n; x+=32 )
+  {
+    v = _mm256_loadu_si256( (const __m256i *)&src[x] );
+    lo01 = _mm256_unpacklo_epi8( _mm256_shuffle_epi8( t0, v ), _mm256_shuffle_epi8( t1, v ) );
+    hi01 = _mm256_unpackhi_epi8( _mm256_shuffle_epi8( t0, v ), _mm256_shuffle_epi8( t1, v ) );
+    lo23 = _mm256_unpacklo_epi8( _mm256_shuffle_epi8( t2, v ), _mm256_shuffle_epi8( t3, v ) );
+    hi23 = _mm256_unpackhi_epi8( _mm256_shuffle_epi8( t2, v ), _mm256_shuffle_epi8( t3, v ) );
+    q[0] = _mm256_unpacklo_epi16( lo01, lo23 );
+    q[1] = _mm256_unpackhi_epi16( lo01, lo23 );
+    q[2] = _mm256_unpacklo_epi16( hi01, hi23 );
+    q[3] = _mm256_unpackhi_epi16( hi01, hi23 );
+
+    // Pixels 4i to 4i+3 of each half, doubled
+    for( i=0; i<4; i++ )
+    {
+      d = _mm256_unpacklo_epi32( q[i], q[i] );
+      e = _mm256_unpackhi_epi32( q[i], q[i] );
+      _mm256_storeu_si256( (__m256i *)&dst[x*2+i*8   ], _mm256_permute2x128_si256( d, e, 0x20 ) );
+      _mm256_storeu_si256( (__m256i *)&dst[x*2+i*8+32], _mm256_permute2x128_si256( d, e, 0x31 ) );
+    }
+  }
+
+  for( ; x+16<=n; x+=16 )
+    step32x2_ssse3( &dst[x*2], &src[x], sp );
+  expand32x2_c( &dst[x*2], &src[x], sp, n-x );
+}
+
+AVX2 static void expand16_avx2( Uint16 *dst, const Uint8 *src, const struct swpal *sp, int n )
+{
+  __m256i t0, t1, v, b0, b1, lo, hi;
+  int x;
+
+  t0 = _mm256_broadcastsi128_si256( _mm_loadu_si128( (const __m128i *)sp->planes[0] ) );
+  t1 = _mm256_broadcastsi128_si256( _mm_loadu_si128( (const __m128i *)sp->planes[1] ) );
+
+  for( x=0; x+32<=n; x+=32 )
+  {
+    v  = _mm256_loadu_si256( (const __m256i *)&src[x] );
+    b0 = _mm256_shuffle_epi8( t0, v );
+    b1 = _mm256_shuffle_epi8( t1, v );
+    lo = _mm256_unpacklo_epi8( b0, b1 );  // 0-7  | 16-23
+    hi = _mm256_unpackhi_epi8( b0, b1 );  // 8-15 | 24-31
+    _mm256_storeu_si256( (__m256i *)&dst[x   ], _mm256_permute2x128_si256( lo, hi, 0x20 ) );
+    _mm256_storeu_si256( (__m256i *)&dst[x+16], _mm256_permute2x128_si256( lo, hi, 0x31 ) );
+  }
+
+  for( ; x+16<=n; x+=16 )
+    step16_ssse3( &dst[x], &src[x], sp );
+  expand16_c( &dst[x], &src[x], sp, n-x );
+}
+
+#endif
+
+// Set up the colours, and split them into a table per byte of
+// the pixels (in memory order) for the SIMD versions
+void swline_setpal( struct swpal *sp, const Uint32 *pal )
+{
+  Uint8 *p;
+  int i, k;
+
+  memset( sp, 0, sizeof( struct swpal ) );
+  for( i=0; i<8; i++ )
+  {
+    sp->pal[i] = pal[i];
+    p = (Uint8 *)&sp->pal[i];
+    for( k=0; k<4; k++ )
+      sp->planes[k][i] = p[k];
+  }
+}
+
+void swline_init( void )
+{
+#ifdef SWLINE_X86
+  __builtin_cpu_init();
+  if( __builtin_cpu_supports( "avx2" ) )
+  {
+    swline_expand32   = expand32_avx2;
+    swline_expand32x2 = expand32x2_avx2;
+    swline_expand16   = expand16_avx2;
+    return;
+  }
+  if( __builtin_cpu_supports( "ssse3" ) )
+  {
+    swline_expand32   = expand32_ssse3;
+    swline_expand32x2 = expand32x2_ssse3;
+    swline_expand16   = expand16_ssse3;
+    return;
+  }
+#endif
+  swline_expand32   = expand32_c;
+  swline_expand32x2 = expand32x2_c;
+  swline_expand16   = expand16_c;
+}
@@ -0,0 +1,39 @@
+/*
+**  Oricutron
+**  Copyright (C) 2009-2014 Peter Gordon
+**
+**  This program is free software; you can redistribute it and/or
+**  modify it under the terms of the GNU General Public License
+**  as published by the Free Software Foundation, version 2
+**  of the License.
+**
+**  This program is distributed in the hope that it will be useful,
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**  GNU General Public License for more details.
+**
+**  You should have received a copy of the GNU General Public License
+**  along with this program; if not, write to the Free Software
+**  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+**
+**  Expanding lines of colour indices into pixels, for the software renderer
+*/
+
+// The colours of a line, with the tables the SIMD versions use
+struct swpal
+{
+  Uint32 pal[8];
+  Uint8  planes[4][16];
+};
+
+// Each of these expands n colour indices (0-7) from src through sp:
+//   swline_expand32   - one 32 bit pixel per index (or a 16bpp pair)
+//   swline_expand32x2 - two 32 bit pixels per index
+//   swline_expand16   - one 16 bit pixel per index
+// They are set to the best version for the CPU by swline_init.
+extern void (*swline_expand32)( Uint32 *dst, const Uint8 *src, const struct swpal *sp, int n );
+extern void (*swline_expand32x2)( Uint32 *dst, const Uint8 *src, const struct swpal *sp, int n );
+extern void (*swline_expand16)( Uint16 *dst, const Uint8 *src, const struct swpal *sp, int n );
+
+void swline_setpal( struct swpal *sp, const Uint32 *pal );
+void swline_init( void );
@@ -44,103 +44,101 @@
 extern char diskpath[];
 
 #define MAX_BLOCK (262144)
-static unsigned char *buf;
-static int offs = 0;
 
-#define PUTU32(val) ok=putu32(ok, (Uint32)val)
-static SDL_bool putu32(SDL_bool stillok, Uint32 val)
+#define PUTU32(val) ok=putu32(oric, ok, (Uint32)val)
+static SDL_bool putu32(struct machine *oric, SDL_bool stillok, Uint32 val)
 {
   if (!stillok) return SDL_FALSE;
-  if ((offs+4) > MAX_BLOCK) return SDL_FALSE;
-  buf[offs++] = (val>>24)&0xff;
-  buf[offs++] = (val>>16)&0xff;
-  buf[offs++] = (val>>8)&0xff;
-  buf[offs++] = val&0xff;
+  if ((oric->snapoffs+4) > MAX_BLOCK) return SDL_FALSE;
+  oric->snapbuf[oric->snapoffs++] = (val>>24)&0xff;
+  oric->snapbuf[oric->snapoffs++] = (val>>16)&0xff;
+  oric->snapbuf[oric->snapoffs++] = (val>>8)&0xff;
+  oric->snapbuf[oric->snapoffs++] = val&0xff;
   return SDL_TRUE;
 }
 
-#define PUTU16(val) ok=putu16(ok, (Uint16)val)
-static SDL_bool putu16(SDL_bool stillok, Uint16 val)
+#define PUTU16(val) ok=putu16(oric, ok, (Uint16)val)
+static SDL_bool putu16(struct machine *oric, SDL_bool stillok, Uint16 val)
 {
   if (!stillok) return SDL_FALSE;
-  if ((offs+2) > MAX_BLOCK) return SDL_FALSE;
-  buf[offs++] = (val>>8)&0xff;
-  buf[offs++] = val&0xff;
+  if ((oric->snapoffs+2) > MAX_BLOCK) return SDL_FALSE;
+  oric->snapbuf[oric->snapoffs++] = (val>>8)&0xff;
+  oric->snapbuf[oric->snapoffs++] = val&0xff;
   return SDL_TRUE;
 }
 
-#define PUTU8(val) ok=putu8(ok, (Uint8)val)
-static SDL_bool putu8(SDL_bool stillok, Uint8 val)
+#define PUTU8(val) ok=putu8(oric, ok, (Uint8)val)
+static SDL_bool putu8(struct machine *oric, SDL_bool stillok, Uint8 val)
 {
   if (!stillok) return SDL_FALSE;
-  if (offs >= MAX_BLOCK) return SDL_FALSE;
-  buf[offs++] = val&0xff;
+  if (oric->snapoffs >= MAX_BLOCK) return SDL_FALSE;
+  oric->snapbuf[oric->snapoffs++] = val&0xff;
   return SDL_TRUE;
 }
 
-#define PUTDATA(data, size) ok=putdata(ok, data, size)
-static SDL_bool putdata(SDL_bool stillok, unsigned char *data, Uint32 size)
+#define PUTDATA(data, size) ok=putdata(oric, ok, data, size)
+static SDL_bool putdata(struct machine *oric, SDL_bool stillok, unsigned char *data, Uint32 size)
 {
   if (!stillok) return SDL_FALSE;
-  if ((offs+size) > MAX_BLOCK) return SDL_FALSE;
-  memcpy( &buf[offs], data, size );
-  offs += size;
+  if ((oric->snapoffs+size) > MAX_BLOCK) return SDL_FALSE;
+  memcpy( &oric->snapbuf[oric->snapoffs], data, size );
+  oric->snapoffs += size;
   return SDL_TRUE;
 }
 
-#define PUTSTR(str) ok=putstr(ok, str)
-static SDL_bool putstr(SDL_bool stillok, char *str)
+#define PUTSTR(str) ok=putstr(oric, ok, str)
+static SDL_bool putstr(struct machine *oric, SDL_bool stillok, char *str)
 {
   if (!stillok) return SDL_FALSE;
-  stillok = putu32(stillok, (int)strlen(str)+1);
-  return putdata(stillok, (unsigned char *)str, (int)strlen(str)+1);
+  stillok = putu32(oric, stillok, (int)strlen(str)+1);
+  return putdata(oric, stillok, (unsigned char *)str, (int)strlen(str)+1);
 }
 
-#define WRITEBLOCK() ok=writeblock(ok, f)
-static SDL_bool writeblock(SDL_bool stillok, FILE *f)
+#define WRITEBLOCK() ok=writeblock(oric, ok, f)
+static SDL_bool writeblock(struct machine *oric, SDL_bool stillok, FILE *f)
 {
   if (!stillok) return SDL_FALSE;
-  if (offs <= 8) return SDL_TRUE; // No block to write
+  if (oric->snapoffs <= 8) return SDL_TRUE; // No block to write
 
-  buf[4] = ((offs-8)>>24)&0xff;
-  buf[5] = ((offs-8)>>16)&0xff;
-  buf[6] = ((offs-8)>>8)&0xff;
-  buf[7] = (offs-8)&0xff;
+  oric->snapbuf[4] = ((oric->snapoffs-8)>>24)&0xff;
+  oric->snapbuf[5] = ((oric->snapoffs-8)>>16)&0xff;
+  oric->snapbuf[6] = ((oric->snapoffs-8)>>8)&0xff;
+  oric->snapbuf[7] = (oric->snapoffs-8)&0xff;
 
-  stillok = (fwrite(buf, offs, 1, f) == 1);
-  offs = 0;
+  stillok = (fwrite(oric->snapbuf, oric->snapoffs, 1, f) == 1);
+  oric->snapoffs = 0;
   return stillok;
 }
 
 // ID must be 4 bytes long!
-#define NEWBLOCK(id) ok=newblock(ok, id, f)
-static SDL_bool newblock(SDL_bool stillok, char *id, FILE *f)
+#define NEWBLOCK(id) ok=newblock(oric, ok, id, f)
+static SDL_bool newblock(struct machine *oric, SDL_bool stillok, char *id, FILE *f)
 {
   if (!stillok) return SDL_FALSE;
   // Got an old block?
-  if (!writeblock(stillok, f)) return SDL_FALSE;
+  if (!writeblock(oric, stillok, f)) return SDL_FALSE;
 
   // Start a new one!
-  memcpy(buf, id, 4);
-  offs = 8;
+  memcpy(oric->snapbuf, id, 4);
+  oric->snapoffs = 8;
   return SDL_TRUE;
 }
 
-#define DATABLOCK(data, len) ok = datablock(ok, data, len, f)
-static SDL_bool datablock(SDL_bool stillok, unsigned char *data, Uint32 len, FILE *f)
+#define DATABLOCK(data, len) ok = datablock(oric, ok, data, len, f)
+static SDL_bool datablock(struct machine *oric, SDL_bool stillok, unsigned char *data, Uint32 len, FILE *f)
 {
   Uint32 lenbe = _BE32(len);
   if (!stillok) return SDL_FALSE;
   // Anything to write?
   if (len == 0) return SDL_TRUE;
   // Got an old block?
-  if (!writeblock(stillok, f)) return SDL_FALSE;
+  if (!writeblock(oric, stillok, f)) return SDL_FALSE;
 
   stillok  = (fwrite("DATA", 4, 1, f) == 1);
   stillok &= (fwrite(&lenbe, 4, 1, f) == 1);
   stillok &= (fwrite(data, len, 1, f) == 1);
 
-  offs = 0;
+  oric->snapoffs = 0;
   return stillok;
 }
 
@@ -152,18 +150,19 @@ SDL_bool save_snapshot(struct machine *oric, char *filename)
   int i, j;
   FILE *f = NULL;
 
-  buf = malloc(MAX_BLOCK);
-  if (!buf)
+  oric->snapbuf = malloc(MAX_BLOCK);
+  if (!oric->snapbuf)
   {
     msgbox(oric, MSGBOX_OK, "Snapshot failed: out of memory (1)\n");
     return SDL_FALSE;
   }
+  oric->snapoffs = 0;
 
   f = fopen(filename, "wb");
   if (!f)
   {
     msgbox(oric, MSGBOX_OK, "Unable to create snapshot file (2)");
-    free(buf);
+    free(oric->snapbuf);
     return SDL_FALSE;
   }
 
@@ -514,20 +513,42 @@ SDL_bool save_snapshot(struct machine *oric, char *filename)
   // Breakpoints
   if ((cpu->anybp) || (cpu->anymbp))
   {
+    // The first 16 go in the old format too
     NEWBLOCK("BKP\x00");
     for (i=0; i<16; i++)
-      PUTU32(cpu->breakpoints[i]);
+      PUTU32((i<cpu->numbps) ? cpu->bps[i].addr : -1);
     for (i=0; i<16; i++)
     {
-      PUTU8(cpu->membreakpoints[i].flags);
-      PUTU8(cpu->membreakpoints[i].lastval);
-      PUTU16(cpu->membreakpoints[i].addr);
+      PUTU8((i<cpu->nummbps) ? cpu->mbps[i].flags : 0);
+      PUTU8(0);
+      PUTU16((i<cpu->nummbps) ? cpu->mbps[i].addr : 0);
+    }
+
+    if (cpu->numbps > 0)
+    {
+      NEWBLOCK("BKX\x00");
+      for (i=0; i<cpu->numbps; i++)
+      {
+        PUTU16(cpu->bps[i].addr);
+        PUTU16(cpu->bps[i].bank);
+      }
+    }
+
+    if (cpu->nummbps > 0)
+    {
+      NEWBLOCK("BKM\x00");
+      for (i=0; i<cpu->nummbps; i++)
+      {
+        PUTU8(cpu->mbps[i].flags);
+        PUTU16(cpu->mbps[i].addr);
+        PUTU16(cpu->mbps[i].end);
+      }
     }
   }
 
   WRITEBLOCK();
   fclose(f);
-  free(buf);
+  free(oric->snapbuf);
 
   if (!ok)
     msgbox(oric, MSGBOX_OK, "Snapshot failed! (3)");
@@ -547,9 +568,6 @@ struct blockheader
   int                 offs;
 };
 
-int numhdrs = 0;
-static struct blockheader *bkh = NULL;
-
 static SDL_bool getheaders(struct machine *oric, FILE *f)
 {
   int i;
@@ -563,13 +581,13 @@ static SDL_bool getheaders(struct machine *oric, FILE *f)
   /* First, find all the blocks in the file */
   /* and make sure the file structure is sane. */
   offset = 0;
-  numhdrs = 0;
+  oric->snapnumhdrs = 0;
   while (offset < filesize)
   {
     if (fread(hdr, 8, 1, f) != 1)
     {
       msgbox(oric, MSGBOX_OK, "Snapshot load failed: Read error (4)");
-      numhdrs = 0;
+      oric->snapnumhdrs = 0;
       return SDL_FALSE;
     }
 
@@ -577,24 +595,24 @@ static SDL_bool getheaders(struct machine *oric, FILE *f)
     if ((size == 0) || ((offset+size) > filesize))
     {
       msgbox(oric, MSGBOX_OK, "Snapshot load failed: Invalid file structure (5)");
-      numhdrs = 0;
+      oric->snapnumhdrs = 0;
       return SDL_FALSE;
     }
 
-    numhdrs++;
+    oric->snapnumhdrs++;
     fseek(f, size, SEEK_CUR);
     offset += size+8;
   }
 
   /* Allocate memory to store all the block headers */
-  bkh = (struct blockheader *)malloc(numhdrs*sizeof(struct blockheader));
-  if (!bkh)
+  oric->snaphdrs = (struct blockheader *)malloc(oric->snapnumhdrs*sizeof(struct blockheader));
+  if (!oric->snaphdrs)
   {
     msgbox(oric, MSGBOX_OK, "Snapshot load failed: Out of memory (6)");
-    numhdrs = 0;
+    oric->snapnumhdrs = 0;
     return SDL_FALSE;
   }
-  memset(bkh, 0, numhdrs*sizeof(struct blockheader));
+  memset(oric->snaphdrs, 0, oric->snapnumhdrs*sizeof(struct blockheader));
 
   /* Now read in all the block headers */
   fseek(f, 0, SEEK_SET);
@@ -605,9 +623,9 @@ static SDL_bool getheaders(struct machine *oric, FILE *f)
     if (fread(hdr, 8, 1, f) != 1)
     {
       msgbox(oric, MSGBOX_OK, "Snapshot load failed: Read error (7)");
-      free(bkh);
-      bkh = NULL;
-      numhdrs = 0;
+      free(oric->snaphdrs);
+      oric->snaphdrs = NULL;
+      oric->snapnumhdrs = 0;
       return SDL_FALSE;
     }
 
@@ -615,21 +633,21 @@ static SDL_bool getheaders(struct machine *oric, FILE *f)
     if ((size == 0) || ((offset+size) > filesize))
     {
       msgbox(oric, MSGBOX_OK, "Snapshot load failed: Invalid file structure (8)");
-      free(bkh);
-      bkh = NULL;
-      numhdrs = 0;
+      free(oric->snaphdrs);
+      oric->snaphdrs = NULL;
+      oric->snapnumhdrs = 0;
       return SDL_FALSE;
     }
     offset+=8;
 
-    memcpy(bkh[i].id, hdr, 4);
-    bkh[i].offset = offset;
-    bkh[i].size   = size;
+    memcpy(oric->snaphdrs[i].id, hdr, 4);
+    oric->snaphdrs[i].offset = offset;
+    oric->snaphdrs[i].size   = size;
 
-    //printf("Block: %c%c%c%c (@ %d, size %d)\n", bkh[i].id[0], bkh[i].id[1], (bkh[i].id[2]>31)?bkh[i].id[2]:'.', (bkh[i].id[3]>31)?bkh[i].id[3]:'.', bkh[i].offset, bkh[i].size);
-    if ((i>0) && (memcmp(bkh[i].id, "DATA", 4)==0))
+    //printf("Block: %c%c%c%c (@ %d, size %d)\n", oric->snaphdrs[i].id[0], oric->snaphdrs[i].id[1], (oric->snaphdrs[i].id[2]>31)?oric->snaphdrs[i].id[2]:'.', (oric->snaphdrs[i].id[3]>31)?oric->snaphdrs[i].id[3]:'.', oric->snaphdrs[i].offset, oric->snaphdrs[i].size);
+    if ((i>0) && (memcmp(oric->snaphdrs[i].id, "DATA", 4)==0))
     {
-      bkh[i-1].datablock = &bkh[i];
+      oric->snaphdrs[i-1].datablock = &oric->snaphdrs[i];
     }
 
     fseek(f, size, SEEK_CUR);
@@ -647,72 +665,72 @@ static void free_block(struct blockheader *blk)
   blk->buf = NULL;
 }
 
-static void free_blockheaders(void)
+static void free_blockheaders(struct machine *oric)
 {
   int i;
 
-  if (!bkh) return;
+  if (!oric->snaphdrs) return;
 
-  for (i=0; i<numhdrs; i++)
+  for (i=0; i<oric->snapnumhdrs; i++)
   {
-    if (bkh[i].buf) free(bkh[i].buf);
+    if (oric->snaphdrs[i].buf) free(oric->snaphdrs[i].buf);
   }
-  free(bkh);
+  free(oric->snaphdrs);
 }
 
 static struct blockheader *load_block(struct machine *oric, char *id, FILE *f, SDL_bool required, int expectedsize, SDL_bool datarequired)
 {
   int i;
 
-  for (i=0; i<numhdrs; i++)
+  for (i=0; i<oric->snapnumhdrs; i++)
   {
-    if (memcmp(bkh[i].id, id, 4) == 0)
+    if (memcmp(oric->snaphdrs[i].id, id, 4) == 0)
       break;
   }
 
-  if (i==numhdrs)
+  if (i==oric->snapnumhdrs)
   {
     //printf("Unable to find %c%c%c%c\n", id[0], id[1], (id[2]>31)?id[2]:'.', (id[3]>31)?id[3]:'.');
     if (required) msgbox(oric, MSGBOX_OK, "Snapshot load failed: Invalid file (9)");
     return NULL;
   }
 
-  if ((datarequired) && (bkh[i].datablock == NULL))
+  if ((datarequired) && (oric->snaphdrs[i].datablock == NULL))
   {
     if (required) msgbox(oric, MSGBOX_OK, "Snapshot load failed: Invalid file (10)");
     return NULL;
   }
 
-  if ((expectedsize != -1) && (bkh[i].size != expectedsize))
+  if ((expectedsize != -1) && (oric->snaphdrs[i].size != expectedsize))
   {
-    //printf("Size for %c%c%c%c is %d, expected %d\n", id[0], id[1], (id[2]>31)?id[2]:'.', (id[3]>31)?id[3]:'.', bkh[i].size, expectedsize);
+    //printf("Size for %c%c%c%c is %d, expected %d\n", id[0], id[1], (id[2]>31)?id[2]:'.', (id[3]>31)?id[3]:'.', oric->snaphdrs[i].size, expectedsize);
     if (required) msgbox(oric, MSGBOX_OK, "Snapshot load failed: Invalid file (11)");
     return NULL;
   }
 
   /* Already loaded it?! */
-  if (bkh[i].buf)
+  if (oric->snaphdrs[i].buf)
   {
-    bkh[i].offs = 0;
-    return &bkh[i];
+    oric->snaphdrs[i].offs = 0;
+    return &oric->snaphdrs[i];
   }
 
-  bkh[i].buf = malloc(bkh[i].size);
-  if (!bkh[i].buf)
+  oric->snaphdrs[i].buf = malloc(oric->snaphdrs[i].size);
+  if (!oric->snaphdrs[i].buf)
   {
     if (required) msgbox(oric, MSGBOX_OK, "Snapshot load failed: Out of memory (12)");
     return NULL;
   }
 
-  fseek(f, bkh[i].offset, SEEK_SET);
-  if (fread(bkh[i].buf, bkh[i].size, 1, f) != 1)
+  fseek(f, oric->snaphdrs[i].offset, SEEK_SET);
+  if (fread(oric->snaphdrs[i].buf, oric->snaphdrs[i].size, 1, f) != 1)
   {
     if (required) msgbox(oric, MSGBOX_OK, "Snapshot load failed: Read error (13)");
     return NULL;
   }
 
-  bkh[i].offs = 0;
-  return &bkh[i];
+  oric->snaphdrs[i].offs = 0;
+  return &oric->snaphdrs[i];
 }
 
 static SDL_bool read_block(struct machine *oric, struct blockheader *blk, FILE *f, SDL_bool required, unsigned char *destbuf)
@@ -806,7 +824,7 @@ SDL_bool load_snapshot(struct machine *oric, char *filename)
   blk = load_block(oric, "OSN\x00", f, SDL_TRUE, 20, SDL_TRUE);
   if (!blk)
   {
-    free_blockheaders();
+    free_blockheaders(oric);
     fclose(f);
     return SDL_FALSE;
   }
@@ -818,7 +836,7 @@ SDL_bool load_snapshot(struct machine *oric, char *filename)
   if (type >= MACH_LAST)
   {
     msgbox(oric, MSGBOX_OK, "Snapshot load failed: Invalid file (17)");
-    free_blockheaders();
+    free_blockheaders(oric);
     fclose(f);
     return SDL_FALSE;
   }
@@ -830,7 +848,7 @@ SDL_bool load_snapshot(struct machine *oric, char *filename)
      (oric->memsize   != blk->datablock->size))    // Memsize incorrect for type
   {
     msgbox(oric, MSGBOX_OK, "Snapshot load failed: Invalid file (18)");
-    free_blockheaders();
+    free_blockheaders(oric);
     fclose(f);
     if (back2mon) setemumode(oric, NULL, EM_DEBUG);
     return SDL_FALSE;
@@ -839,7 +857,7 @@ SDL_bool load_snapshot(struct machine *oric, char *filename)
   /* Read in the memory */
   if (!read_block(oric, blk->datablock, f, SDL_TRUE, oric->mem))
   {
-    free_blockheaders();
+    free_blockheaders(oric);
     fclose(f);
     if (back2mon) setemumode(oric, NULL, EM_DEBUG);
     return SDL_FALSE;
@@ -878,12 +896,13 @@ SDL_bool load_snapshot(struct machine *oric, char *filename)
     oric->vid_addr = oric->vidbases[2];
     oric->vid_ch_base = &oric->mem[oric->vidbases[3]];
   }
+  ula_set_redraw( oric );
 
   /* Get the CPU block */
   blk = load_block(oric, "CPU\x00", f, SDL_TRUE, 21, SDL_FALSE);
   if (!blk)
   {
-    free_blockheaders();
+    free_blockheaders(oric);
     fclose(f);
     setmenutoggles( oric );
     if (back2mon) setemumode(oric, NULL, EM_DEBUG);
@@ -913,7 +932,7 @@ SDL_bool load_snapshot(struct machine *oric, char *filename)
   blk = load_block(oric, "AY\x00\x00", f, SDL_TRUE, 153, SDL_FALSE);
   if (!blk)
   {
-    free_blockheaders();
+    free_blockheaders(oric);
     fclose(f);
     setmenutoggles( oric );
     if (back2mon) setemumode(oric, NULL, EM_DEBUG);
@@ -961,7 +980,7 @@ SDL_bool load_snapshot(struct machine *oric, char *filename)
   blk = load_block(oric, "VIA\x00", f, SDL_TRUE, 39, SDL_FALSE);
   if (!blk)
   {
-    free_blockheaders();
+    free_blockheaders(oric);
     fclose(f);
     setmenutoggles( oric );
     if (back2mon) setemumode(oric, NULL, EM_DEBUG);
@@ -1009,7 +1028,7 @@ SDL_bool load_snapshot(struct machine *oric, char *filename)
   blk = load_block(oric, "TAP\x00", f, SDL_TRUE, 46, SDL_FALSE);
   if (!blk)
   {
-    free_blockheaders();
+    free_blockheaders(oric);
     fclose(f);
     setmenutoggles( oric );
     if (back2mon) setemumode(oric, NULL, EM_DEBUG);
@@ -1044,7 +1063,7 @@ SDL_bool load_snapshot(struct machine *oric, char *filename)
     if (!oric->tapebuf)
     {
       msgbox(oric, MSGBOX_OK, "Snapshot load failed: Out of memory (19)");
-      free_blockheaders();
+      free_blockheaders(oric);
       fclose(f);
       setmenutoggles( oric );
       if (back2mon) setemumode(oric, NULL, EM_DEBUG);
@@ -1053,7 +1072,7 @@ SDL_bool load_snapshot(struct machine *oric, char *filename)
 
     if (!read_block(oric, blk->datablock, f, SDL_TRUE, oric->tapebuf))
     {
-      free_blockheaders();
+      free_blockheaders(oric);
       fclose(f);
       setmenutoggles( oric );
       if (back2mon) setemumode(oric, NULL, EM_DEBUG);
@@ -1101,7 +1120,7 @@ SDL_bool load_snapshot(struct machine *oric, char *filename)
       blk = load_block(oric, "JSM\x00", f, SDL_TRUE, 2, SDL_FALSE);
       if (!blk)
       {
-        free_blockheaders();
+        free_blockheaders(oric);
         fclose(f);
         setmenutoggles( oric );
         if (back2mon) setemumode(oric, NULL, EM_DEBUG);
@@ -1122,7 +1141,7 @@ SDL_bool load_snapshot(struct machine *oric, char *filename)
       blk = load_block(oric, "MDC\x00", f, SDL_TRUE, 4, SDL_FALSE);
       if (!blk)
       {
-        free_blockheaders();
+        free_blockheaders(oric);
         fclose(f);
         setmenutoggles( oric );
         if (back2mon) setemumode(oric, NULL, EM_DEBUG);
@@ -1149,7 +1168,7 @@ SDL_bool load_snapshot(struct machine *oric, char *filename)
       blk = load_block(oric, "PRV\x00", f, SDL_TRUE, 9+2*10, SDL_TRUE);
       if (!blk)
       {
-        free_blockheaders();
+        free_blockheaders(oric);
         fclose(f);
         setmenutoggles( oric );
         if (back2mon) setemumode(oric, NULL, EM_DEBUG);
@@ -1176,7 +1195,7 @@ SDL_bool load_snapshot(struct machine *oric, char *filename)
 
       if (!read_block(oric, blk->datablock, f, SDL_TRUE, tmp))
       {
-        free_blockheaders();
+        free_blockheaders(oric);
         fclose(f);
         setmenutoggles( oric );
         if (back2mon) setemumode(oric, NULL, EM_DEBUG);
@@ -1196,7 +1215,7 @@ SDL_bool load_snapshot(struct machine *oric, char *filename)
         if ((i<0) || (i>1) || (oric->wddisk.disk[i] != NULL) || (!blk->datablock) || (blk->size != 10))
         {
           msgbox(oric, MSGBOX_OK, "Snapshot load failed: Invalid file (PVD1)");
-          free_blockheaders();
+          free_blockheaders(oric);
           fclose(f);
           setmenutoggles( oric );
           if (back2mon) setemumode(oric, NULL, EM_DEBUG);
@@ -1208,7 +1227,7 @@ SDL_bool load_snapshot(struct machine *oric, char *filename)
         if (!oric->wddisk.disk[i])
         {
           msgbox(oric, MSGBOX_OK, "Snapshot load failed: Out of memory (PVD2)");
-          free_blockheaders();
+          free_blockheaders(oric);
           fclose(f);
           setmenutoggles( oric );
           if (back2mon) setemumode(oric, NULL, EM_DEBUG);
@@ -1223,7 +1242,7 @@ SDL_bool load_snapshot(struct machine *oric, char *filename)
           free(oric->wddisk.disk[i]);
           oric->wddisk.disk[i] = NULL;
           msgbox(oric, MSGBOX_OK, "Snapshot load failed: Out of memory (PVD3)");
-          free_blockheaders();
+          free_blockheaders(oric);
           fclose(f);
           setmenutoggles( oric );
           if (back2mon) setemumode(oric, NULL, EM_DEBUG);
@@ -1236,7 +1255,7 @@ SDL_bool load_snapshot(struct machine *oric, char *filename)
           free(oric->wddisk.disk[i]->rawimage);
           free(oric->wddisk.disk[i]);
           oric->wddisk.disk[i] = NULL;
-          free_blockheaders();
+          free_blockheaders(oric);
           fclose(f);
           setmenutoggles( oric );
           if (back2mon) setemumode(oric, NULL, EM_DEBUG);
@@ -1273,7 +1292,7 @@ SDL_bool load_snapshot(struct machine *oric, char *filename)
     blk = load_block(oric, "WDD\x00", f, SDL_TRUE, 38, SDL_FALSE);
     if (!blk)
     {
-      free_blockheaders();
+      free_blockheaders(oric);
       fclose(f);
       setmenutoggles( oric );
       if (back2mon) setemumode(oric, NULL, EM_DEBUG);
@@ -1312,7 +1331,7 @@ SDL_bool load_snapshot(struct machine *oric, char *filename)
       if ((i<0) || (i>3) || (oric->wddisk.disk[i] != NULL) || (!blk->datablock) || (blk->size != 16))
       {
         msgbox(oric, MSGBOX_OK, "Snapshot load failed: Invalid file (20)");
-        free_blockheaders();
+        free_blockheaders(oric);
         fclose(f);
         setmenutoggles( oric );
         if (back2mon) setemumode(oric, NULL, EM_DEBUG);
@@ -1324,7 +1343,7 @@ SDL_bool load_snapshot(struct machine *oric, char *filename)
       if (!oric->wddisk.disk[i])
       {
         msgbox(oric, MSGBOX_OK, "Snapshot load failed: Out of memory (21)");
-        free_blockheaders();
+        free_blockheaders(oric);
         fclose(f);
         setmenutoggles( oric );
         if (back2mon) setemumode(oric, NULL, EM_DEBUG);
@@ -1339,7 +1358,7 @@ SDL_bool load_snapshot(struct machine *oric, char *filename)
         free(oric->wddisk.disk[i]);
         oric->wddisk.disk[i] = NULL;
         msgbox(oric, MSGBOX_OK, "Snapshot load failed: Out of memory (22)");
-        free_blockheaders();
+        free_blockheaders(oric);
         fclose(f);
         setmenutoggles( oric );
         if (back2mon) setemumode(oric, NULL, EM_DEBUG);
@@ -1352,7 +1371,7 @@ SDL_bool load_snapshot(struct machine *oric, char *filename)
         free(oric->wddisk.disk[i]->rawimage);
         free(oric->wddisk.disk[i]);
         oric->wddisk.disk[i] = NULL;
-        free_blockheaders();
+        free_blockheaders(oric);
         fclose(f);
         setmenutoggles( oric );
         if (back2mon) setemumode(oric, NULL, EM_DEBUG);
@@ -1390,7 +1409,7 @@ SDL_bool load_snapshot(struct machine *oric, char *filename)
     blk = load_block(oric, "BNK\x00", f, SDL_TRUE, 9, SDL_FALSE);
     if (!blk)
     {
-      free_blockheaders();
+      free_blockheaders(oric);
       fclose(f);
       setmenutoggles( oric );
       if (back2mon) setemumode(oric, NULL, EM_DEBUG);
@@ -1408,7 +1427,7 @@ SDL_bool load_snapshot(struct machine *oric, char *filename)
     blk = load_block(oric, "ACI\x00", f, SDL_TRUE, ACIA_LAST, SDL_FALSE);
     if (!blk)
     {
-      free_blockheaders();
+      free_blockheaders(oric);
       fclose(f);
       setmenutoggles( oric );
       if (back2mon) setemumode(oric, NULL, EM_DEBUG);
@@ -1424,7 +1443,7 @@ SDL_bool load_snapshot(struct machine *oric, char *filename)
     blk = load_block(oric, "AUX\x00", f, SDL_TRUE, ACIA_LAST, SDL_FALSE);
     if (!blk)
     {
-      free_blockheaders();
+      free_blockheaders(oric);
       fclose(f);
       setmenutoggles( oric );
       if (back2mon) setemumode(oric, NULL, EM_DEBUG);
@@ -1438,7 +1457,7 @@ SDL_bool load_snapshot(struct machine *oric, char *filename)
     blk = load_block(oric, "TVA\x00", f, SDL_TRUE, 39, SDL_FALSE);
     if (!blk)
     {
-      free_blockheaders();
+      free_blockheaders(oric);
       fclose(f);
       setmenutoggles( oric );
       if (back2mon) setemumode(oric, NULL, EM_DEBUG);
@@ -1514,28 +1533,55 @@ SDL_bool load_snapshot(struct machine *oric, char *filename)
   /* ... and finally, breakpoints! */
   if ((blk = load_block(oric, "BKP\x00", f, SDL_FALSE, -1, SDL_FALSE)))
   {
-    cpu->anybp = SDL_FALSE;
-    cpu->anymbp = SDL_FALSE;
+    m6502_clearbps(cpu);
+    m6502_clearmbps(cpu);
 
     for (i=0; i<16; i++)
     {
-      cpu->breakpoints[i] = gets32(blk);
-      if (cpu->breakpoints[i] != -1) cpu->anybp = SDL_TRUE;
+      Sint32 addr = gets32(blk);
+      if (addr != -1) m6502_addbp(cpu, addr&0xffff, BPBANK_ANY);
     }
 
     for (i=0; i<16; i++)
     {
-      cpu->membreakpoints[i].flags   = getu8(blk);
-      cpu->membreakpoints[i].lastval = getu8(blk);
-      cpu->membreakpoints[i].addr    = getu16(blk);
-      if (cpu->membreakpoints[i].flags) cpu->anymbp = SDL_TRUE;
+      Uint8 flags = getu8(blk);
+      Uint16 addr;
+      blk->offs++; // Skip lastval
+      addr = getu16(blk);
+      if (flags) m6502_addmbp(cpu, addr, addr, flags);
     }
 
     free_block(blk);
+
+    /* The full list, if there is one, replaces the first 16 */
+    if ((blk = load_block(oric, "BKX\x00", f, SDL_FALSE, -1, SDL_FALSE)))
+    {
+      m6502_clearbps(cpu);
+      for (i=0; i<blk->size/4; i++)
+      {
+        Uint16 addr = getu16(blk);
+        m6502_addbp(cpu, addr, gets16(blk));
+      }
+      free_block(blk);
+    }
+
+    if ((blk = load_block(oric, "BKM\x00", f, SDL_FALSE, -1, SDL_FALSE)))
+    {
+      m6502_clearmbps(cpu);
+      for (i=0; i<blk->size/5; i++)
+      {
+        Uint8 flags = getu8(blk);
+        Uint16 addr = getu16(blk);
+        m6502_addmbp(cpu, addr, getu16(blk), flags);
+      }
+      free_block(blk);
+    }
   }
 
-  free_blockheaders();
+  free_blockheaders(oric);
   fclose(f);
+  setmemmap( oric );
+  sethookmap( oric );
   setmenutoggles( oric );
   if (back2mon) setemumode(oric, NULL, EM_DEBUG);
   return SDL_TRUE;
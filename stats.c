@@ -0,0 +1,202 @@
+/*
+**  Oricutron
+**  Copyright (C) 2009-2014 Peter Gordon
+**
+**  This program is free software; you can redistribute it and/or
+**  modify it under the terms of the GNU General Public License
+**  as published by the Free Software Foundation, version 2
+**  of the License.
+**
+**  This program is distributed in the hope that it will be useful,
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**  GNU General Public License for more details.
+**
+**  You should have received a copy of the GNU General Public License
+**  along with this program; if not, write to the Free Software
+**  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+**
+**  Hot path counters and timers
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "system.h"
+#include "6502.h"
+#include "via.h"
+#include "8912.h"
+#include "gui.h"
+#include "disk.h"
+#include "monitor.h"
+#include "6551.h"
+#include "machine.h"
+
+static char *countnames[] = { "insts", "via_clocks", "wd_cmds", "tape_edges" };
+static char *timenames[]  = { "emu_us", "ula_us", "audio_us", "render_us", "present_us", "frame_us" };
+
+char *stats_name( int which, SDL_bool istime )
+{
+  if( istime )
+    return ( ( which >= 0 ) && ( which < STAT_NUMTIMES ) ) ? timenames[which] : "?";
+  return ( ( which >= 0 ) && ( which < STAT_NUMCOUNTS ) ) ? countnames[which] : "?";
+}
+
+// Move the audio thread's time into the totals
+static void stats_syncaudio( struct perfstats *st )
+{
+  SDL_LockAudio();
+  st->us[STIME_AUDIO] += st->audious;
+  st->audious = 0;
+  SDL_UnlockAudio();
+}
+
+// Start counting the frames from here
+void stats_reset( struct machine *oric )
+{
+  struct perfstats *st = &oric->stats;
+  int i;
+
+  stats_syncaudio( st );
+  for( i=0; i<STAT_NUMCOUNTS; i++ )
+  {
+    st->basecount[i] = st->markcount[i] = st->logcount[i] = st->count[i];
+    st->lastcount[i] = 0;
+  }
+  for( i=0; i<STAT_NUMTIMES; i++ )
+  {
+    st->baseus[i] = st->markus[i] = st->logus[i] = st->us[i];
+    st->lastus[i] = 0;
+  }
+
+  st->insts     = oric->cpu.insts;
+  st->frameus   = SDL_COMPAT_GetTicksUS();
+  st->frames    = 0;
+  st->logframes = 0;
+
+  pace_clearstats( &oric->pace );
+}
+
+void stats_enable( struct machine *oric, SDL_bool on )
+{
+  if( ( on ) && ( !oric->stats.on ) )
+    stats_reset( oric );
+  oric->stats.on = on;
+}
+
+Uint64 stats_start( struct perfstats *st )
+{
+  return st->on ? SDL_COMPAT_GetTicksUS() : 0;
+}
+
+void stats_stop( struct perfstats *st, int which, Uint64 start )
+{
+  if( ( st->on ) && ( start ) )
+    st->us[which] += SDL_COMPAT_GetTicksUS() - start;
+}
+
+// For ay_callback, which SDL calls with the audio lock held
+void stats_stopaudio( struct perfstats *st, Uint64 start )
+{
+  if( ( st->on ) && ( start ) )
+    st->audious += (Uint32)( SDL_COMPAT_GetTicksUS() - start );
+}
+
+static void stats_logrow( struct machine *oric )
+{
+  struct perfstats *st = &oric->stats;
+  int i;
+
+  fprintf( st->log, "%u,%d", st->frames, st->logframes );
+  for( i=0; i<STAT_NUMCOUNTS; i++ )
+  {
+    fprintf( st->log, ",%llu", (unsigned long long)( st->count[i] - st->logcount[i] ) );
+    st->logcount[i] = st->count[i];
+  }
+  for( i=0; i<STAT_NUMTIMES; i++ )
+  {
+    fprintf( st->log, ",%llu", (unsigned long long)( st->us[i] - st->logus[i] ) );
+    st->logus[i] = st->us[i];
+  }
+  fprintf( st->log, "\n" );
+  fflush( st->log );
+  st->logframes = 0;
+}
+
+// Called once per emulated frame, after it has been rendered
+void stats_endframe( struct machine *oric )
+{
+  struct perfstats *st = &oric->stats;
+  Uint64 now;
+  int i;
+
+  if( !st->on ) return;
+
+  stats_syncaudio( st );
+
+  now = SDL_COMPAT_GetTicksUS();
+  st->us[STIME_FRAME] += now - st->frameus;
+  st->frameus = now;
+
+  st->count[STAT_INSTS] += (Uint32)( oric->cpu.insts - st->insts );
+  st->insts = oric->cpu.insts;
+
+  for( i=0; i<STAT_NUMCOUNTS; i++ )
+  {
+    st->lastcount[i] = (Uint32)( st->count[i] - st->markcount[i] );
+    st->markcount[i] = st->count[i];
+  }
+  for( i=0; i<STAT_NUMTIMES; i++ )
+  {
+    st->lastus[i] = (Uint32)( st->us[i] - st->markus[i] );
+    st->markus[i] = st->us[i];
+  }
+  st->frames++;
+
+  if( st->log )
+  {
+    st->logframes++;
+    if( st->logframes >= st->logevery )
+      stats_logrow( oric );
+  }
+}
+
+// Write the totals for every "every" frames to a CSV file. Turns the stats on.
+SDL_bool stats_startlog( struct machine *oric, char *fname, int every )
+{
+  struct perfstats *st = &oric->stats;
+  int i;
+
+  stats_stoplog( oric );
+
+  st->log = fopen( fname, "w" );
+  if( !st->log ) return SDL_FALSE;
+
+  fprintf( st->log, "frame,frames" );
+  for( i=0; i<STAT_NUMCOUNTS; i++ )
+    fprintf( st->log, ",%s", countnames[i] );
+  for( i=0; i<STAT_NUMTIMES; i++ )
+    fprintf( st->log, ",%s", timenames[i] );
+  fprintf( st->log, "\n" );
+
+  st->logevery = ( every > 0 ) ? every : 1;
+  stats_enable( oric, SDL_TRUE );
+  stats_reset( oric );
+  return SDL_TRUE;
+}
+
+void stats_stoplog( struct machine *oric )
+{
+  struct perfstats *st = &oric->stats;
+
+  if( !st->log ) return;
+
+  if( st->logframes )
+  {
+    stats_syncaudio( st );
+    stats_logrow( oric );
+  }
+  fclose( st->log );
+  st->log = NULL;
+}
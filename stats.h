@@ -0,0 +1,93 @@
+/*
+**  Oricutron
+**  Copyright (C) 2009-2014 Peter Gordon
+**
+**  This program is free software; you can redistribute it and/or
+**  modify it under the terms of the GNU General Public License
+**  as published by the Free Software Foundation, version 2
+**  of the License.
+**
+**  This program is distributed in the hope that it will be useful,
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**  GNU General Public License for more details.
+**
+**  You should have received a copy of the GNU General Public License
+**  along with this program; if not, write to the Free Software
+**  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+**
+**  Hot path counters and timers
+*/
+#ifndef STATS_H
+#define STATS_H
+
+#include <stdio.h>
+
+// Things that are counted. These are always on, since
+// an increment costs about the same as checking a flag.
+enum
+{
+  STAT_INSTS = 0,    // 6502 instructions executed
+  STAT_VIACLOCKS,    // via_clock calls (both VIAs)
+  STAT_WDCMDS,       // WD17xx commands
+  STAT_TAPEEDGES,    // Changes of the tape signal on CB1
+  STAT_NUMCOUNTS
+};
+
+// Things that are timed, in microseconds. These cost two
+// timer reads each, so only happen while stats are on.
+enum
+{
+  STIME_EMU = 0,     // Running the frame (CPU, devices and ULA)
+  STIME_ULA,         // ula_doraster
+  STIME_AUDIO,       // ay_callback (on the audio thread)
+  STIME_RENDER,      // render, including the present
+  STIME_PRESENT,     // Flip or swap buffers
+  STIME_FRAME,       // Wall time from one frame to the next
+  STAT_NUMTIMES
+};
+
+struct perfstats
+{
+  SDL_bool on;
+
+  // Running totals, so the frame figures are worked out as differences
+  Uint64   count[STAT_NUMCOUNTS];
+  Uint64   us[STAT_NUMTIMES];
+
+  // ay_callback time not yet added to us[STIME_AUDIO]. Only
+  // touched with the audio lock held.
+  Uint32   audious;
+
+  // Totals at the last reset, for the averages
+  Uint64   basecount[STAT_NUMCOUNTS];
+  Uint64   baseus[STAT_NUMTIMES];
+
+  // Totals at the end of the last frame, and that frame's figures
+  Uint64   markcount[STAT_NUMCOUNTS];
+  Uint64   markus[STAT_NUMTIMES];
+  Uint32   lastcount[STAT_NUMCOUNTS];
+  Uint32   lastus[STAT_NUMTIMES];
+
+  Uint32   insts;        // cpu.insts at the last frame end
+  Uint64   frameus;      // Timer at the last frame end
+  Uint32   frames;       // Frames since reset
+
+  // CSV log, a row every logevery frames
+  FILE    *log;
+  int      logevery, logframes;
+  Uint64   logcount[STAT_NUMCOUNTS];
+  Uint64   logus[STAT_NUMTIMES];
+};
+
+void stats_reset( struct machine *oric );
+void stats_enable( struct machine *oric, SDL_bool on );
+Uint64 stats_start( struct perfstats *st );
+void stats_stop( struct perfstats *st, int which, Uint64 start );
+void stats_stopaudio( struct perfstats *st, Uint64 start );
+void stats_endframe( struct machine *oric );
+SDL_bool stats_startlog( struct machine *oric, char *fname, int every );
+void stats_stoplog( struct machine *oric );
+char *stats_name( int which, SDL_bool istime );
+
+#endif
@@ -42,6 +42,12 @@
 #endif
 #endif
 
+#if SDL_MAJOR_VERSION == 1
+#if defined(__linux__) || defined(__APPLE__)
+#include <time.h>
+#endif
+#endif
+
 #ifdef __OPENGL_AVAILABLE__
 #ifndef __APPLE__
 #include <GL/gl.h>
@@ -280,6 +286,25 @@ int SDL_COMPAT_GetBitsPerPixel(void)
 }
 #endif
 
+#if SDL_MAJOR_VERSION == 1
+/* Only the desktop size until the first SDL_SetVideoMode */
+void SDL_COMPAT_GetDesktopSize(int *width, int *height)
+{
+  const SDL_VideoInfo* info = SDL_GetVideoInfo();
+  *width  = (info)? info->current_w : 0;
+  *height = (info)? info->current_h : 0;
+}
+#else
+void SDL_COMPAT_GetDesktopSize(int *width, int *height)
+{
+  SDL_DisplayMode mode;
+  if(SDL_GetDesktopDisplayMode(0, &mode) != 0)
+    mode.w = mode.h = 0;
+  *width  = mode.w;
+  *height = mode.h;
+}
+#endif
+
 #if SDL_MAJOR_VERSION == 1
 int SDL_COMPAT_WM_ToggleFullScreen(SDL_Surface *surface)
 {
@@ -379,6 +404,58 @@ void SDL_COMPAT_Quit(void)
 }
 #endif
 
+#if SDL_MAJOR_VERSION == 1
+SDL_Thread* SDL_COMPAT_CreateThread(int (*fn)(void *), const char *name, void *data)
+{
+  return SDL_CreateThread(fn, data);
+}
+#else
+SDL_Thread* SDL_COMPAT_CreateThread(int (*fn)(void *), const char *name, void *data)
+{
+  return SDL_CreateThread(fn, name, data);
+}
+#endif
+
+#if SDL_MAJOR_VERSION == 1
+int SDL_COMPAT_GetCPUCount(void)
+{
+  return 1; /* SDL 1.2 can't tell */
+}
+#else
+int SDL_COMPAT_GetCPUCount(void)
+{
+  return SDL_GetCPUCount();
+}
+#endif
+
+#if SDL_MAJOR_VERSION == 1
+#if defined(__linux__) || defined(__APPLE__)
+Uint64 SDL_COMPAT_GetTicksUS(void)
+{
+  struct timespec ts;
+
+  /* SDL 1.2 has no high resolution timer, so go to the OS for one */
+  if( clock_gettime( CLOCK_MONOTONIC, &ts ) != 0 )
+    return ((Uint64)SDL_GetTicks())*1000;
+  return ((Uint64)ts.tv_sec)*1000000 + ts.tv_nsec/1000;
+}
+#else
+Uint64 SDL_COMPAT_GetTicksUS(void)
+{
+  return ((Uint64)SDL_GetTicks())*1000; /* Only millisecond resolution */
+}
+#endif
+#else
+Uint64 SDL_COMPAT_GetTicksUS(void)
+{
+  Uint64 count = SDL_GetPerformanceCounter();
+  Uint64 freq = SDL_GetPerformanceFrequency();
+
+  /* Split up so the multiply can't overflow */
+  return (count/freq)*1000000 + ((count%freq)*1000000)/freq;
+}
+#endif
+
 #ifdef __OPENGL_AVAILABLE__
 #if SDL_MAJOR_VERSION == 1
 void SDL_COMPAT_GL_SwapBuffers(void)
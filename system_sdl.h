@@ -139,11 +139,15 @@ int SDL_COMPAT_EnableUNICODE(int enable);
 SDL_COMPAT_KEY SDL_COMPAT_GetKeysymUnicode(SDL_KEYSYM keysym);
 int SDL_COMPAT_Flip(SDL_Surface* screen);
 int SDL_COMPAT_GetBitsPerPixel(void);
+void SDL_COMPAT_GetDesktopSize(int *width, int *height);
 int SDL_COMPAT_WM_ToggleFullScreen(SDL_Surface *surface);
 SDL_Surface* SDL_COMPAT_SetVideoMode(int width, int height, int bitsperpixel, Uint32 flags);
 int SDL_COMPAT_SetPalette(SDL_Surface *surface, int flags, SDL_Color *colors, int firstcolor, int ncolors);
 void SDL_COMPAT_SetEventFilter(SDL_EventFilter filter);
 void SDL_COMPAT_Quit(void);
+SDL_Thread* SDL_COMPAT_CreateThread(int (*fn)(void *), const char *name, void *data);
+int SDL_COMPAT_GetCPUCount(void);
+Uint64 SDL_COMPAT_GetTicksUS(void);
 
 #ifdef __OPENGL_AVAILABLE__
 void SDL_COMPAT_GL_SwapBuffers(void);
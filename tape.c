@@ -37,9 +37,7 @@
 #include "tape.h"
 #include "msgbox.h"
 
-extern char tapefile[], tapepath[];
-extern SDL_bool refreshtape;
-char tmptapename[4096];
+extern char tapepath[];
 extern char filetmp[];
 
 // Pop-up the name of the currently inserted tape
@@ -70,29 +68,29 @@ void toggletapecap( struct machine *oric, struct osdmenuitem *mitem, int dummy )
     fclose( oric->tapecap );
     oric->tapecap = NULL;
     mitem->name = "Save tape output...";
-    refreshtape = SDL_TRUE;
+    oric->refreshtape = SDL_TRUE;
     return;
   }
 
   /* Otherwise, prompt for the file to capture */
-  if( !filerequester( oric, "Capture tape output", tapepath, tmptapename, FR_TAPESAVEORT ) )
+  if( !filerequester( oric, "Capture tape output", tapepath, oric->tmptapename, FR_TAPESAVEORT ) )
   {
     // Never mind
     return;
   }
-  if( tmptapename[0] == 0 ) return;
+  if( oric->tmptapename[0] == 0 ) return;
 
   /* If it ends in ".tap", we need to change it to ".ort", because
      we're capturing real signals here folks! */
-  if( (strlen(tmptapename)>3) && (strcasecmp(&tmptapename[strlen(tmptapename)-4], ".tap")==0) )
-    tmptapename[strlen(tmptapename)-4] = 0;
+  if( (strlen(oric->tmptapename)>3) && (strcasecmp(&oric->tmptapename[strlen(oric->tmptapename)-4], ".tap")==0) )
+    oric->tmptapename[strlen(oric->tmptapename)-4] = 0;
 
   /* Add .ort extension, if necessary */
-  if( (strlen(tmptapename)<4) || (strcasecmp(&tmptapename[strlen(tmptapename)-4], ".ort")!=0) )
-    strncat(tmptapename, ".ort", 4096);
-  tmptapename[4095] = 0;
+  if( (strlen(oric->tmptapename)<4) || (strcasecmp(&oric->tmptapename[strlen(oric->tmptapename)-4], ".ort")!=0) )
+    strncat(oric->tmptapename, ".ort", 4096);
+  oric->tmptapename[4095] = 0;
 
-  joinpath( tapepath, tmptapename );
+  joinpath( tapepath, oric->tmptapename );
 
   /* Open the file */
   oric->tapecap = fopen( filetmp, "wb" );
@@ -112,7 +110,7 @@ void toggletapecap( struct machine *oric, struct osdmenuitem *mitem, int dummy )
 
   /* Update menu */
   mitem->name = "Stop tape recording";
-  refreshtape = SDL_TRUE;
+  oric->refreshtape = SDL_TRUE;
 }
 
 /* When we're loading a .tap file (or a non-raw section of a .ort file),
@@ -225,7 +223,7 @@ void tape_setmotor( struct machine *oric, SDL_bool motoron )
     return;
 
   // Refresh the tape status icon in the status bar
-  refreshtape = SDL_TRUE;
+  oric->refreshtape = SDL_TRUE;
 
   // "Real" tape emulation?
   if( ( !oric->tapeturbo ) || ( !oric->pch_tt_available ) )
@@ -268,7 +266,7 @@ void tape_eject( struct machine *oric )
   oric->tapelen = 0;
   oric->tapename[0] = 0;
   tape_popup( oric );
-  refreshtape = SDL_TRUE;
+  oric->refreshtape = SDL_TRUE;
 }
 
 void tape_next_raw_count( struct machine *oric )
@@ -369,7 +367,7 @@ void tape_rewind( struct machine *oric )
   }
   oric->tapehitend = 0;
   oric->tapedelay = 0;
-  refreshtape = SDL_TRUE;
+  oric->refreshtape = SDL_TRUE;
 }
 
 // This is used by the "tapsections" function. It returns the next time
@@ -975,47 +973,9 @@ SDL_bool wav_convert( struct machine *oric )
   return SDL_TRUE;
 }
 
-// Insert a new tape image
-SDL_bool tape_load_tap( struct machine *oric, char *fname )
+// Work out what sort of image is in tapebuf, and get it ready to play
+static SDL_bool tape_insert( struct machine *oric, char *fname )
 {
-  FILE *f;
-
-  // First make sure the image file exists
-  f = fopen( fname, "rb" );
-  if( !f ) return SDL_FALSE;
-
-  // Eject any old image
-  tape_eject( oric );
-
-  // Get the image size
-  fseek( f, 0, SEEK_END );
-  oric->tapelen = (int)ftell( f );
-  fseek( f, 0, SEEK_SET );
-
-  if( oric->tapelen <= 4 )   // Even worth loading it?
-  {
-    fclose( f );
-    return SDL_FALSE;
-  }
-
-  // Allocate memory for the tape image and read it in
-  oric->tapebuf = malloc( oric->tapelen+1 );
-  if( !oric->tapebuf )
-  {
-    fclose( f );
-    oric->tapelen = 0;
-    return SDL_FALSE;
-  }
-
-  if( fread( &oric->tapebuf[0], oric->tapelen, 1, f ) != 1 )
-  {
-    fclose( f );
-    tape_eject( oric );
-    return SDL_FALSE;
-  }
-
-  fclose( f );
-
   // WAV
   if ((oric->tapelen >= 36) &&
       (memcmp(oric->tapebuf,   "RIFF", 4) == 0) &&
@@ -1071,9 +1031,71 @@ SDL_bool tape_load_tap( struct machine *oric, char *fname )
   return SDL_TRUE;
 }
 
+// Insert a new tape image
+SDL_bool tape_load_tap( struct machine *oric, char *fname )
+{
+  FILE *f;
+
+  // First make sure the image file exists
+  f = fopen( fname, "rb" );
+  if( !f ) return SDL_FALSE;
+
+  // Eject any old image
+  tape_eject( oric );
+
+  // Get the image size
+  fseek( f, 0, SEEK_END );
+  oric->tapelen = (int)ftell( f );
+  fseek( f, 0, SEEK_SET );
+
+  if( oric->tapelen <= 4 )   // Even worth loading it?
+  {
+    fclose( f );
+    return SDL_FALSE;
+  }
+
+  // Allocate memory for the tape image and read it in
+  oric->tapebuf = malloc( oric->tapelen+1 );
+  if( !oric->tapebuf )
+  {
+    fclose( f );
+    oric->tapelen = 0;
+    return SDL_FALSE;
+  }
+
+  if( fread( &oric->tapebuf[0], oric->tapelen, 1, f ) != 1 )
+  {
+    fclose( f );
+    tape_eject( oric );
+    return SDL_FALSE;
+  }
+
+  fclose( f );
+
+  return tape_insert( oric, fname );
+}
+
+// Insert a tape image that is already in memory
+SDL_bool tape_load_buffer( struct machine *oric, Uint8 *buf, int len, char *name )
+{
+  tape_eject( oric );
+
+  if( len <= 4 ) return SDL_FALSE;
+
+  oric->tapebuf = malloc( len+1 );
+  if( !oric->tapebuf ) return SDL_FALSE;
+
+  memcpy( oric->tapebuf, buf, len );
+  oric->tapelen = len;
+
+  return tape_insert( oric, name );
+}
+
 void tape_autoinsert( struct machine *oric )
 {
-  char *odir;
+  // The path is built here rather than with a chdir, since
+  // other machines may be running in other threads
+  char fname[4096+512];
   int i;
   SDL_bool tape_found;
 
@@ -1081,23 +1103,21 @@ void tape_autoinsert( struct machine *oric )
     oric->mem[oric->pch_fd_getname_addr] = 0;
 
   // Try and load the tape image
-  strcpy( tapefile, oric->lasttapefile );
-  i = (int)strlen(tapefile);
+  joinpathto( fname, tapepath, oric->lasttapefile );
+  i = (int)strlen(fname);
 
-  odir = getcwd( NULL, 0 );
-  chdir( tapepath );
-  tape_found = tape_load_tap( oric, tapefile );
-  if( !tape_found )
+  tape_found = tape_load_tap( oric, fname );
+  if( ( !tape_found ) && ( i < sizeof( fname )-5 ) )
   {
     // Try appending .tap
-    strcpy( &tapefile[i], ".tap" );
-    tape_found = tape_load_tap( oric, tapefile );
+    strcpy( &fname[i], ".tap" );
+    tape_found = tape_load_tap( oric, fname );
   }
-  if( !tape_found )
+  if( ( !tape_found ) && ( i < sizeof( fname )-5 ) )
   {
     // Try appending .ort
-    strcpy( &tapefile[i], ".ort" );
-    tape_load_tap( oric, tapefile );
+    strcpy( &fname[i], ".ort" );
+    tape_load_tap( oric, fname );
   }
   
   if( oric->tapebuf )
@@ -1105,9 +1125,6 @@ void tape_autoinsert( struct machine *oric )
     // We already inserted this one. Don't re-insert it when we get to the end. */
     oric->lasttapefile[0] = 0;
   }
-    
-  chdir( odir );
-  free( odir );
 }
 
 void tape_stop_savepatch( struct machine *oric )
@@ -1194,42 +1211,39 @@ void tape_patches( struct machine *oric )
         }
         else
         {
-          char *odir = NULL;
+          char fname[4096+512];
 
           // Read in the filename from RAM
           for( i=0; i<16; i++ )
           {
             j = oric->cpu.read( &oric->cpu, oric->pch_fd_getname_addr+i );
             if( !j ) break;
-            tmptapename[i] = j;
+            oric->tmptapename[i] = j;
           }
-          tmptapename[i] = 0;
+          oric->tmptapename[i] = 0;
 
-          // If no name, prompt for one
-          if( tmptapename[0] == 0 ) 
+          // If no name, prompt for one (unless there is nobody to ask)
+          if( oric->tmptapename[0] == 0 ) 
           {
-            if( !filerequester( oric, "Save to tape", tapepath, tmptapename, FR_TAPESAVETAP ) )
-              tmptapename[0] = 0;
+            if( ( oric->headless ) || ( !filerequester( oric, "Save to tape", tapepath, oric->tmptapename, FR_TAPESAVETAP ) ) )
+              oric->tmptapename[0] = 0;
           }
 
           // If there is one, append .TAP
-          if( tmptapename[0] )
+          if( oric->tmptapename[0] )
           {
-            if( (strlen(tmptapename) < 4) || (strcasecmp(&tmptapename[strlen(tmptapename)-4], ".tap") != 0) )
+            if( (strlen(oric->tmptapename) < 4) || (strcasecmp(&oric->tmptapename[strlen(oric->tmptapename)-4], ".tap") != 0) )
             {
-              if (strlen(tmptapename)+5<sizeof(tmptapename)) // if we have enough space to add the .tap
-                  strncat(tmptapename, ".tap", strlen(tmptapename)+5);
-              tmptapename[sizeof(tmptapename)-1] = 0;
+              if (strlen(oric->tmptapename)+5<sizeof(oric->tmptapename)) // if we have enough space to add the .tap
+                  strncat(oric->tmptapename, ".tap", strlen(oric->tmptapename)+5);
+              oric->tmptapename[sizeof(oric->tmptapename)-1] = 0;
             }
           }
 
-          odir = getcwd( NULL, 0 );
-          if( odir )
+          if( oric->tmptapename[0] )
           {
-            chdir( tapepath );
-            oric->tsavf = fopen(tmptapename, "wb");
-            chdir( odir );
-            free( odir );
+            joinpathto( fname, tapepath, oric->tmptapename );
+            oric->tsavf = fopen( fname, "wb" );
           }
         }
       }
@@ -1240,15 +1254,15 @@ void tape_patches( struct machine *oric )
         tape_stop_savepatch( oric );
         if( justtap )
         {
-          snprintf( filetmp, 32, "\x0f\x10 Saved to %s", tmptapename );
-          filetmp[31] = 0;
-          if (strlen(tmptapename) > 20)
+          char popup[32];
+          snprintf( popup, 32, "\x0f\x10 Saved to %.*s", 19, oric->tmptapename );
+          if (strlen(oric->tmptapename) > 20)
           {
-            filetmp[30] = '\x16';
+            popup[30] = '\x16';
           }
-          do_popup( oric, filetmp );
+          do_popup( oric, popup );
         }
-        tmptapename[0] = 0;
+        oric->tmptapename[0] = 0;
       }
     }
 
@@ -1321,6 +1335,7 @@ void tape_patches( struct machine *oric )
       {
         // No. Give up.
         oric->tapeturbo_forceoff = SDL_TRUE;
+        machine_sync( oric );
         return;
       }
 
@@ -1343,7 +1358,7 @@ void tape_patches( struct machine *oric )
           // Give up at end of image
           if( oric->tapeoffs >= oric->tapelen )
           {
-            refreshtape = SDL_TRUE;
+            oric->refreshtape = SDL_TRUE;
             return;
           }
         } while( oric->tapebuf[oric->tapeoffs] != 0x16 );
@@ -1371,11 +1386,47 @@ void tape_patches( struct machine *oric )
       // Jump to the end of the read byte routine
       oric->cpu.calcpc = oric->pch_tt_readbyte_end_pc;
       oric->cpu.calcop = oric->cpu.read( &oric->cpu, oric->cpu.calcpc );
-      if( oric->tapeoffs >= oric->tapelen ) refreshtape = SDL_TRUE;
+      if( oric->tapeoffs >= oric->tapelen ) oric->refreshtape = SDL_TRUE;
     }
   }
 }
 
+/*
+** Cycles until tape_ticktock next has something to do.
+** This follows the early outs in tape_ticktock.
+*/
+int tape_nextevent( struct machine *oric )
+{
+  int next = CLK_NOEVENT;
+
+  if( ( oric->vsynchack ) && ( oric->vsync > 0 ) )
+    next = oric->vsync;
+
+  if( ( !oric->tapebuf ) || ( !oric->tapemotor ) )
+    return next;
+
+  if( ( ( oric->tapeoffs < 0 ) || ( oric->tapeoffs >= oric->tapelen ) ) &&
+      ( oric->tapehitend > 2 ) && ( oric->lasttapefile[0] ) && ( oric->autoinsert ) )
+    return 1;
+
+  if( ( oric->pch_tt_available ) && ( oric->tapeturbo ) && ( !oric->tapeturbo_forceoff ) && ( oric->romon ) && ( !oric->rawtape ) )
+    return next;
+
+  if( oric->tapehitend > 2 )
+    return next;
+
+  if( ( oric->tapehdrend != 0 ) && ( oric->tapeoffs == oric->tapehdrend ) )
+    return 1;
+
+  if( oric->tapecount < next )
+    next = oric->tapecount;
+
+  if( ( oric->tapedelay > 0 ) && ( oric->tapedelay < next ) )
+    next = oric->tapedelay;
+
+  return ( next > 0 ) ? next : 1;
+}
+
 // Emulate the specified cpu-cycles time for the tape
 void tape_ticktock( struct machine *oric, int cycles )
 {
@@ -1453,6 +1504,7 @@ void tape_ticktock( struct machine *oric, int cycles )
 
   // Toggle the tape input
   oric->tapeout ^= 1;
+  oric->stats.count[STAT_TAPEEDGES]++;
   if( !oric->vsynchack )
   {
     // Update the audio if tape noise is enabled
@@ -1497,7 +1549,7 @@ void tape_ticktock( struct machine *oric, int cycles )
       case 1: oric->tapecount = 0x36*2; break;
     }
     oric->tapehitend++;
-    refreshtape = SDL_TRUE;
+    oric->refreshtape = SDL_TRUE;
     return;
   }
 
@@ -1509,7 +1561,7 @@ void tape_ticktock( struct machine *oric, int cycles )
     {
       tape_next_raw_count( oric );
       if( oric->tapehitend > 2 )
-        refreshtape = SDL_TRUE;
+        oric->refreshtape = SDL_TRUE;
       return;
     }
   }
@@ -31,7 +31,9 @@
 void tape_eject( struct machine *oric );
 void tape_rewind( struct machine *oric );
 SDL_bool tape_load_tap( struct machine *oric, char *fname );
+SDL_bool tape_load_buffer( struct machine *oric, Uint8 *buf, int len, char *name );
 void tape_ticktock( struct machine *oric, int cycles );
+int tape_nextevent( struct machine *oric );
 void tape_setmotor( struct machine *oric, SDL_bool motoron );
 void tape_patches( struct machine *oric );
 void toggletapecap( struct machine *oric, struct osdmenuitem *mitem, int dummy );
@@ -0,0 +1,296 @@
+/*
+**  Oricutron
+**  Copyright (C) 2009-2014 Peter Gordon
+**
+**  This program is free software; you can redistribute it and/or
+**  modify it under the terms of the GNU General Public License
+**  as published by the Free Software Foundation, version 2
+**  of the License.
+**
+**  This program is distributed in the hope that it will be useful,
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**  GNU General Public License for more details.
+**
+**  You should have received a copy of the GNU General Public License
+**  along with this program; if not, write to the Free Software
+**  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+**
+**  6502 instruction trace
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "system.h"
+#include "6502.h"
+#include "via.h"
+#include "8912.h"
+#include "gui.h"
+#include "disk.h"
+#include "monitor.h"
+#include "6551.h"
+#include "machine.h"
+
+#define TRACE_MINSIZE 1024
+#define TRACE_MAXSIZE (1<<26)
+
+// Streamed traces start with this, then the records follow as they are
+static char tracemagic[8] = { 'O', 'R', 'I', 'C', 'T', 'R', 'C', '1' };
+
+// Hook the trace back into the CPU after init_machine
+void trace_attach( struct machine *oric )
+{
+  oric->cpu.tracebuf  = oric->trace.buf;
+  oric->cpu.tracemask = oric->trace.size-1;
+}
+
+// Start tracing into a ring of at least size records
+SDL_bool trace_start( struct machine *oric, Uint32 size )
+{
+  struct tracer *t = &oric->trace;
+  Uint32 n;
+
+  if( size > TRACE_MAXSIZE ) size = TRACE_MAXSIZE;
+  for( n=TRACE_MINSIZE; n<size; n<<=1 ) ;
+
+  if( ( t->buf ) && ( t->size == n ) ) return SDL_TRUE;
+
+  trace_stop( oric );
+  t->buf = malloc( sizeof( struct m6502_tracerec ) * n );
+  if( !t->buf ) return SDL_FALSE;
+
+  t->size  = n;
+  t->start = oric->cpu.tracehead;
+  trace_attach( oric );
+  return SDL_TRUE;
+}
+
+void trace_stop( struct machine *oric )
+{
+  struct tracer *t = &oric->trace;
+
+  trace_endstream( oric );
+  if( t->buf ) free( t->buf );
+  t->buf  = NULL;
+  t->size = 0;
+  trace_attach( oric );
+}
+
+// Records still in the ring
+static Uint32 trace_held( struct machine *oric )
+{
+  Uint32 n = oric->cpu.tracehead - oric->trace.start;
+
+  return ( n < oric->trace.size ) ? n : oric->trace.size;
+}
+
+// The record from "back" instructions ago (1 = the last one)
+static struct m6502_tracerec *trace_rec( struct machine *oric, Uint32 back )
+{
+  return &oric->trace.buf[(oric->cpu.tracehead-back) & (oric->trace.size-1)];
+}
+
+static int trace_writer( void *data )
+{
+  struct tracer *t = (struct tracer *)data;
+  Uint32 from, to, i, n;
+
+  SDL_LockMutex( t->lock );
+  for( ;; )
+  {
+    while( ( t->written == t->published ) && ( !t->quit ) )
+      SDL_CondWait( t->more, t->lock );
+    if( t->written == t->published ) break;
+
+    from = t->written;
+    to   = t->published;
+    SDL_UnlockMutex( t->lock );
+
+    // Up to the end of the ring, then from the start
+    while( from != to )
+    {
+      i = from & (t->size-1);
+      n = to-from;
+      if( n > t->size-i ) n = t->size-i;
+      fwrite( &t->buf[i], sizeof( struct m6502_tracerec ), n, t->f );
+      from += n;
+    }
+
+    SDL_LockMutex( t->lock );
+    t->streamed += to - t->written;
+    t->written = to;
+    SDL_CondSignal( t->room );
+  }
+  SDL_UnlockMutex( t->lock );
+  return 0;
+}
+
+// Write every instruction from now on to a file
+SDL_bool trace_stream( struct machine *oric, char *fname )
+{
+  struct tracer *t = &oric->trace;
+  Uint32 hdr[2];
+
+  trace_endstream( oric );
+  if( !trace_start( oric, ( t->size > TRACE_MINSTREAM ) ? t->size : TRACE_MINSTREAM ) )
+    return SDL_FALSE;
+
+  t->f = fopen( fname, "wb" );
+  if( !t->f ) return SDL_FALSE;
+
+  hdr[0] = sizeof( struct m6502_tracerec );
+  hdr[1] = 0;
+  fwrite( tracemagic, sizeof( tracemagic ), 1, t->f );
+  fwrite( hdr, sizeof( hdr ), 1, t->f );
+
+  t->lock = SDL_CreateMutex();
+  t->more = SDL_CreateCond();
+  t->room = SDL_CreateCond();
+  t->published = t->written = oric->cpu.tracehead;
+  t->streamed = 0;
+  t->quit = SDL_FALSE;
+  t->thread = NULL;
+  if( ( t->lock ) && ( t->more ) && ( t->room ) )
+    t->thread = SDL_COMPAT_CreateThread( trace_writer, "trace", t );
+
+  if( !t->thread )
+  {
+    trace_endstream( oric );
+    return SDL_FALSE;
+  }
+
+  strncpy( t->fname, fname, sizeof( t->fname ) );
+  t->fname[sizeof( t->fname )-1] = 0;
+  return SDL_TRUE;
+}
+
+void trace_endstream( struct machine *oric )
+{
+  struct tracer *t = &oric->trace;
+
+  if( t->thread )
+  {
+    SDL_LockMutex( t->lock );
+    t->published = oric->cpu.tracehead;
+    t->quit = SDL_TRUE;
+    SDL_CondSignal( t->more );
+    SDL_UnlockMutex( t->lock );
+    SDL_WaitThread( t->thread, NULL );
+    t->thread = NULL;
+  }
+
+  if( t->room ) SDL_DestroyCond( t->room );
+  if( t->more ) SDL_DestroyCond( t->more );
+  if( t->lock ) SDL_DestroyMutex( t->lock );
+  t->room = t->more = NULL;
+  t->lock = NULL;
+
+  if( t->f ) fclose( t->f );
+  t->f = NULL;
+}
+
+/*
+** Called once a frame. Hands what has been traced since last time
+** to the writer, and holds the emulation up if the writer is more
+** than half a ring behind, so nothing is overwritten before it is
+** written. A frame is always much less than half a ring.
+*/
+void trace_sync( struct machine *oric )
+{
+  struct tracer *t = &oric->trace;
+
+  if( !t->thread ) return;
+
+  SDL_LockMutex( t->lock );
+  t->published = oric->cpu.tracehead;
+  SDL_CondSignal( t->more );
+  while( ( t->published - t->written ) > t->size/2 )
+    SDL_CondWait( t->room, t->lock );
+  SDL_UnlockMutex( t->lock );
+}
+
+void trace_show( struct machine *oric )
+{
+  struct tracer *t = &oric->trace;
+
+  if( !t->buf )
+  {
+    mon_str( "Trace off" );
+    return;
+  }
+
+  mon_printf( "Trace on, %u of %u held", trace_held( oric ), t->size );
+  if( t->thread )
+  {
+    trace_sync( oric );
+    mon_printf( "Streaming to '%.28s'", t->fname );
+    mon_printf( "%llu records written", (unsigned long long)t->streamed );
+  }
+}
+
+// The last count instructions, oldest first
+void trace_list( struct machine *oric, int count )
+{
+  Uint32 held, i;
+
+  if( !oric->trace.buf )
+  {
+    mon_str( "Trace off" );
+    return;
+  }
+
+  held = trace_held( oric );
+  if( (Uint32)count > held ) count = held;
+  if( !count )
+  {
+    mon_str( "Trace empty" );
+    return;
+  }
+
+  for( i=count; i>0; i-- )
+    mon_str( mon_traceprint( oric, trace_rec( oric, i ), SDL_TRUE ) );
+}
+
+// The last count times the CPU was at pc, with how many instructions ago
+void trace_search( struct machine *oric, Uint16 pc, int count )
+{
+  Uint32 held, i;
+  int found = 0;
+
+  if( !oric->trace.buf )
+  {
+    mon_str( "Trace off" );
+    return;
+  }
+
+  held = trace_held( oric );
+  for( i=1; ( i<=held ) && ( found<count ); i++ )
+  {
+    if( trace_rec( oric, i )->pc != pc ) continue;
+    mon_printf( "-%-8u %.38s", i, mon_traceprint( oric, trace_rec( oric, i ), SDL_TRUE ) );
+    found++;
+  }
+
+  if( !found )
+    mon_printf( "$%04X not in the last %u instructions", pc, held );
+}
+
+// Disassemble the whole ring to a text file, oldest first
+SDL_bool trace_dump( struct machine *oric, char *fname )
+{
+  Uint32 i;
+  FILE *f;
+
+  if( !oric->trace.buf ) return SDL_FALSE;
+
+  f = fopen( fname, "w" );
+  if( !f ) return SDL_FALSE;
+
+  for( i=trace_held( oric ); i>0; i-- )
+    fprintf( f, "%s\n", mon_traceprint( oric, trace_rec( oric, i ), SDL_FALSE ) );
+
+  fclose( f );
+  return SDL_TRUE;
+}
@@ -0,0 +1,57 @@
+/*
+**  Oricutron
+**  Copyright (C) 2009-2014 Peter Gordon
+**
+**  This program is free software; you can redistribute it and/or
+**  modify it under the terms of the GNU General Public License
+**  as published by the Free Software Foundation, version 2
+**  of the License.
+**
+**  This program is distributed in the hope that it will be useful,
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**  GNU General Public License for more details.
+**
+**  You should have received a copy of the GNU General Public License
+**  along with this program; if not, write to the Free Software
+**  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+**
+**  6502 instruction trace
+*/
+#ifndef TRACE_H
+#define TRACE_H
+
+#define TRACE_DEFSIZE   (1<<20)   // Records in the ring by default (16MB)
+#define TRACE_MINSTREAM (1<<20)   // Smallest ring to stream to a file from
+
+// The ring itself is hooked into the CPU (cpu.tracebuf etc.)
+struct tracer
+{
+  struct m6502_tracerec *buf;
+  Uint32      size;             // Records in buf, a power of two
+  Uint32      start;            // cpu.tracehead when it was started
+
+  // Streaming to a file. The emulator publishes how far it has got
+  // once a frame, and the writer thread writes up to there.
+  FILE       *f;
+  char        fname[4096];
+  SDL_Thread *thread;
+  SDL_mutex  *lock;
+  SDL_cond   *more, *room;
+  Uint32      published, written;
+  SDL_bool    quit;
+  Uint64      streamed;         // Records written to the file
+};
+
+void trace_attach( struct machine *oric );
+SDL_bool trace_start( struct machine *oric, Uint32 size );
+void trace_stop( struct machine *oric );
+SDL_bool trace_stream( struct machine *oric, char *fname );
+void trace_endstream( struct machine *oric );
+void trace_sync( struct machine *oric );
+void trace_show( struct machine *oric );
+void trace_list( struct machine *oric, int count );
+void trace_search( struct machine *oric, Uint16 pc, int count );
+SDL_bool trace_dump( struct machine *oric, char *fname );
+
+#endif
@@ -33,11 +33,13 @@
 #include "machine.h"
 #include "ula.h"
 #include "avi.h"
+#include "render_swline.h"
 
-extern struct avi_handle *vidcap;
-extern SDL_bool warpspeed;
 
-static unsigned char bittab[8*8*64*8];
+// Each 6 pixel pattern is padded to 8 bytes, so a whole
+// block goes out in one store
+static Uint64 bittab[8*8*64];
+static SDL_bool bittabready = SDL_FALSE;
 
 // Refresh the video base pointer
 static inline void ula_refresh_charset( struct machine *oric )
@@ -57,8 +59,8 @@ static inline void ula_decode_attr( struct machine *oric, int attr, int y )
   {
     case 0x00: // Foreground colour
       oric->vid_fg_col     = attr & 0x07;
-      oric->vid_bitptr     = (Uint16 *)(&bittab[(oric->vid_fg_col<<12) | (oric->vid_bg_col<<9)]);
-      oric->vid_inv_bitptr = (Uint16 *)(&bittab[((oric->vid_fg_col^7)<<12) | ((oric->vid_bg_col^7)<<9)]);
+      oric->vid_bitptr     = &bittab[(oric->vid_fg_col<<9) | (oric->vid_bg_col<<6)];
+      oric->vid_inv_bitptr = &bittab[((oric->vid_fg_col^7)<<9) | ((oric->vid_bg_col^7)<<6)];
       break;
 
     case 0x08: // Text attribute
@@ -73,8 +75,8 @@ static inline void ula_decode_attr( struct machine *oric, int attr, int y )
 
     case 0x10: // Background colour
       oric->vid_bg_col = attr & 0x07;
-      oric->vid_bitptr     = (Uint16 *)(&bittab[(oric->vid_fg_col<<12) | (oric->vid_bg_col<<9)]);
-      oric->vid_inv_bitptr = (Uint16 *)(&bittab[((oric->vid_fg_col^7)<<12) | ((oric->vid_bg_col^7)<<9)]);
+      oric->vid_bitptr     = &bittab[(oric->vid_fg_col<<9) | (oric->vid_bg_col<<6)];
+      oric->vid_inv_bitptr = &bittab[((oric->vid_fg_col^7)<<9) | ((oric->vid_bg_col^7)<<6)];
       break;
 
     case 0x18: // Video mode
@@ -101,197 +103,210 @@ static inline void ula_raster_default( struct machine *oric )
   oric->vid_textattrs  = 0;
   oric->vid_blinkmask  = 0x3f;
   oric->vid_bg_col     = 0;
-  oric->vid_bitptr     = (Uint16 *)(&bittab[(oric->vid_fg_col<<12) | (oric->vid_bg_col<<9)]);
-  oric->vid_inv_bitptr = (Uint16 *)(&bittab[((oric->vid_fg_col^7)<<12) | ((oric->vid_bg_col^7)<<9)]);
+  oric->vid_bitptr     = &bittab[(oric->vid_fg_col<<9) | (oric->vid_bg_col<<6)];
+  oric->vid_inv_bitptr = &bittab[((oric->vid_fg_col^7)<<9) | ((oric->vid_bg_col^7)<<6)];
   ula_refresh_charset( oric );
 }
 
 void ula_powerup_default( struct machine *oric )
 {
   ula_decode_attr( oric, 0x1a, 0 );
+  ula_set_redraw( oric );
 }
 
-// Render a 6x1 block
-static void ula_render_block( struct machine *oric, SDL_bool inverted, int data, int y )
+/*
+** Draw scanline y into out, which has to have room for 2 bytes
+** past the 240 pixels, since each block is written as 8 bytes.
+** Returns SDL_TRUE if the line has blinking attributes.
+*/
+static SDL_bool ula_drawline( struct machine *oric, int y, Uint8 *out )
 {
-  Uint16 *ptr;
-
-  if( inverted )
-  {
-    ptr = oric->vid_inv_bitptr + (data<<2);
-  }
-  else
-  {
-    ptr = oric->vid_bitptr + (data<<2);
-  }
-
-  *((Uint16 *)oric->scrpt) = *(ptr++); oric->scrpt+=2;
-  *((Uint16 *)oric->scrpt) = *(ptr++); oric->scrpt+=2;
-  *((Uint16 *)oric->scrpt) = *(ptr++); oric->scrpt+=2;
-}
+  int b, c, cy, bitmask;
+  SDL_bool hires, blink = SDL_FALSE;
+  Uint64 *pat;
+  Uint8 *rptr;
 
-static void ula_render_block_checkdirty( struct machine *oric, SDL_bool inverted, int data, int y )
-{
-  Uint16 *ptr;
-  int i;
+  cy = (y>>3) * 40;
 
-  if( inverted )
-  {
-    ptr = oric->vid_inv_bitptr + (data<<2);
-  }
-  else
-  {
-    ptr = oric->vid_bitptr + (data<<2);
-  }
+  // Always start each scanline with white on black
+  ula_raster_default( oric );
+  oric->vid_chline = y & 0x07;
 
-  for( i=0; i<3; i++)
+  if( y < 200 )
   {
-    if (*((Uint16 *)oric->scrpt) != *ptr)
+    if( oric->vid_mode & 0x04 ) // HIRES?
     {
-      *((Uint16 *)oric->scrpt) = *ptr;
-      oric->vid_dirty[y] = SDL_TRUE;
-      oric->vid_block_func = ula_render_block;
+      hires = SDL_TRUE;
+      rptr = &oric->mem[oric->vid_addr + y*40 -1];
+    } else {
+      hires = SDL_FALSE;
+      rptr = &oric->mem[oric->vid_addr + cy -1];
     }
-    oric->scrpt+=2;
-    ptr++;
-  }
-}
+  } else {
+    hires = SDL_FALSE;
 
-// Render current screen (used by the monitor)
-void ula_renderscreen( struct machine *oric )
-{
-  Uint8 *scrpt, *rptr;
-  int b, y, c, cy, bitmask;
-  SDL_bool hires;
+    rptr = &oric->mem[oric->vidbases[2] + cy -1];  // bb80 = bf68 - (200/8*40)
+  }
+  bitmask = (oric->frames&0x10)?0x3f:oric->vid_blinkmask;
 
-  scrpt = oric->scrpt;
-  oric->scrpt = oric->scr;
-  for( y=0; y<224; y++)
+  for( b=0; b<40; b++, out+=6 )
   {
-    cy = (y>>3) * 40;
-
-    // Always start each scanline with white on black
-    ula_raster_default( oric );
-    oric->vid_chline = y & 0x07;
-
-    if( y < 200 )
-    {
-      if( oric->vid_mode & 0x04 ) // HIRES?
-      {
-        hires = SDL_TRUE;
-        rptr = &oric->mem[oric->vid_addr + y*40 -1];
-      } else {
-        hires = SDL_FALSE;
-        rptr = &oric->mem[oric->vid_addr + cy -1];
-      }
-    } else {
-      hires = SDL_FALSE;
+    c = *(++rptr);
 
-      rptr = &oric->mem[oric->vidbases[2] + cy -1];  // bb80 = bf68 - (200/8*40)
-    }
-    bitmask = (oric->frames&0x10)?0x3f:oric->vid_blinkmask;
-    
-    for( b=0; b<40; b++ )
+    /* if bits 6 and 5 are zero, the byte contains a serial attribute */
+    if( ( c & 0x60 ) == 0 )
     {
-      c = *(++rptr);
-
-      /* if bits 6 and 5 are zero, the byte contains a serial attribute */
-      if( ( c & 0x60 ) == 0 )
+      if( ( c & 0x1c ) == 0x0c ) blink = SDL_TRUE;
+      ula_decode_attr( oric, c, y );
+      pat = (c & 0x80) ? oric->vid_inv_bitptr : oric->vid_bitptr;
+      memcpy( out, pat, 8 );
+      if( y < 200 )
       {
-        ula_decode_attr( oric, c, y );
-        ula_render_block( oric, (c & 0x80)!=0, 0, y );
-        if( y < 200 )
+        if( oric->vid_mode & 0x04 ) // HIRES?
         {
-          if( oric->vid_mode & 0x04 ) // HIRES?
-          {
-            hires = SDL_TRUE;
-            rptr = &oric->mem[oric->vid_addr + b + y*40];
-          } else {
-            hires = SDL_FALSE;
-            rptr = &oric->mem[oric->vid_addr + b + cy];
-          }
+          hires = SDL_TRUE;
+          rptr = &oric->mem[oric->vid_addr + b + y*40];
         } else {
           hires = SDL_FALSE;
-
-          rptr = &oric->mem[oric->vidbases[2] + b + cy];   // bb80 = bf68 - (200/8*40)
+          rptr = &oric->mem[oric->vid_addr + b + cy];
         }
-        bitmask = (oric->frames&0x10)?0x3f:oric->vid_blinkmask;
-    
       } else {
-        if( hires )
+        if (hires)
         {
-          ula_render_block( oric, (c & 0x80)!=0, c & bitmask, y );
-        } else {
-          int ch_ix, ch_dat;
-          
-          ch_ix   = c & 0x7f;          
-          ch_dat = oric->vid_ch_data[ (ch_ix<<3) | oric->vid_chline ] & bitmask;
-        
-          ula_render_block( oric, (c & 0x80)!=0, ch_dat, y );
+          hires = SDL_FALSE;
+          rptr = &oric->mem[oric->vidbases[2] + b + cy];   // bb80 = bf68 - (200/8*40)
         }
       }
+      bitmask = (oric->frames&0x10)?0x3f:oric->vid_blinkmask;
+    } else {
+      pat = (c & 0x80) ? oric->vid_inv_bitptr : oric->vid_bitptr;
+      if( hires )
+      {
+        memcpy( out, &pat[c & bitmask], 8 );
+      } else {
+        int ch_ix, ch_dat;
+
+        ch_ix   = c & 0x7f;
+        ch_dat = oric->vid_ch_data[ (ch_ix<<3) | oric->vid_chline ] & bitmask;
+
+        memcpy( out, &pat[ch_dat], 8 );
+      }
     }
   }
-  oric->scrpt = scrpt;
+
+  return blink;
+}
+
+// Render current screen (used by the monitor)
+void ula_renderscreen( struct machine *oric )
+{
+  Uint8 line[240+8];
+  int y;
+
+  for( y=0; y<224; y++)
+  {
+    ula_drawline( oric, y, line );
+    memcpy( &oric->scr[y*240], line, 240 );
+  }
+
+  // The lines might not match what ula_doraster would have drawn
+  ula_set_redraw( oric );
 }
 
-// Draw one rasterline
+// Draw a changed line straight into the renderer's surface, doubled
+// the same way render_video_sw_32bpp would
+static void ula_hostline( struct machine *oric, int y, Uint8 *line )
+{
+  Uint8 *even, *odd;
+
+  even = oric->vid_host + y * 2 * oric->vid_hostpitch;
+  odd  = even + oric->vid_hostpitch;
+
+  swline_expand32x2( (Uint32 *)even, line, &oric->vid_hostpal[0], 240 );
+  if( oric->scanlines )
+    swline_expand32x2( (Uint32 *)odd, line, &oric->vid_hostpal[1], 240 );
+  else
+    memcpy( odd, even, 480*4 );
+}
+
+/*
+** Draw one rasterline. A line is only drawn if something it shows
+** has changed since it was last drawn: memory (see ula_memwrite),
+** the video mode at the start of the line, or the blink phase if
+** it has blinking attributes. Otherwise it is left as it is in
+** oric->scr, and the video mode set to what it was at the end.
+*/
 SDL_bool ula_doraster( struct machine *oric )
 {
-  int b, c, bitmask;
-  SDL_bool hires, needrender;
-  unsigned int y, cy;
-  Uint8 *rptr;
+  Uint8 line[240+8], *scrpt;
+  SDL_bool needrender;
+  unsigned int y;
+  Uint64 t;
+  int i;
+
+  t = stats_start( &oric->stats );
 
   needrender = SDL_FALSE;
 
   oric->vid_raster++;
   if( oric->vid_raster == oric->vid_maxrast )
   {
-    if( vidcap )
+    if( oric->vidcap )
     {
       // If we're recording with sound, and they do warp speed,
       // stop writing frames to the AVI, since it'll just get out of sync.
-      if ( ( !vidcap->dosnd ) || ( !warpspeed ) )
+      if ( ( !oric->vidcap->dosnd ) || ( !oric->warpspeed ) )
       {
         // If the oric refresh rate and AVI refresh rate match, just output every frame
-        if( vidcap->is50hz == oric->vid_freq )
+        if( oric->vidcap->is50hz == oric->vid_freq )
         {
           ay_lockaudio( &oric->ay ); // Gets unlocked at the end of each frame
-          avi_addframe( &vidcap, oric->scr );
+          avi_addframe( &oric->vidcap, oric->scr );
         }
         // Check for 60hz oric & 50 hz AVI
-        else if( vidcap->is50hz )
+        else if( oric->vidcap->is50hz )
         {
           // In this case we need to throw away every sixth frame
-          if( (vidcap->frameadjust%6) != 5 )
+          if( (oric->vidcap->frameadjust%6) != 5 )
           {
             ay_lockaudio( &oric->ay ); // Gets unlocked at the end of each frame
-            avi_addframe( &vidcap, oric->scr );
+            avi_addframe( &oric->vidcap, oric->scr );
           }
 
-          vidcap->frameadjust++;
+          oric->vidcap->frameadjust++;
         }
         // Must be 50hz oric & 60 hz AVI
         else
         {
           // In this case we need to duplicate every fifth frame
           ay_lockaudio( &oric->ay ); // Gets unlocked at the end of each frame
-          avi_addframe( &vidcap, oric->scr );
+          avi_addframe( &oric->vidcap, oric->scr );
 
-          if( (vidcap->frameadjust%5) == 4 )
-            avi_addframe( &vidcap, oric->scr );
+          if( (oric->vidcap->frameadjust%5) == 4 )
+            avi_addframe( &oric->vidcap, oric->scr );
 
-          vidcap->frameadjust++;
+          oric->vidcap->frameadjust++;
         }
       }
     }
 
     oric->vid_raster = 0;
+    machine_sync( oric );   // vsync is counted down by the tape emulation
     oric->vsync      = oric->cyclesperraster / 2;
+    machine_sync( oric );
     needrender = SDL_TRUE;
     oric->frames++;
 
+    // The blink phase flips every 16 frames
+    if( !( oric->frames & 0x0f ) )
+    {
+      for( i=0; i<224; i++ )
+      {
+        if( oric->vid_lineblink[i] )
+          oric->vid_linemode[i] = 0xff;
+      }
+    }
+
     if( oric->vid_freq != (oric->vid_mode&2) )
     {
       oric->vid_freq = oric->vid_mode&2;
@@ -323,79 +338,39 @@ SDL_bool ula_doraster( struct machine *oric )
 
   // Are we on a visible rasterline?
   if( ( oric->vid_raster < oric->vid_start ) ||
-      ( oric->vid_raster >= oric->vid_end ) ) return needrender;
+      ( oric->vid_raster >= oric->vid_end ) )
+  {
+    stats_stop( &oric->stats, STIME_ULA, t );
+    return needrender;
+  }
 
   y = oric->vid_raster - oric->vid_start;
-  oric->scrpt = &oric->scr[y*240];
-  
-  cy = (y>>3) * 40;
-
-  // Always start each scanline with white on black
-  ula_raster_default( oric );
-  oric->vid_chline = y & 0x07;
-
-  // warpspeed does frameskipping, so lines may still be dirty
-  oric->vid_block_func = oric->vid_dirty[y] ? ula_render_block : ula_render_block_checkdirty;
 
-  if( y < 200 )
+  if( oric->vid_linemode[y] == oric->vid_mode )
   {
-    if( oric->vid_mode & 0x04 ) // HIRES?
-    {
-      hires = SDL_TRUE;
-      rptr = &oric->mem[oric->vid_addr + y*40 -1];
-    } else {
-      hires = SDL_FALSE;
-      rptr = &oric->mem[oric->vid_addr + cy -1];
-    }
-  } else {
-    hires = SDL_FALSE;
-
-    rptr = &oric->mem[oric->vidbases[2] + cy -1];  // bb80 = bf68 - (200/8*40)
+    if( oric->vid_lineend[y] != oric->vid_mode )
+      ula_decode_attr( oric, 0x18 | oric->vid_lineend[y], y );
+    stats_stop( &oric->stats, STIME_ULA, t );
+    return needrender;
   }
-  bitmask = (oric->frames&0x10)?0x3f:oric->vid_blinkmask;
-    
-  for( b=0; b<40; b++ )
+  oric->vid_linemode[y] = oric->vid_mode;
+  oric->vid_lineblink[y] = ula_drawline( oric, y, line );
+
+  // oric->warpspeed does frameskipping, so lines may still be dirty.
+  // Lines the renderer doesn't have to draw go straight to its
+  // surface if it can take them, and oric->scr is kept for the AVI.
+  scrpt = &oric->scr[y*240];
+  if( ( oric->vid_dirty[y] ) || ( memcmp( scrpt, line, 240 ) != 0 ) )
   {
-    c = *(++rptr);
-
-    /* if bits 6 and 5 are zero, the byte contains a serial attribute */
-    if( ( c & 0x60 ) == 0 )
-    {
-      ula_decode_attr( oric, c, y );
-      oric->vid_block_func( oric, (c & 0x80)!=0, 0, y );
-      if( y < 200 )
-      {
-        if( oric->vid_mode & 0x04 ) // HIRES?
-        {
-          hires = SDL_TRUE;
-          rptr = &oric->mem[oric->vid_addr + b + y*40];
-        } else {
-          hires = SDL_FALSE;
-          rptr = &oric->mem[oric->vid_addr + b + cy];
-        }
-      } else {
-        if (hires)
-        {
-          hires = SDL_FALSE;
-          rptr = &oric->mem[oric->vidbases[2] + b + cy];   // bb80 = bf68 - (200/8*40)
-        }
-      }
-      bitmask = (oric->frames&0x10)?0x3f:oric->vid_blinkmask;
-    } else {
-      if( hires )
-      {
-        oric->vid_block_func( oric, (c & 0x80)!=0, c & bitmask, y );
-      } else {
-        int ch_ix, ch_dat;
-          
-        ch_ix   = c & 0x7f;          
-        ch_dat = oric->vid_ch_data[ (ch_ix<<3) | oric->vid_chline ] & bitmask;
-        
-        oric->vid_block_func( oric, (c & 0x80)!=0, ch_dat, y );
-      }
-    }
+    memcpy( scrpt, line, 240 );
+    if( ( oric->vid_host ) && ( !oric->vid_dirty[y] ) )
+      ula_hostline( oric, y, line );
+    else
+      oric->vid_dirty[y] = SDL_TRUE;
   }
+  oric->vid_lineend[y] = oric->vid_mode;
 
+  stats_stop( &oric->stats, STIME_ULA, t );
   return needrender;
 }
 
@@ -409,9 +384,56 @@ void ula_set_dirty( struct machine *oric )
   }
 }
 
+// Draw every line again, for when the memory or the screen
+// changed without the ULA seeing it
+void ula_set_redraw( struct machine *oric )
+{
+  memset( oric->vid_linemode, 0xff, sizeof( oric->vid_linemode ) );
+}
+
+// Video memory, as offsets into oric->mem
+static SDL_bool ula_inarea( Uint32 offs, Uint32 len, Uint32 base, Uint32 size )
+{
+  return ( offs < base+size ) && ( base < offs+len );
+}
+
+// Does the ULA show any of len bytes from offs in oric->mem in any mode?
+SDL_bool ula_showsmem( struct machine *oric, Uint32 offs, Uint32 len )
+{
+  return ula_inarea( offs, len, oric->vidbases[0], 200*40 ) ||   // HIRES
+         ula_inarea( offs, len, oric->vidbases[1], 256*8 )  ||   // HIRES charset
+         ula_inarea( offs, len, oric->vidbases[2], 28*40 )  ||   // Text
+         ula_inarea( offs, len, oric->vidbases[3], 256*8 );      // Text charset
+}
+
+// The byte at offs in oric->mem changed, so draw the lines that show it again
+void ula_memwrite( struct machine *oric, Uint32 offs )
+{
+  Uint32 d;
+  int y;
+
+  d = offs - oric->vidbases[0];
+  if( d < 200*40 )
+    oric->vid_linemode[d/40] = 0xff;
+
+  d = offs - oric->vidbases[2];
+  if( d < 28*40 )
+    memset( &oric->vid_linemode[(d/40)*8], 0xff, 8 );
+
+  if( ( offs - oric->vidbases[1] < 256*8 ) || ( offs - oric->vidbases[3] < 256*8 ) )
+  {
+    // Every line that shows this row of the characters, normal or double height
+    for( y=offs&7; y<224; y+=8 )
+      oric->vid_linemode[y] = 0xff;
+    for( y=(offs&7)*2; y<224; y+=16 )
+      oric->vid_linemode[y] = oric->vid_linemode[y+1] = 0xff;
+  }
+}
+
 void preinit_ula( struct machine *oric )
 {
   oric->scr = NULL;
+  oric->vid_host = NULL;
   oric->hstretch = SDL_TRUE;
   oric->scanlines = SDL_FALSE;
   oric->palghost = SDL_TRUE;
@@ -419,29 +441,37 @@ void preinit_ula( struct machine *oric )
 
 SDL_bool init_ula( struct machine *oric )
 {
-  int fg, bg, bits, offs, mask;
+  int fg, bg, bits, mask;
+  Uint8 *pix;
 
   oric->scr = (Uint8 *)malloc( 240*224 );
   if( !oric->scr ) return SDL_FALSE;
 
   memset(oric->scr, 0, 240*224);
   ula_set_dirty( oric );
+  ula_set_redraw( oric );
 
-  /* Precalc all 6 bit combinations for all colour combinations */
-  for( fg=0; fg<8; fg++ )
+  /* Precalc all 6 bit combinations for all colour combinations.
+     The table is shared by every machine and never changes afterwards. */
+  if( !bittabready )
   {
-    for( bg=0; bg<8; bg++ )
+    for( fg=0; fg<8; fg++ )
     {
-      for( bits=0; bits<64; bits++)
+      for( bg=0; bg<8; bg++ )
       {
-        // FFFBBBbbbbbb000
-        offs = (fg<<12)|(bg<<9)|(bits<<3);
-        for( mask=0x20; mask; mask>>=1 )
+        for( bits=0; bits<64; bits++)
         {
-          bittab[offs++] = (bits&mask) ? fg : bg;
+          // FFFBBBbbbbbb
+          pix = (Uint8 *)&bittab[(fg<<9)|(bg<<6)|bits];
+          for( mask=0x20; mask; mask>>=1 )
+          {
+            *(pix++) = (bits&mask) ? fg : bg;
+          }
+          pix[0] = pix[1] = 0;
         }
       }
     }
+    bittabready = SDL_TRUE;
   }
 
   return SDL_TRUE;
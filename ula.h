@@ -26,3 +26,6 @@ SDL_bool ula_doraster( struct machine *oric );
 void ula_powerup_default( struct machine *oric );
 void ula_renderscreen( struct machine *oric );
 void ula_set_dirty( struct machine *oric );
+void ula_set_redraw( struct machine *oric );
+SDL_bool ula_showsmem( struct machine *oric, Uint32 offs, Uint32 len );
+void ula_memwrite( struct machine *oric, Uint32 offs );
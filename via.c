@@ -243,6 +243,7 @@ void via_tele_w_iora( struct via *v )
   v->oric->tele_currbank = (v->oric->tele_currbank&invddra)|(v->ora&v->ddra&0x07);
   v->oric->tele_banktype = v->oric->tele_bank[v->oric->tele_currbank].type;
   v->oric->rom           = v->oric->tele_bank[v->oric->tele_currbank].ptr;
+  setmemmap( v->oric );
 }
 
 void via_tele_w_iora2( struct via *v )
@@ -251,6 +252,7 @@ void via_tele_w_iora2( struct via *v )
   v->oric->tele_currbank = (v->oric->tele_currbank&invddra)|(v->ora&v->ddra&0x07);
   v->oric->tele_banktype = v->oric->tele_bank[v->oric->tele_currbank].type;
   v->oric->rom           = v->oric->tele_bank[v->oric->tele_currbank].ptr;
+  setmemmap( v->oric );
 }
 
 void via_tele_w_ddra( struct via *v )
@@ -259,6 +261,7 @@ void via_tele_w_ddra( struct via *v )
   v->oric->tele_currbank = (v->oric->tele_currbank&invddra)|(v->ora&v->ddra&0x07);
   v->oric->tele_banktype = v->oric->tele_bank[v->oric->tele_currbank].type;
   v->oric->rom           = v->oric->tele_bank[v->oric->tele_currbank].ptr;
+  setmemmap( v->oric );
 }
 
 // Read ports from external device
@@ -409,11 +412,67 @@ void via_init( struct via *v, struct machine *oric, int viatype )
   }
 }
 
+/*
+** Cycles until via_clock next has something to do.
+** The tape and printer are not included, they belong
+** to the machine.
+*/
+int via_nextevent( struct via *v )
+{
+  int next = CLK_NOEVENT;
+
+  // Pulses end on the next clock
+  if( ( v->ca2pulse ) || ( v->cb2pulse ) )
+    return 1;
+
+  switch( v->acr&ACRF_T1CON )
+  {
+    case 0x00:
+    case 0x80:
+      if( v->t1run ) next = v->t1c+1;
+      break;
+
+    default:
+      if( v->t1reload ) return 1;
+      next = v->t1c+1;
+      break;
+  }
+
+  if( ( ( v->acr & ACRF_T2CON ) == 0 ) && ( v->t2run ) )
+  {
+    if( v->t2reload ) return 1;
+    if( v->t2c+1 < next ) next = v->t2c+1;
+  }
+
+  switch( v->acr & ACRF_SRCON )
+  {
+    case 0x10:
+      if( ( v->srtrigger ) && ( v->srtime < next ) )
+        next = ( v->srtime > 0 ) ? v->srtime : 1;
+      break;
+
+    case 0x14:
+      if( ( v->srtrigger ) && ( v->srcount != 8 ) && ( v->srtime < next ) )
+        next = ( v->srtime > 0 ) ? v->srtime : 1;
+      break;
+
+    default:
+      // Shift register state gets cleared on the next clock
+      if( ( v->ifr&VIRQF_SR ) || ( v->srcount ) || ( v->srtrigger ) )
+        return 1;
+      break;
+  }
+
+  return next;
+}
+
 // Move timers on etc.
 void via_clock( struct via *v, unsigned int cycles )
 {
   unsigned int crem;
 
+  v->oric->stats.count[STAT_VIACLOCKS]++;
+
   // Move on the tape emulation
   tape_ticktock( v->oric, cycles );
 
@@ -138,6 +138,7 @@ void via_init( struct via *v, struct machine *oric, int viatype );
 
 // Move timers on etc.
 void via_clock( struct via *v, unsigned int cycles );
+int via_nextevent( struct via *v );
 
 // Write VIA from CPU
 void via_write( struct via *v, int offset, unsigned char data );